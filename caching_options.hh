@@ -20,6 +20,7 @@
  */
 
 #pragma once
+#include <chrono>
 #include <seastar/core/sstring.hh>
 #include <boost/lexical_cast.hpp>
 #include "exceptions/exceptions.hh"
@@ -40,8 +41,11 @@ class caching_options {
     sstring _key_cache;
     sstring _row_cache;
     bool _enabled = true;
-    caching_options(sstring k, sstring r, bool enabled)
-        : _key_cache(k), _row_cache(r), _enabled(enabled)
+    // How long coordinators may serve results of prepared queries from their
+    // result cache. Zero, the default, disables caching results of the table.
+    std::chrono::milliseconds _results_ttl{0};
+    caching_options(sstring k, sstring r, bool enabled, std::chrono::milliseconds results_ttl = std::chrono::milliseconds(0))
+        : _key_cache(k), _row_cache(r), _enabled(enabled), _results_ttl(results_ttl)
     {
         if ((k != "ALL") && (k != "NONE")) {
             throw exceptions::configuration_exception("Invalid key value: " + k); 
@@ -66,12 +70,19 @@ class caching_options {
         return _enabled;
     }
 
+    std::chrono::milliseconds results_ttl() const {
+        return _results_ttl;
+    }
+
     std::map<sstring, sstring> to_map() const {
         std::map<sstring, sstring> res = {{ "keys", _key_cache },
                 { "rows_per_partition", _row_cache }};
         if (!_enabled) {
             res.insert({"enabled", "false"});
         }
+        if (_results_ttl.count()) {
+            res.insert({"results_ttl_in_ms", std::to_string(_results_ttl.count())});
+        }
         return res;
     }
 
@@ -88,6 +99,7 @@ class caching_options {
         sstring k = default_key;
         sstring r = default_row;
         bool e = true;
+        std::chrono::milliseconds results_ttl(0);
 
         for (auto& p : map) {
             if (p.first == "keys") {
@@ -96,11 +108,17 @@ class caching_options {
                 r = p.second;
             } else if (p.first == "enabled") {
                 e = p.second == "true";
+            } else if (p.first == "results_ttl_in_ms") {
+                try {
+                    results_ttl = std::chrono::milliseconds(boost::lexical_cast<uint32_t>(p.second));
+                } catch (boost::bad_lexical_cast&) {
+                    throw exceptions::configuration_exception("Invalid results_ttl_in_ms value: " + p.second);
+                }
             } else {
                 throw exceptions::configuration_exception(format("Invalid caching option: {}", p.first));
             }
         }
-        return caching_options(k, r, e);
+        return caching_options(k, r, e, results_ttl);
     }
 
     static caching_options from_sstring(const sstring& str) {
@@ -109,7 +127,7 @@ class caching_options {
 
     bool operator==(const caching_options& other) const {
         return _key_cache == other._key_cache && _row_cache == other._row_cache
-            && _enabled == other._enabled;
+            && _enabled == other._enabled && _results_ttl == other._results_ttl;
     }
     bool operator!=(const caching_options& other) const {
         return !(*this == other);
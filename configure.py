@@ -310,6 +310,7 @@ scylla_tests = set([
     'test/boost/database_test',
     'test/boost/duration_test',
     'test/boost/dynamic_bitset_test',
+    'test/boost/endpoint_latency_tracker_test',
     'test/boost/enum_option_test',
     'test/boost/enum_set_test',
     'test/boost/extensions_test',
@@ -353,6 +354,7 @@ scylla_tests = set([
     'test/boost/nonwrapping_range_test',
     'test/boost/observable_test',
     'test/boost/partitioner_test',
+    'test/boost/paxos_state_cache_test',
     'test/boost/querier_cache_test',
     'test/boost/query_processor_test',
     'test/boost/range_test',
@@ -430,6 +432,7 @@ perf_tests = set([
     'test/perf/perf_idl',
     'test/perf/perf_vint',
     'test/perf/perf_big_decimal',
+    'test/perf/perf_utf8',
 ])
 
 apps = set([
@@ -665,6 +668,7 @@ scylla_core = (['database.cc',
                 'cql3/column_specification.cc',
                 'cql3/constants.cc',
                 'cql3/query_processor.cc',
+                'cql3/result_cache.cc',
                 'cql3/query_options.cc',
                 'cql3/single_column_relation.cc',
                 'cql3/token_relation.cc',
@@ -1041,6 +1045,7 @@ deps['test/boost/murmur_hash_test'] = ['bytes.cc', 'utils/murmur_hash.cc', 'test
 deps['test/boost/allocation_strategy_test'] = ['test/boost/allocation_strategy_test.cc', 'utils/logalloc.cc', 'utils/dynamic_bitset.cc']
 deps['test/boost/log_heap_test'] = ['test/boost/log_heap_test.cc']
 deps['test/boost/estimated_histogram_test'] = ['test/boost/estimated_histogram_test.cc']
+deps['test/boost/endpoint_latency_tracker_test'] = ['test/boost/endpoint_latency_tracker_test.cc']
 deps['test/boost/anchorless_list_test'] = ['test/boost/anchorless_list_test.cc']
 deps['test/perf/perf_fast_forward'] += ['release.cc']
 deps['test/perf/perf_simple_query'] += ['release.cc']
@@ -1050,7 +1055,7 @@ deps['test/boost/reusable_buffer_test'] = [
     "test/boost/reusable_buffer_test.cc",
     "test/lib/log.cc",
 ]
-deps['test/boost/utf8_test'] = ['utils/utf8.cc', 'test/boost/utf8_test.cc']
+deps['test/boost/utf8_test'] = ['utils/utf8.cc', 'utils/ascii.cc', 'test/boost/utf8_test.cc']
 deps['test/boost/small_vector_test'] = ['test/boost/small_vector_test.cc']
 deps['test/boost/multishard_mutation_query_test'] += ['test/boost/test_table.cc']
 deps['test/boost/vint_serialization_test'] = ['test/boost/vint_serialization_test.cc', 'vint-serialization.cc', 'bytes.cc']
@@ -402,8 +402,14 @@ bool like(const column_value& cv, const bytes_opt& pattern, const column_value_e
                 format("LIKE is allowed only on string types, which {} is not", cv.col->name_as_text()));
     }
     auto value = get_value(cv, bag);
-    // TODO: reuse matchers.
-    return (pattern && value) ? like_matcher(*pattern)(*value) : false;
+    if (!pattern || !value) {
+        return false;
+    }
+    // Filtering evaluates the same pattern for many rows in a row, so keep the
+    // last compiled one around; reset() is a no-op while the pattern stays the same.
+    static thread_local like_matcher matcher{bytes_view()};
+    matcher.reset(*pattern);
+    return matcher(*value);
 }
 
 /// True iff the column value is in the set defined by rhs.
@@ -661,6 +667,41 @@ std::vector<bytes_opt> first_multicolumn_bound(
     }
 }
 
+std::optional<nonwrapping_range<bytes>> like_prefix_range(
+        const column_definition* cdef, const expression& expr, const query_options& options) {
+    const auto oper = std::get_if<binary_operator>(&expr);
+    if (!oper || oper->op != oper_t::LIKE) {
+        return std::nullopt;
+    }
+    const auto col = std::get_if<column_value>(&oper->lhs);
+    if (!col || col->col != cdef || col->sub) {
+        return std::nullopt;
+    }
+    // Values sharing a prefix form a contiguous range only when they are ordered by their bytes.
+    const auto kind = cdef->type->underlying_type()->get_kind();
+    if (kind != abstract_type::kind::utf8 && kind != abstract_type::kind::ascii) {
+        return std::nullopt;
+    }
+    const auto pattern = to_bytes_opt(oper->rhs->bind_and_get(options));
+    if (!pattern) {
+        return std::nullopt;
+    }
+    auto prefix = like_matcher::literal_prefix(*pattern);
+    if (prefix.empty()) {
+        return std::nullopt;
+    }
+    // The smallest value greater than all the values starting with prefix.
+    auto end = prefix;
+    while (!end.empty() && uint8_t(end[end.size() - 1]) == 0xFF) {
+        end.resize(end.size() - 1);
+    }
+    if (end.empty()) {
+        return nonwrapping_range<bytes>::make_starting_with(range_bound(std::move(prefix), inclusive));
+    }
+    end[end.size() - 1] = int8_t(uint8_t(end[end.size() - 1]) + 1);
+    return nonwrapping_range<bytes>(range_bound(std::move(prefix), inclusive), range_bound(std::move(end), exclusive));
+}
+
 value_set possible_lhs_values(const column_definition* cdef, const expression& expr, const query_options& options) {
     const auto type = cdef ? get_value_comparator(cdef) : long_type.get();
     return std::visit(overloaded_functor{
@@ -786,6 +827,27 @@ bool uses_function(const expression& expr, const sstring& ks_name, const sstring
         }, expr);
 }
 
+bool is_pure(const expression& expr) {
+    return std::visit(overloaded_functor{
+            [&] (const conjunction& conj) {
+                return boost::algorithm::all_of(conj.children, is_pure);
+            },
+            [&] (const binary_operator& oper) {
+                if (oper.rhs && !oper.rhs->is_pure()) {
+                    return false;
+                } else if (auto columns = std::get_if<std::vector<column_value>>(&oper.lhs)) {
+                    return boost::algorithm::all_of(*columns, [&] (const column_value& cv) {
+                        return !cv.sub || cv.sub->is_pure();
+                    });
+                } else if (auto column = std::get_if<column_value>(&oper.lhs)) {
+                    return !column->sub || column->sub->is_pure();
+                }
+                return true;
+            },
+            [&] (const auto& default_case) { return true; },
+        }, expr);
+}
+
 bool is_supported_by(const expression& expr, const secondary_index::index& idx) {
     using std::placeholders::_1;
     return std::visit(overloaded_functor{
@@ -128,12 +128,21 @@ using value_set = std::variant<value_list, nonwrapping_range<bytes>>;
 /// - an expression without A "restricts" A to unbounded range
 extern value_set possible_lhs_values(const column_definition*, const expression&, const query_options&);
 
+/// If expr is a LIKE restriction on a string column, returns the range of values starting with the
+/// literal prefix of its pattern, which holds all the values the restriction can match.  Returns
+/// nullopt when there is no such prefix.
+extern std::optional<nonwrapping_range<bytes>> like_prefix_range(
+        const column_definition*, const expression&, const query_options&);
+
 /// Turns value_set into a range, unless it's a multi-valued list (in which case this throws).
 extern nonwrapping_range<bytes> to_range(const value_set&);
 
 /// True iff expr references the function.
 extern bool uses_function(const expression& expr, const sstring& ks_name, const sstring& function_name);
 
+/// True iff all terms of expr always bind to the same values for the same bound values, see term::is_pure().
+extern bool is_pure(const expression& expr);
+
 /// True iff the index can support the entire expression.
 extern bool is_supported_by(const expression&, const secondary_index::index&);
 
@@ -46,6 +46,8 @@
 #include "native_aggregate_function.hh"
 #include "exceptions/exceptions.hh"
 
+#include <boost/range/algorithm/count_if.hpp>
+
 using namespace cql3;
 using namespace functions;
 using namespace aggregate_fcts;
@@ -109,6 +111,71 @@ struct accumulator_for : public std::conditional_t<std::is_integral_v<T>,
                                                    same_type_accumulator_for<T>>
 { };
 
+// Types serialized as a single fixed-size big-endian integer or IEEE 754 value.
+// Aggregates over them decode blocks of inputs in place, instead of
+// materializing a data_value for every row.
+template <typename T>
+constexpr bool is_fixed_size_native_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+template <typename T>
+T decode_fixed_size(bytes_view v) {
+    if constexpr (std::is_floating_point_v<T>) {
+        using bits_type = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+        auto i = read_simple_exactly<bits_type>(v);
+        T d;
+        std::memcpy(&d, &i, sizeof(T));
+        return d;
+    } else {
+        return read_simple_exactly<T>(v);
+    }
+}
+
+// Decodes the non-null values of a block of inputs in chunks, and passes each
+// chunk to `consume(const T* values, size_t n)`. Values of the wrong size (i.e.
+// empty ones) go through add_input() in their turn, so that they behave exactly
+// as they do row by row.
+template <typename T, typename Consume>
+void consume_fixed_size_inputs(aggregate_function::aggregate& agg, cql_serialization_format sf,
+        std::vector<aggregate_function::opt_bytes>& values, Consume&& consume) {
+    static constexpr size_t chunk_size = 64;
+    std::array<T, chunk_size> chunk;
+    size_t n = 0;
+    for (auto& v : values) {
+        if (!v) {
+            continue;
+        }
+        if (__builtin_expect(v->size() != sizeof(T), false)) {
+            consume(chunk.data(), std::exchange(n, 0));
+            agg.add_input(sf, {std::move(v)});
+            continue;
+        }
+        chunk[n++] = decode_fixed_size<T>(*v);
+        if (n == chunk_size) {
+            consume(chunk.data(), std::exchange(n, 0));
+        }
+    }
+    consume(chunk.data(), n);
+}
+
+// Adds a chunk of values to the accumulator. Narrow integers are summed in
+// 64 bits first, which cannot overflow for a chunk and lets the loop vectorize;
+// floating point values are added in order, so the result does not depend on
+// how the rows were split into blocks.
+template <typename T>
+void accumulate_chunk(typename accumulator_for<T>::type& acc, const T* values, size_t n) {
+    if constexpr (std::is_integral_v<T> && sizeof(T) < sizeof(int64_t)) {
+        int64_t sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += values[i];
+        }
+        acc += sum;
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            acc += values[i];
+        }
+    }
+}
+
 template <typename Type>
 class impl_sum_function_for final : public aggregate_function::aggregate {
     using accumulator_type = typename accumulator_for<Type>::type;
@@ -126,6 +193,15 @@ class impl_sum_function_for final : public aggregate_function::aggregate {
         }
         _sum += value_cast<Type>(data_type_for<Type>()->deserialize(*values[0]));
     }
+    virtual void add_inputs(cql_serialization_format sf, std::vector<opt_bytes>& values) override {
+        if constexpr (is_fixed_size_native_v<Type>) {
+            consume_fixed_size_inputs<Type>(*this, sf, values, [this] (const Type* v, size_t n) {
+                accumulate_chunk<Type>(_sum, v, n);
+            });
+        } else {
+            aggregate::add_inputs(sf, values);
+        }
+    }
 };
 
 template <typename Type>
@@ -184,6 +260,16 @@ class impl_avg_function_for final : public aggregate_function::aggregate {
         ++_count;
         _sum += value_cast<Type>(data_type_for<Type>()->deserialize(*values[0]));
     }
+    virtual void add_inputs(cql_serialization_format sf, std::vector<opt_bytes>& values) override {
+        if constexpr (is_fixed_size_native_v<Type>) {
+            consume_fixed_size_inputs<Type>(*this, sf, values, [this] (const Type* v, size_t n) {
+                _count += n;
+                accumulate_chunk<Type>(_sum, v, n);
+            });
+        } else {
+            aggregate::add_inputs(sf, values);
+        }
+    }
 };
 
 template <typename Type>
@@ -265,6 +351,22 @@ class impl_max_function_for final : public aggregate_function::aggregate {
             _max = max_wrapper(*_max, val);
         }
     }
+    virtual void add_inputs(cql_serialization_format sf, std::vector<opt_bytes>& values) override {
+        if constexpr (is_fixed_size_native_v<Type>) {
+            consume_fixed_size_inputs<Type>(*this, sf, values, [this] (const Type* v, size_t n) {
+                if (!n) {
+                    return;
+                }
+                Type m = _max ? *_max : v[0];
+                for (size_t i = 0; i < n; ++i) {
+                    m = max_wrapper(m, v[i]);
+                }
+                _max = m;
+            });
+        } else {
+            aggregate::add_inputs(sf, values);
+        }
+    }
 };
 
 /// The same as `impl_max_function_for' but without compile-time dependency on `Type'.
@@ -361,6 +463,22 @@ class impl_min_function_for final : public aggregate_function::aggregate {
             _min = min_wrapper(*_min, val);
         }
     }
+    virtual void add_inputs(cql_serialization_format sf, std::vector<opt_bytes>& values) override {
+        if constexpr (is_fixed_size_native_v<Type>) {
+            consume_fixed_size_inputs<Type>(*this, sf, values, [this] (const Type* v, size_t n) {
+                if (!n) {
+                    return;
+                }
+                Type m = _min ? *_min : v[0];
+                for (size_t i = 0; i < n; ++i) {
+                    m = min_wrapper(m, v[i]);
+                }
+                _min = m;
+            });
+        } else {
+            aggregate::add_inputs(sf, values);
+        }
+    }
 };
 
 /// The same as `impl_min_function_for' but without compile-time dependency on `Type'.
@@ -435,6 +553,9 @@ class impl_count_function_for final : public aggregate_function::aggregate {
         }
         ++_count;
     }
+    virtual void add_inputs(cql_serialization_format sf, std::vector<opt_bytes>& values) override {
+        _count += boost::count_if(values, [] (const opt_bytes& v) { return bool(v); });
+    }
 };
 
 template <typename Type>
@@ -79,6 +79,23 @@ class aggregate_function : public virtual function {
          */
         virtual void add_input(cql_serialization_format sf, const std::vector<opt_bytes>& values) = 0;
 
+        /**
+         * Adds a block of inputs to a single-argument aggregate, one value per row.
+         *
+         * Equivalent to calling add_input() for each value in turn. Native aggregates
+         * over fixed-size types override it to work on the serialized values directly.
+         *
+         * @param protocol_version native protocol version
+         * @param values the argument values of consecutive rows; they may be consumed.
+         */
+        virtual void add_inputs(cql_serialization_format sf, std::vector<opt_bytes>& values) {
+            std::vector<opt_bytes> args(1);
+            for (auto& v : values) {
+                args[0] = std::move(v);
+                add_input(sf, args);
+            }
+        }
+
         /**
          * Computes and returns the aggregate current value.
          *
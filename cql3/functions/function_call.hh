@@ -57,6 +57,7 @@ class function_call : public non_terminal {
             : _fun(std::move(fun)), _terms(std::move(terms)) {
     }
     virtual bool uses_function(const sstring& ks_name, const sstring& function_name) const override;
+    virtual bool is_pure() const override;
     virtual void collect_marker_specification(variable_specifications& bound_names) const override;
     virtual shared_ptr<terminal> bind(const query_options& options) override;
     virtual cql3::raw_value_view bind_and_get(const query_options& options) override;
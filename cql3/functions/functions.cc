@@ -429,6 +429,11 @@ function_call::uses_function(const sstring& ks_name, const sstring& function_nam
     return _fun->uses_function(ks_name, function_name);
 }
 
+bool
+function_call::is_pure() const {
+    return _fun->is_native() && _fun->is_pure() && std::all_of(_terms.begin(), _terms.end(), std::mem_fn(&term::is_pure));
+}
+
 void
 function_call::collect_marker_specification(variable_specifications& bound_names) const {
     for (auto&& t : _terms) {
@@ -46,18 +46,15 @@ bytes_opt user_function::execute(cql_serialization_format sf, const std::vector<
         throw std::logic_error("Wrong number of parameters");
     }
 
-    std::vector<data_value> values;
-    values.reserve(parameters.size());
-    for (int i = 0, n = types.size(); i != n; ++i) {
-        const data_type& type = types[i];
-        const bytes_opt& bytes = parameters[i];
-        if (!bytes && !_called_on_null_input) {
-            return std::nullopt;
+    if (!_called_on_null_input) {
+        for (const bytes_opt& bytes : parameters) {
+            if (!bytes) {
+                return std::nullopt;
+            }
         }
-        values.push_back(bytes ? type->deserialize(*bytes) : data_value::make_null(type));
     }
 
-    return lua::run_script(lua::bitcode_view{_bitcode}, values, return_type(), _cfg).get0();
+    return lua::run_script(_scripts, lua::bitcode_view{_bitcode}, types, parameters, return_type(), _cfg).get0();
 }
 }
 }
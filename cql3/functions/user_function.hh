@@ -46,6 +46,10 @@ class user_function final : public abstract_function, public scalar_function {
     // global.
     lua::runtime_config _cfg;
 
+    // Functions are instantiated on every shard, so each shard gets
+    // its own pool.
+    lua::script_pool _scripts;
+
 public:
     user_function(function_name name, std::vector<data_type> arg_types, std::vector<sstring> arg_names, sstring body,
             sstring language, data_type return_type, bool called_on_null_input, sstring bitcode,
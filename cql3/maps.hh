@@ -98,6 +98,11 @@ class maps {
                 : _comparator(std::move(comparator)), _elements(std::move(elements)) {
         }
         virtual bool contains_bind_marker() const override;
+        virtual bool is_pure() const override {
+            return std::all_of(_elements.begin(), _elements.end(), [] (auto&& e) {
+                return e.first->is_pure() && e.second->is_pure();
+            });
+        }
         virtual void collect_marker_specification(variable_specifications& bound_names) const override;
         shared_ptr<terminal> bind(const query_options& options);
     };
@@ -32,8 +32,17 @@ using prepared_cache_entry = std::unique_ptr<statements::prepared_statement>;
 
 struct prepared_cache_entry_size {
     size_t operator()(const prepared_cache_entry& val) {
-        // TODO: improve the size approximation
-        return 10000;
+        // Sum what the statement owns. Its query string is counted twice:
+        // once for the string itself and once for the identifiers and literals
+        // parsed out of it, which the statement keeps as terms.
+        size_t size = sizeof(statements::prepared_statement)
+                + 2 * val->statement->raw_cql_statement.size()
+                + val->partition_key_bind_indices.size() * sizeof(uint16_t);
+        for (auto&& name : val->bound_names) {
+            size += sizeof(column_specification) + sizeof(column_identifier)
+                    + name->ks_name.size() + name->cf_name.size() + name->name->text().size();
+        }
+        return size;
     }
 };
 
@@ -147,6 +156,10 @@ class prepared_statements_cache {
         return boost::make_transform_iterator(_cache.begin(), _value_extractor_fn);
     }
 
+    void remove(const key_type& key) {
+        _cache.remove(key.key());
+    }
+
     template <typename Pred>
     void remove_if(Pred&& pred) {
         static_assert(std::is_same<bool, std::result_of_t<Pred(::shared_ptr<cql_statement>)>>::value, "Bad Pred signature");
@@ -50,6 +50,7 @@
 #include "cql3/untyped_result_set.hh"
 #include "db/config.hh"
 #include "database.hh"
+#include "db/data_listeners.hh"
 #include "hashers.hh"
 
 namespace cql3 {
@@ -67,6 +68,28 @@ const sstring query_processor::CQL_VERSION = "3.3.1";
 
 const std::chrono::minutes prepared_statements_cache::entry_expiry = std::chrono::minutes(60);
 
+class query_processor::write_listener : public db::data_listener {
+    query_processor& _qp;
+public:
+    explicit write_listener(query_processor& qp) : _qp(qp) {
+        _qp._db.data_listeners().install_write_listener(this);
+    }
+    ~write_listener() {
+        _qp._db.data_listeners().uninstall_write_listener(this);
+    }
+    // Results read before the write is applied are either cached already, and
+    // dropped here, or still being read, and then not cached since their
+    // partition was invalidated meanwhile.
+    virtual void on_applied(const schema_ptr& s, const frozen_mutation& m) override {
+        if (s->caching_options().results_ttl().count()) {
+            _qp.invalidate_cached_results(s->id(), dht::get_token(*s, m.key()));
+        }
+    }
+    virtual void on_invalidated(const schema_ptr& s) override {
+        _qp._result_cache.invalidate(s->id());
+    }
+};
+
 class query_processor::internal_state {
     service::query_state _qs;
 public:
@@ -97,7 +120,8 @@ query_processor::query_processor(service::storage_proxy& proxy, database& db, se
         , _authorized_prepared_cache(std::min(std::chrono::milliseconds(_db.get_config().permissions_validity_in_ms()),
                                               std::chrono::duration_cast<std::chrono::milliseconds>(prepared_statements_cache::entry_expiry)),
                                      std::chrono::milliseconds(_db.get_config().permissions_update_interval_in_ms()),
-                                     mcfg.authorized_prepared_cache_size, authorized_prepared_statements_cache_log) {
+                                     mcfg.authorized_prepared_cache_size, authorized_prepared_statements_cache_log)
+        , _result_cache(mcfg.result_cache_size) {
     namespace sm = seastar::metrics;
     namespace stm = statements;
     using clevel = db::consistency_level;
@@ -358,6 +382,31 @@ query_processor::query_processor(service::storage_proxy& proxy, database& db, se
                             [this] { return _prepared_cache.memory_footprint(); },
                             sm::description("Size (in bytes) of the prepared statements cache.")),
 
+                    sm::make_derive(
+                            "result_cache_hits",
+                            [this] { return _result_cache.get_stats().hits; },
+                            sm::description("Counts the number of prepared SELECT requests answered from the result cache.")),
+
+                    sm::make_derive(
+                            "result_cache_misses",
+                            [this] { return _result_cache.get_stats().misses; },
+                            sm::description("Counts the number of cacheable prepared SELECT requests whose result was not in the result cache.")),
+
+                    sm::make_derive(
+                            "result_cache_invalidations",
+                            [this] { return _result_cache.get_stats().invalidations; },
+                            sm::description("Counts the number of result cache entries dropped because their partition was written to.")),
+
+                    sm::make_derive(
+                            "result_cache_evictions",
+                            [this] { return _result_cache.get_stats().evictions; },
+                            sm::description("Counts the number of result cache entries evicted to stay within its memory limit.")),
+
+                    sm::make_gauge(
+                            "result_cache_memory_footprint",
+                            [this] { return _result_cache.memory_used(); },
+                            sm::description("Size (in bytes) of the result cache.")),
+
                     sm::make_derive(
                             "secondary_index_creates",
                             _cql_stats.secondary_index_creates,
@@ -424,6 +473,16 @@ query_processor::query_processor(service::storage_proxy& proxy, database& db, se
                             _cql_stats.select_partition_range_scan_no_bypass_cache,
                             sm::description("Counts the number of SELECT query executions requiring partition range scan without BYPASS CACHE option.")),
 
+                    sm::make_derive(
+                            "select_prefetched_pages",
+                            _cql_stats.select_prefetched_pages,
+                            sm::description("Counts the number of result pages prefetched for clients using the SCYLLA_PAGE_PREFETCH protocol extension.")),
+
+                    sm::make_derive(
+                            "select_prefetched_pages_used",
+                            _cql_stats.select_prefetched_pages_used,
+                            sm::description("Counts the number of prefetched result pages served to clients. See select_prefetched_pages to compare how many prefetched pages were wasted.")),
+
                     sm::make_derive(
                             "authorized_prepared_statements_cache_evictions",
                             [] { return authorized_prepared_statements_cache::shard_stats().authorized_prepared_statements_cache_evictions; },
@@ -461,12 +520,18 @@ query_processor::query_processor(service::storage_proxy& proxy, database& db, se
             });
 
     _mnotifier.register_listener(_migration_subscriber.get());
+    _write_listener = std::make_unique<write_listener>(*this);
 }
 
 query_processor::~query_processor() {
 }
 
+void query_processor::invalidate_cached_results(utils::UUID table, dht::token token) {
+    _result_cache.invalidate(table, token);
+}
+
 future<> query_processor::stop() {
+    _write_listener.reset();
     return _mnotifier.unregister_listener(_migration_subscriber.get()).then([this] {
         return _authorized_prepared_cache.stop().finally([this] { return _prepared_cache.stop(); });
     });
@@ -562,6 +627,40 @@ query_processor::prepare(sstring query_string, const service::client_state& clie
     }
 }
 
+future<statements::prepared_statement::checked_weak_ptr>
+query_processor::recover_prepared(const prepared_cache_key_type& key, const service::client_state& client_state) {
+    using found_type = std::optional<sstring>;
+    // Ask the other shards one at a time and stop at the first one which has
+    // the statement, so that a miss doesn't cost a round trip to every shard.
+    return do_with(found_type(), unsigned(1), [key] (found_type& query, unsigned& next) {
+        return do_until([&query, &next] { return query || next == smp::count; }, [key, &query, &next] {
+            auto shard = (this_shard_id() + next++) % smp::count;
+            return get_query_processor().invoke_on(shard, [key] (query_processor& qp) -> found_type {
+                auto prepared = qp.get_prepared(key);
+                if (!prepared) {
+                    return std::nullopt;
+                }
+                return prepared->statement->raw_cql_statement;
+            }).then([&query] (found_type found) {
+                query = std::move(found);
+            });
+        }).then([&query] {
+            return std::move(query);
+        });
+    }).then([this, key, &client_state] (found_type query) {
+        if (!query || compute_id(*query, client_state.get_raw_keyspace()) != key) {
+            throw exceptions::prepared_query_not_found_exception(prepared_cache_key_type::cql_id(key));
+        }
+        return prepare(std::move(*query), client_state, false).then([this, key] (auto&&) {
+            auto prepared = get_prepared(key);
+            if (!prepared) {
+                throw exceptions::prepared_query_not_found_exception(prepared_cache_key_type::cql_id(key));
+            }
+            return prepared;
+        });
+    });
+}
+
 static std::string hash_target(std::string_view query_string, std::string_view keyspace) {
     std::string ret(keyspace);
     ret += query_string;
@@ -928,6 +1027,8 @@ void query_processor::migration_subscriber::remove_invalid_prepared_statements(
     _qp->_prepared_cache.remove_if([&] (::shared_ptr<cql_statement> stmt) {
         return this->should_invalidate(ks_name, cf_name, stmt);
     });
+    // Cached results carry the metadata of the schema they were read with.
+    _qp->_result_cache.clear();
 }
 
 bool query_processor::migration_subscriber::should_invalidate(
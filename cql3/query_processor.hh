@@ -51,6 +51,7 @@
 #include "cql3/prepared_statements_cache.hh"
 #include "cql3/authorized_prepared_statements_cache.hh"
 #include "cql3/query_options.hh"
+#include "cql3/result_cache.hh"
 #include "cql3/statements/prepared_statement.hh"
 #include "exceptions/exceptions.hh"
 #include "log.hh"
@@ -105,13 +106,16 @@ class cql_config;
 class query_processor {
 public:
     class migration_subscriber;
+    class write_listener;
     struct memory_config {
         size_t prepared_statment_cache_size = 0;
         size_t authorized_prepared_cache_size = 0;
+        size_t result_cache_size = 0;
     };
 
 private:
     std::unique_ptr<migration_subscriber> _migration_subscriber;
+    std::unique_ptr<write_listener> _write_listener;
     service::storage_proxy& _proxy;
     database& _db;
     service::migration_notifier& _mnotifier;
@@ -132,6 +136,8 @@ class query_processor {
     prepared_statements_cache _prepared_cache;
     authorized_prepared_statements_cache _authorized_prepared_cache;
 
+    result_cache _result_cache;
+
     // A map for prepared statements used internally (which we don't want to mix with user statement, in particular we
     // don't bother with expiration on those.
     std::unordered_map<sstring, std::unique_ptr<statements::prepared_statement>> _internal_statements;
@@ -169,6 +175,14 @@ class query_processor {
         return _cql_stats;
     }
 
+    cql3::result_cache& get_result_cache() {
+        return _result_cache;
+    }
+
+    // Drops the results cached on this shard which were read from the partition with the token.
+    // Only the shard owning the partition caches its results, see result_cache.
+    void invalidate_cached_results(utils::UUID table, dht::token token);
+
     statements::prepared_statement::checked_weak_ptr get_prepared(const std::optional<auth::authenticated_user>& user, const prepared_cache_key_type& key) {
         if (user) {
             auto it = _authorized_prepared_cache.find(*user, key);
@@ -192,6 +206,20 @@ class query_processor {
         return *it;
     }
 
+    // Shards evict prepared statements independently, so a statement missing
+    // from this shard's cache may still be prepared on another one. Prepares
+    // it again here from the other shard's query string, instead of having the
+    // client prepare it on all shards. Fails with prepared_query_not_found_exception
+    // if no shard has it, or if it was prepared in another keyspace than the
+    // client's current one, since it can't be prepared again here then.
+    future<statements::prepared_statement::checked_weak_ptr>
+    recover_prepared(const prepared_cache_key_type& key, const service::client_state& client_state);
+
+    // Drops the statement from this shard's cache only, as its eviction would.
+    void evict_prepared(const prepared_cache_key_type& key) {
+        _prepared_cache.remove(key);
+    }
+
     future<::shared_ptr<cql_transport::messages::result_message>>
     execute_prepared(
             statements::prepared_statement::checked_weak_ptr statement,
@@ -250,18 +250,32 @@ class single_column_primary_key_restrictions : public primary_key_restrictions<V
             const column_definition* def = e.first;
             auto&& r = e.second;
 
-            if (vec_of_values.size() != _schema->position(*def) || find_needs_filtering(r->expression)) {
-                // The prefixes built so far are the longest we can build,
-                // the rest of the constraints will have to be applied using filtering.
+            if (vec_of_values.size() != _schema->position(*def)) {
                 break;
             }
 
-            if (has_slice(r->expression)) {
+            std::optional<nonwrapping_range<bytes>> slice;
+            if (find_needs_filtering(r->expression)) {
+                if constexpr (std::is_same_v<ValueType, clustering_key>) {
+                    // A LIKE pattern with a literal prefix still lets us skip the rows outside of
+                    // the prefix's range; the restriction itself is applied using filtering.
+                    slice = expr::like_prefix_range(def, r->expression, options);
+                }
+                if (!slice) {
+                    // The prefixes built so far are the longest we can build,
+                    // the rest of the constraints will have to be applied using filtering.
+                    break;
+                }
+            } else if (has_slice(r->expression)) {
                 const auto values = possible_lhs_values(def, r->expression, options);
                 if (values == expr::value_set(expr::value_list{})) {
                     return {};
                 }
-                const auto b = expr::to_range(values);
+                slice = expr::to_range(values);
+            }
+
+            if (slice) {
+                const auto& b = *slice;
                 if (cartesian_product_is_empty(vec_of_values)) {
                     // TODO: use b.transform().
                     const auto make_bound = [&] (const std::optional<::range_bound<bytes>>& bytes_bound) {
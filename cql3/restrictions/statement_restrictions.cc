@@ -322,6 +322,14 @@ bool statement_restrictions::uses_function(const sstring& ks_name, const sstring
             || _nonprimary_key_restrictions->uses_function(ks_name, function_name);
 }
 
+bool statement_restrictions::is_pure() const {
+    return expr::is_pure(_partition_key_restrictions->expression)
+            && expr::is_pure(_clustering_columns_restrictions->expression)
+            && boost::algorithm::all_of(_nonprimary_key_restrictions->restrictions(), [] (auto&& e) {
+                return expr::is_pure(e.second->expression);
+            });
+}
+
 const std::vector<::shared_ptr<restrictions>>& statement_restrictions::index_restrictions() const {
     return _index_restrictions;
 }
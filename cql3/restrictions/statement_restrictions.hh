@@ -126,6 +126,9 @@ class statement_restrictions {
 public:
     bool uses_function(const sstring& ks_name, const sstring& function_name) const;
 
+    // Whether the restrictions always select the same rows for the same bound values.
+    bool is_pure() const;
+
     const std::vector<::shared_ptr<restrictions>>& index_restrictions() const;
 
     /**
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cql3/result_cache.hh"
+#include "cql3/statements/select_statement.hh"
+#include "db/consistency_level_validations.hh"
+#include "query-request.hh"
+#include "service/pager/paging_state.hh"
+#include "utils/serialization.hh"
+
+namespace cql3 {
+
+result_cache::~result_cache() {
+    _lru.clear();
+}
+
+std::optional<result_cache::source> result_cache::cacheable(const cql_statement& statement, const query_options& options) const {
+    // Indexed reads are performed by indexed_table_select_statement.
+    auto select = dynamic_cast<const statements::primary_key_select_statement*>(&statement);
+    if (!select) {
+        return std::nullopt;
+    }
+    auto& s = select->get_schema();
+    auto ttl = s->caching_options().results_ttl();
+    // Counter updates are applied without notifying data listeners, so they can't invalidate results.
+    if (!ttl.count() || s->is_counter() || db::is_serial_consistency(options.get_consistency())) {
+        return std::nullopt;
+    }
+    // Results of non-pure selections or restrictions change even if the data doesn't.
+    if (!select->get_selection().is_pure() || !select->get_restrictions()->is_pure()) {
+        return std::nullopt;
+    }
+    auto ranges = select->get_restrictions()->get_partition_key_ranges(options);
+    if (ranges.size() != 1 || !query::is_single_partition(ranges.front())) {
+        return std::nullopt;
+    }
+    auto token = ranges.front().start()->value().token();
+    // Writes to the partition are only seen by its shard.
+    if (s->get_sharder().shard_of(token) != this_shard_id()) {
+        return std::nullopt;
+    }
+    return source{s->id(), token, ttl, _generations[generation_index(s->id(), token)]};
+}
+
+size_t result_cache::generation_index(const utils::UUID& table, dht::token token) {
+    return (std::hash<utils::UUID>()(table) ^ std::hash<dht::token>()(token)) % generation_count;
+}
+
+bytes result_cache::make_key(uint8_t version, bytes_view id, const query_options& options) {
+    bytes_ostream key;
+    auto out = key.write_begin();
+    serialize_int8(out, version);
+    key.write(id);
+    serialize_int16(out, uint16_t(options.get_consistency()));
+    serialize_bool(out, options.skip_metadata());
+    serialize_int32(out, options.get_page_size());
+    auto write_bytes = [&] (const auto& fragments, int32_t size) {
+        serialize_int32(out, size);
+        for (bytes_view f : fragments) {
+            key.write(f);
+        }
+    };
+    for (size_t i = 0; i < options.get_values_count(); ++i) {
+        auto value = options.get_value_at(i);
+        if (value.is_null()) {
+            serialize_int32(out, -1);
+        } else if (value.is_unset_value()) {
+            serialize_int32(out, -2);
+        } else {
+            write_bytes(*value, value->size_bytes());
+        }
+    }
+    if (auto paging_state = options.get_paging_state()) {
+        auto state = paging_state->serialize();
+        write_bytes(std::array<bytes_view, 1>{*state}, state->size());
+    } else {
+        serialize_int32(out, -1);
+    }
+    return to_bytes(key.linearize());
+}
+
+const bytes_ostream* result_cache::find(bytes_view key) {
+    auto i = _entries.find(key);
+    if (i == _entries.end()) {
+        ++_stats.misses;
+        return nullptr;
+    }
+    auto& e = *i->second;
+    if (e.expiry <= clock_type::now()) {
+        ++_stats.misses;
+        remove(e);
+        return nullptr;
+    }
+    ++_stats.hits;
+    _lru.erase(_lru.iterator_to(e));
+    _lru.push_back(e);
+    return &e.result;
+}
+
+void result_cache::insert(bytes key, const source& src, bytes_ostream result) {
+    if (src.generation != _generations[generation_index(src.table, src.token)]) {
+        return;
+    }
+    if (auto i = _entries.find(key); i != _entries.end()) {
+        remove(*i->second);
+    }
+    auto e = std::make_unique<entry>(entry{std::move(key), src.table, src.token, clock_type::now() + src.ttl, std::move(result)});
+    auto size = e->memory_usage();
+    if (size > _max_memory) {
+        return;
+    }
+    _memory_used += size;
+    _by_token.emplace(e->token, e.get());
+    _lru.push_back(*e);
+    bytes_view k = e->key;
+    _entries.emplace(k, std::move(e));
+    while (_memory_used > _max_memory) {
+        ++_stats.evictions;
+        remove(_lru.front());
+    }
+}
+
+void result_cache::invalidate(const utils::UUID& table, dht::token token) {
+    ++_generations[generation_index(table, token)];
+    auto [i, end] = _by_token.equal_range(token);
+    while (i != end) {
+        auto& e = *i++->second;
+        if (e.table == table) {
+            ++_stats.invalidations;
+            remove(e);
+        }
+    }
+}
+
+void result_cache::invalidate(const utils::UUID& table) {
+    for (auto& g : _generations) {
+        ++g;
+    }
+    for (auto i = _lru.begin(); i != _lru.end();) {
+        auto& e = *i++;
+        if (e.table == table) {
+            ++_stats.invalidations;
+            remove(e);
+        }
+    }
+}
+
+void result_cache::clear() {
+    for (auto& g : _generations) {
+        ++g;
+    }
+    _lru.clear();
+    _by_token.clear();
+    _entries.clear();
+    _memory_used = 0;
+}
+
+void result_cache::remove(entry& e) {
+    auto [begin, end] = _by_token.equal_range(e.token);
+    _by_token.erase(std::find_if(begin, end, [&e] (const auto& p) { return p.second == &e; }));
+    _lru.erase(_lru.iterator_to(e));
+    _memory_used -= e.memory_usage();
+    _entries.erase(_entries.find(bytes_view(e.key)));
+}
+
+}
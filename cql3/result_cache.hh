@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <boost/intrusive/list.hpp>
+#include <seastar/core/lowres_clock.hh>
+
+#include "bytes.hh"
+#include "bytes_ostream.hh"
+#include "dht/i_partitioner.hh"
+#include "utils/UUID.hh"
+
+namespace cql3 {
+
+class cql_statement;
+class query_options;
+
+// Serialized results of prepared SELECTs which read a single partition of a
+// table opted in with the 'results_ttl_in_ms' caching option, so that a
+// coordinator can answer repeated identical requests without reading again.
+//
+// Results are only cached by the shard owning the partition they read, which
+// is also the shard applying the writes to it. Entries are keyed by whatever
+// identifies a request completely, and hold the serialized response. They
+// are dropped when their time to live expires, when the partition they read
+// is written to on this node (see query_processor::invalidate_cached_results()),
+// when the table gets data other than by writes, e.g. when it is truncated
+// or streamed or repaired to, or when the schema changes. Writes which only
+// reach other replicas are not seen, so a cached result may be stale by up
+// to the table's results time to live.
+class result_cache {
+public:
+    using clock_type = seastar::lowres_clock;
+
+    // Where a result which may be cached is read from.
+    struct source {
+        utils::UUID table;
+        dht::token token;
+        std::chrono::milliseconds ttl;
+        // Generation of the partition before the result was read. A result read
+        // while its partition was invalidated may predate the write, so it is not cached.
+        uint64_t generation;
+    };
+
+    struct stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t invalidations = 0;
+        uint64_t evictions = 0;
+    };
+private:
+    struct entry {
+        bytes key;
+        utils::UUID table;
+        dht::token token;
+        clock_type::time_point expiry;
+        bytes_ostream result;
+        boost::intrusive::list_member_hook<> _lru_link;
+
+        size_t memory_usage() const {
+            return sizeof(entry) + key.size() + result.size();
+        }
+    };
+    using lru_type = boost::intrusive::list<entry,
+            boost::intrusive::member_hook<entry, boost::intrusive::list_member_hook<>, &entry::_lru_link>,
+            boost::intrusive::constant_time_size<false>>;
+
+    // Partitions share generations by the hash of their table and token, so
+    // that tracking them takes constant memory. An invalidation of one of them
+    // only keeps results of the others sharing its generation from being cached.
+    static constexpr size_t generation_count = 1024;
+
+    size_t _max_memory;
+    size_t _memory_used = 0;
+    std::array<uint64_t, generation_count> _generations{};
+    // Views of the keys are owned by the entries.
+    std::unordered_map<bytes_view, std::unique_ptr<entry>> _entries;
+    std::unordered_multimap<dht::token, entry*> _by_token;
+    // Least recently used entries first.
+    lru_type _lru;
+    stats _stats;
+private:
+    void remove(entry& e);
+    static size_t generation_index(const utils::UUID& table, dht::token token);
+public:
+    explicit result_cache(size_t max_memory) : _max_memory(max_memory) { }
+    result_cache(result_cache&&) = delete;
+    ~result_cache();
+
+    // The source of the results of the statement, if they may be cached:
+    // the statement has to read a single partition owned by this shard, not
+    // by an index, at a non-serial consistency level, from a non-counter table
+    // with a results time to live, and both restrict and select by values
+    // which depend only on the bound values and the data read.
+    std::optional<source> cacheable(const cql_statement& statement, const query_options& options) const;
+
+    // Identifies an EXECUTE request of the prepared statement with the id by what
+    // its result depends on: the protocol version, the consistency level, whether
+    // metadata is skipped, the bound values, the page size and the paging state.
+    // The default timestamp, which drivers set on every request, and the serial
+    // consistency level, which non-serial reads don't use, are left out.
+    // The options have to be prepared already, so that named values are in order.
+    static bytes make_key(uint8_t version, bytes_view id, const query_options& options);
+
+    // The cached result for the key, or nullptr.
+    const bytes_ostream* find(bytes_view key);
+
+    void insert(bytes key, const source& src, bytes_ostream result);
+
+    // Drops the results read from the partition with the token.
+    void invalidate(const utils::UUID& table, dht::token token);
+
+    // Drops the results read from the table.
+    void invalidate(const utils::UUID& table);
+
+    void clear();
+
+    size_t size() const {
+        return _entries.size();
+    }
+
+    size_t memory_used() const {
+        return _memory_used;
+    }
+
+    const stats& get_stats() const {
+        return _stats;
+    }
+};
+
+}
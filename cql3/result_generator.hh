@@ -37,19 +37,36 @@ class result_generator {
     class query_result_visitor {
         const schema& _schema;
         std::vector<bytes> _partition_key;
-        std::vector<bytes> _clustering_key;
+        // Views into the key of the row being visited, valid only for the duration of accept_new_row().
+        std::vector<bytes_view> _clustering_key;
+        // The selected static cells of the current partition, in selection order. They are the same
+        // for every row of the partition, so they are read from the static row only once.
+        std::vector<std::optional<query::result_bytes_view>> _static_values;
+        bool _static_values_read = false;
         uint64_t _partition_row_count = 0;
         uint64_t _total_row_count = 0;
         Visitor& _visitor;
         const selection::selection& _selection;
     private:
-        void accept_cell_value(const column_definition& def, query::result_row_view::iterator_type& i) {
+        static std::optional<query::result_bytes_view> cell_value(const column_definition& def, query::result_row_view::iterator_type& i) {
             if (def.is_multi_cell()) {
-                _visitor.accept_value(i.next_collection_cell());
-            } else {
-                auto cell = i.next_atomic_cell();
-                _visitor.accept_value(cell ? std::optional<query::result_bytes_view>(cell->value()) : std::optional<query::result_bytes_view>());
+                return i.next_collection_cell();
             }
+            auto cell = i.next_atomic_cell();
+            return cell ? std::optional<query::result_bytes_view>(cell->value()) : std::optional<query::result_bytes_view>();
+        }
+        const std::vector<std::optional<query::result_bytes_view>>& static_values(const query::result_row_view& static_row) {
+            if (!_static_values_read) {
+                _static_values.clear();
+                auto static_row_iterator = static_row.iterator();
+                for (auto&& def : _selection.get_columns()) {
+                    if (def->is_static()) {
+                        _static_values.push_back(cell_value(*def, static_row_iterator));
+                    }
+                }
+                _static_values_read = true;
+            }
+            return _static_values;
         }
     public:
         query_result_visitor(const schema& s, Visitor& visitor, const selection::selection& select)
@@ -62,16 +79,21 @@ class result_generator {
         void accept_new_partition(uint64_t row_count) {
             _partition_row_count = row_count;
             _total_row_count += row_count;
+            _static_values_read = false;
         }
 
         void accept_new_row(const clustering_key& key, query::result_row_view static_row,
                             query::result_row_view row) {
-            _clustering_key = key.explode(_schema);
+            _clustering_key.clear();
+            for (auto&& component : key.components(_schema)) {
+                _clustering_key.push_back(component);
+            }
             accept_new_row(static_row, row);
+            _clustering_key.clear();
         }
         void accept_new_row(query::result_row_view static_row, query::result_row_view row) {
-            auto static_row_iterator = static_row.iterator();
             auto row_iterator = row.iterator();
+            size_t static_index = 0;
             _visitor.start_row();
             for (auto&& def : _selection.get_columns()) {
                 switch (def->kind) {
@@ -80,16 +102,16 @@ class result_generator {
                     break;
                 case column_kind::clustering_key:
                     if (_clustering_key.size() > def->component_index()) {
-                        _visitor.accept_value(query::result_bytes_view(bytes_view(_clustering_key[def->component_index()])));
+                        _visitor.accept_value(query::result_bytes_view(_clustering_key[def->component_index()]));
                     } else {
                         _visitor.accept_value({});
                     }
                     break;
                 case column_kind::regular_column:
-                    accept_cell_value(*def, row_iterator);
+                    _visitor.accept_value(cell_value(*def, row_iterator));
                     break;
                 case column_kind::static_column:
-                    accept_cell_value(*def, static_row_iterator);
+                    _visitor.accept_value(static_values(static_row)[static_index++]);
                     break;
                 }
             }
@@ -99,13 +121,13 @@ class result_generator {
         void accept_partition_end(const query::result_row_view& static_row) {
             if (_partition_row_count == 0) {
                 _total_row_count++;
+                size_t static_index = 0;
                 _visitor.start_row();
-                auto static_row_iterator = static_row.iterator();
                 for (auto&& def : _selection.get_columns()) {
                     if (def->is_partition_key()) {
                         _visitor.accept_value(query::result_bytes_view(bytes_view(_partition_key[def->component_index()])));
                     } else if (def->is_static()) {
-                        accept_cell_value(*def, static_row_iterator);
+                        _visitor.accept_value(static_values(static_row)[static_index++]);
                     } else {
                         _visitor.accept_value({});
                     }
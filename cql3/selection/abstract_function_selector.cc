@@ -101,6 +101,10 @@ abstract_function_selector::new_factory(shared_ptr<functions::function> fun, sha
         virtual bool is_aggregate_selector_factory() const override {
             return _fun->is_aggregate() || _factories->contains_only_aggregate_functions();
         }
+
+        virtual bool is_pure() const override {
+            return _fun->is_native() && _fun->is_pure() && _factories->is_pure();
+        }
     };
 
     return make_shared<fun_selector_factory>(std::move(fun), std::move(factories));
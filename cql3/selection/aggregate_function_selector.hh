@@ -47,7 +47,19 @@ namespace cql3 {
 namespace selection {
 
 class aggregate_function_selector : public abstract_function_selector_for<functions::aggregate_function> {
+    // Number of rows whose argument a single-argument aggregate collects
+    // before consuming them at once, see aggregate::add_inputs().
+    static constexpr size_t block_size = 128;
+
     std::unique_ptr<functions::aggregate_function::aggregate> _aggregate;
+    std::vector<bytes_opt> _block;
+
+    void flush(cql_serialization_format sf) {
+        if (!_block.empty()) {
+            _aggregate->add_inputs(sf, _block);
+            _block.clear();
+        }
+    }
 public:
     virtual bool is_aggregate() const override {
         return true;
@@ -56,6 +68,16 @@ class aggregate_function_selector : public abstract_function_selector_for<functi
     virtual void add_input(cql_serialization_format sf, result_set_builder& rs) override {
         // Aggregation of aggregation is not supported
         size_t m = _arg_selectors.size();
+        if (m == 1) {
+            auto&& s = _arg_selectors[0];
+            s->add_input(sf, rs);
+            _block.push_back(s->get_output(sf));
+            s->reset();
+            if (_block.size() == block_size) {
+                flush(sf);
+            }
+            return;
+        }
         for (size_t i = 0; i < m; ++i) {
             auto&& s = _arg_selectors[i];
             s->add_input(sf, rs);
@@ -66,10 +88,12 @@ class aggregate_function_selector : public abstract_function_selector_for<functi
     }
 
     virtual bytes_opt get_output(cql_serialization_format sf) override {
+        flush(sf);
         return _aggregate->compute(sf);
     }
 
     virtual void reset() override {
+        _block.clear();
         _aggregate->reset();
     }
 
@@ -78,6 +102,9 @@ class aggregate_function_selector : public abstract_function_selector_for<functi
             : abstract_function_selector_for<functions::aggregate_function>(
                     dynamic_pointer_cast<functions::aggregate_function>(func), std::move(arg_selectors))
             , _aggregate(fun()->new_aggregate()) {
+        if (_arg_selectors.size() == 1) {
+            _block.reserve(block_size);
+        }
     }
 };
 
@@ -166,6 +166,10 @@ class selection_with_processing : public selection {
         return _factories->uses_function(ks_name, function_name);
     }
 
+    virtual bool is_pure() const override {
+        return _factories->is_pure();
+    }
+
     virtual uint32_t add_column_for_post_processing(const column_definition& c) override {
         uint32_t index = selection::add_column_for_post_processing(c);
         _factories->add_selector_for_post_processing(c, index);
@@ -190,6 +190,11 @@ class selection {
         return false;
     }
 
+    // Whether the same rows are always selected as the same values.
+    virtual bool is_pure() const {
+        return true;
+    }
+
     query::partition_slice::option_set get_query_options();
 private:
     static bool processes_selection(const std::vector<::shared_ptr<raw_selector>>& raw_selectors) {
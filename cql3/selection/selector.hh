@@ -181,6 +181,17 @@ class selector::factory {
         return false;
     }
 
+    /**
+     * Checks if the selectors created by this factory always select the same values from the same rows.
+     * Non-pure and user-defined functions may not, nor does <code>TTL</code>, which decreases with time.
+     *
+     * @return <code>true</code> if the selectors created by this factory always select the same values
+     * from the same rows, <code>false</code> otherwise
+     */
+    virtual bool is_pure() const {
+        return true;
+    }
+
     /**
      * Returns the name of the column corresponding to the output value of the selector instances created by
      * this factory.
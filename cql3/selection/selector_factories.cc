@@ -78,6 +78,10 @@ bool selector_factories::uses_function(const sstring& ks_name, const sstring& fu
     return false;
 }
 
+bool selector_factories::is_pure() const {
+    return std::all_of(_factories.begin(), _factories.end(), [] (auto&& f) { return f->is_pure(); });
+}
+
 void selector_factories::add_selector_for_post_processing(const column_definition& def, uint32_t index) {
     _factories.emplace_back(simple_selector::new_factory(def.name_as_text(), index, def.type));
     ++_number_of_factories_for_post_processing;
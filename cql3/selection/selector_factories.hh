@@ -149,6 +149,13 @@ class selector_factories {
         return _contains_ttl_factory;
     }
 
+    /**
+     * Checks if all the factories of this <code>SelectorFactories</code> create pure selectors.
+     *
+     * @return <code>true</code> if all the factories create pure selectors, <code>false</code> otherwise.
+     */
+    bool is_pure() const;
+
     /**
      * Creates a list of new <code>selector</code> instances.
      * @return a list of new <code>selector</code> instances.
@@ -82,6 +82,10 @@ class writetime_or_ttl_selector : public selector {
             virtual bool is_ttl_selector_factory() const override {
                 return !_is_writetime;
             }
+
+            virtual bool is_pure() const override {
+                return _is_writetime;
+            }
         };
         return ::make_shared<wtots_factory>(std::move(column_name), idx, is_writetime);
     }
@@ -209,11 +209,12 @@ future<std::vector<mutation>> batch_statement::get_mutations(service::storage_pr
                 }
             });
         }).then([&result] {
-            // can't use range adaptors, because we want to move
+            // can't use range adaptors, because we want to move; set elements
+            // are const, so they have to be extracted to be moved rather than copied
             auto vresult = std::vector<mutation>();
             vresult.reserve(result.size());
-            for (auto&& m : result) {
-                vresult.push_back(std::move(m));
+            while (!result.empty()) {
+                vresult.push_back(std::move(result.extract(result.begin()).value()));
             }
             return vresult;
         });
@@ -59,6 +59,7 @@
 #include "db/timeout_clock.hh"
 #include "db/consistency_level_validations.hh"
 #include "database.hh"
+#include "gms/feature_service.hh"
 #include <boost/algorithm/cxx11/any_of.hpp>
 
 bool is_system_keyspace(const sstring& name);
@@ -154,6 +155,7 @@ select_statement::select_statement(schema_ptr schema,
     _opts.set_if<query::partition_slice::option::bypass_cache>(_parameters->bypass_cache());
     _opts.set_if<query::partition_slice::option::distinct>(_parameters->is_distinct());
     _opts.set_if<query::partition_slice::option::reversed>(_is_reversed);
+    _single_row_plan = make_single_row_plan();
 }
 
 bool select_statement::uses_function(const sstring& ks_name, const sstring& function_name) const {
@@ -243,6 +245,71 @@ select_statement::make_partition_slice(const query_options& options) const
         std::move(static_columns), std::move(regular_columns), _opts, nullptr, options.get_cql_serialization_format(), get_per_partition_limit(options));
 }
 
+static std::optional<query::column_filter_op> to_column_filter_op(expr::oper_t op) {
+    switch (op) {
+    case expr::oper_t::EQ:
+        return query::column_filter_op::EQ;
+    case expr::oper_t::LT:
+        return query::column_filter_op::LT;
+    case expr::oper_t::LTE:
+        return query::column_filter_op::LTE;
+    case expr::oper_t::GT:
+        return query::column_filter_op::GT;
+    case expr::oper_t::GTE:
+        return query::column_filter_op::GTE;
+    default:
+        return std::nullopt;
+    }
+}
+
+static void add_to_row_filter(query::row_filter& filter, const expr::expression& restr,
+        const query::partition_slice& slice, const query_options& options) {
+    std::visit(overloaded_functor{
+        [&] (bool) { },
+        [&] (const expr::conjunction& conj) {
+            for (auto& child : conj.children) {
+                add_to_row_filter(filter, child, slice, options);
+            }
+        },
+        [&] (const expr::binary_operator& oper) {
+            auto cv = std::get_if<expr::column_value>(&oper.lhs);
+            if (!cv || cv->sub) {
+                return;
+            }
+            const column_definition& def = *cv->col;
+            if (!def.is_regular() || !def.is_atomic() || def.is_counter() || def.type->references_duration()) {
+                return;
+            }
+            // Replicas only see the cells of the queried columns.
+            if (std::find(slice.regular_columns.begin(), slice.regular_columns.end(), def.id) == slice.regular_columns.end()) {
+                return;
+            }
+            auto op = to_column_filter_op(oper.op);
+            if (!op) {
+                return;
+            }
+            auto value = to_bytes_opt(oper.rhs->bind_and_get(options));
+            if (!value) {
+                return;
+            }
+            filter.push_back(query::column_filter{def.id, *op, std::move(*value)});
+        },
+    }, restr);
+}
+
+query::row_filter select_statement::make_row_filter(const query::partition_slice& slice, const query_options& options) const {
+    query::row_filter filter;
+    // The per-partition limit is applied by replicas before filtering, so
+    // they must return the rows it counts.
+    if (slice.partition_row_limit() != query::partition_max_rows || _parameters->is_distinct()) {
+        return filter;
+    }
+    for (auto&& [def, restr] : _restrictions->get_non_pk_restriction()) {
+        add_to_row_filter(filter, restr->expression, slice, options);
+    }
+    return filter;
+}
+
 uint64_t select_statement::do_get_limit(const query_options& options, ::shared_ptr<term> limit, uint64_t default_limit) const {
     if (!limit || _selection->is_aggregate()) {
         return default_limit;
@@ -274,6 +341,100 @@ bool select_statement::needs_post_query_ordering() const {
     return _restrictions->key_is_in_relation() && !_parameters->orderings().empty();
 }
 
+// The terms the key columns are restricted to be equal to, in key order,
+// if all of them are restricted that way.
+static std::optional<std::vector<::shared_ptr<term>>>
+key_eq_terms(const restrictions::single_column_restrictions::restrictions_map& restrictions, size_t key_size) {
+    std::vector<::shared_ptr<term>> terms(key_size);
+    for (auto&& [def, r] : restrictions) {
+        auto oper = std::get_if<expr::binary_operator>(&r->expression);
+        if (!oper || oper->op != expr::oper_t::EQ || def->id >= key_size || terms[def->id]) {
+            return std::nullopt;
+        }
+        auto cv = std::get_if<expr::column_value>(&oper->lhs);
+        if (!cv || cv->sub) {
+            return std::nullopt;
+        }
+        terms[def->id] = oper->rhs;
+    }
+    if (boost::algorithm::any_of(terms, [] (const ::shared_ptr<term>& t) { return !t; })) {
+        return std::nullopt;
+    }
+    return terms;
+}
+
+std::optional<select_statement::single_row_plan> select_statement::make_single_row_plan() const {
+    if (_restrictions->uses_secondary_indexing() || _restrictions->need_filtering() || _restrictions->is_key_range()
+            || _restrictions->key_is_in_relation() || _parameters->is_distinct() || _per_partition_limit
+            || !_selection->is_trivial() || _selection->is_aggregate() || has_group_by()) {
+        return std::nullopt;
+    }
+    auto pk_restrictions = dynamic_pointer_cast<restrictions::single_column_partition_key_restrictions>(
+            _restrictions->get_partition_key_restrictions());
+    if (!pk_restrictions) {
+        return std::nullopt;
+    }
+    auto pk_terms = key_eq_terms(pk_restrictions->restrictions(), _schema->partition_key_size());
+    if (!pk_terms) {
+        return std::nullopt;
+    }
+    std::vector<::shared_ptr<term>> ck_terms;
+    if (_schema->clustering_key_size()) {
+        auto ck_restrictions = dynamic_pointer_cast<restrictions::single_column_clustering_key_restrictions>(
+                _restrictions->get_clustering_columns_restrictions());
+        if (!ck_restrictions) {
+            return std::nullopt;
+        }
+        auto terms = key_eq_terms(ck_restrictions->restrictions(), _schema->clustering_key_size());
+        if (!terms) {
+            return std::nullopt;
+        }
+        ck_terms = std::move(*terms);
+    }
+
+    single_row_plan plan{std::move(*pk_terms), std::move(ck_terms)};
+    for (auto&& col : _selection->get_columns()) {
+        if (col->is_static()) {
+            plan.static_columns.push_back(col->id);
+        } else if (col->is_regular()) {
+            plan.regular_columns.push_back(col->id);
+        }
+    }
+    return plan;
+}
+
+static bool bind_key_values(const std::vector<::shared_ptr<term>>& terms, const query_options& options, std::vector<bytes>& values) {
+    values.reserve(terms.size());
+    for (auto&& t : terms) {
+        auto value = t->bind_and_get(options);
+        if (!value.is_value()) {
+            return false;
+        }
+        values.push_back(to_bytes(value));
+        if (values.back().empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::optional<std::pair<partition_key, std::optional<clustering_key_prefix>>>
+select_statement::bind_single_row_key(const query_options& options) const {
+    std::vector<bytes> pk_values;
+    if (!bind_key_values(_single_row_plan->partition_key, options, pk_values)) {
+        return std::nullopt;
+    }
+    std::optional<clustering_key_prefix> ck;
+    if (!_single_row_plan->clustering_key.empty()) {
+        std::vector<bytes> ck_values;
+        if (!bind_key_values(_single_row_plan->clustering_key, options, ck_values)) {
+            return std::nullopt;
+        }
+        ck = clustering_key_prefix::from_exploded(*_schema, std::move(ck_values));
+    }
+    return std::pair(partition_key::from_exploded(*_schema, std::move(pk_values)), std::move(ck));
+}
+
 struct select_statement_executor {
     static auto get() { return &select_statement::do_execute; }
 };
@@ -319,6 +480,36 @@ select_statement::do_execute(service::storage_proxy& proxy,
     _stats.select_partition_range_scan += _range_scan;
     _stats.select_partition_range_scan_no_bypass_cache += _range_scan_no_bypass_cache;
 
+    // A single row needs no paging, so it can be read right away. Serial reads
+    // are left to the generic path, which makes sure they run on the right shard.
+    if (_single_row_plan && !db::is_serial_consistency(cl)) {
+        if (auto key = bind_single_row_key(options)) {
+            _stats.unpaged_select_queries(_ks_sel) += options.get_page_size() <= 0;
+            _stats.reverse_queries += _is_reversed;
+            auto&& [pk, ck] = *key;
+            query::clustering_row_ranges bounds{ck
+                    ? query::clustering_range::make_singular(std::move(*ck))
+                    : query::clustering_range::make_open_ended_both_sides()};
+            auto slice = query::partition_slice(std::move(bounds), _single_row_plan->static_columns, _single_row_plan->regular_columns,
+                    _opts, nullptr, options.get_cql_serialization_format());
+            auto max_result_size = proxy.get_max_result_size(slice);
+            auto command = ::make_lw_shared<query::read_command>(
+                    _schema->id(),
+                    _schema->version(),
+                    std::move(slice),
+                    max_result_size,
+                    query::row_limit(limit),
+                    query::partition_limit(query::max_partitions),
+                    now,
+                    tracing::make_trace_info(state.get_trace_state()),
+                    utils::UUID(),
+                    query::is_first_page::no,
+                    options.get_timestamp(state));
+            dht::partition_range_vector key_ranges{dht::partition_range::make_singular(dht::decorate_key(*_schema, std::move(pk)))};
+            return execute(proxy, command, std::move(key_ranges), state, options, now);
+        }
+    }
+
     auto slice = make_partition_slice(options);
     auto command = ::make_lw_shared<query::read_command>(
             _schema->id(),
@@ -369,6 +560,9 @@ select_statement::do_execute(service::storage_proxy& proxy,
     }
 
     command->slice.options.set<query::partition_slice::option::allow_short_read>();
+    if (restrictions_need_filtering && proxy.features().cluster_supports_filtering_pushdown()) {
+        command->slice.set_row_filter(make_row_filter(command->slice, options));
+    }
     auto timeout_duration = options.get_timeout_config().*get_timeout_config_selector();
     auto p = service::pager::query_pagers::pager(_schema, _selection,
             state, options, command, std::move(key_ranges), restrictions_need_filtering ? _restrictions : nullptr);
@@ -404,9 +598,20 @@ select_statement::do_execute(service::storage_proxy& proxy,
                         " you must either remove the ORDER BY or the IN and sort client side, or disable paging for this query");
     }
 
+    // Clients which opted in to page prefetching get the next page read ahead
+    // while they are busy consuming the current one.
+    auto maybe_prefetch = [this, p, page_size, timeout_duration, prefetch = state.get_client_state().is_protocol_extension_set(
+            cql_transport::cql_protocol_extension::PAGE_PREFETCH)] {
+        _stats.select_prefetched_pages_used += p->stats().used_prefetched_page;
+        if (prefetch) {
+            _stats.select_prefetched_pages += p->prefetch_next_page(page_size, timeout_duration);
+        }
+    };
+
     auto timeout = db::timeout_clock::now() + timeout_duration;
     if (_selection->is_trivial() && !restrictions_need_filtering && !_per_partition_limit) {
-        return p->fetch_page_generator(page_size, now, timeout, _stats).then([this, p] (result_generator generator) {
+        return p->fetch_page_generator(page_size, now, timeout, _stats).then([this, p, maybe_prefetch] (result_generator generator) {
+            maybe_prefetch();
             auto meta = [&] () -> shared_ptr<const cql3::metadata> {
                 if (!p->is_exhausted()) {
                     auto meta = make_shared<metadata>(*_selection->get_result_metadata());
@@ -424,7 +629,8 @@ select_statement::do_execute(service::storage_proxy& proxy,
     }
 
     return p->fetch_page(page_size, now, timeout).then(
-            [this, p, &options, now, restrictions_need_filtering](std::unique_ptr<cql3::result_set> rs) {
+            [this, p, &options, now, restrictions_need_filtering, maybe_prefetch](std::unique_ptr<cql3::result_set> rs) {
+                maybe_prefetch();
 
                 if (!p->is_exhausted()) {
                     rs->get_metadata().set_paging_state(p->state());
@@ -96,6 +96,17 @@ class select_statement : public cql_statement {
     const ks_selector _ks_sel;
     bool _range_scan = false;
     bool _range_scan_no_bypass_cache = false;
+
+    // How to read a single row selected by equalities on its whole primary key,
+    // worked out when the statement is prepared, so that executing it does not
+    // go through the restrictions, the slice builder or the pager.
+    struct single_row_plan {
+        std::vector<::shared_ptr<term>> partition_key;
+        std::vector<::shared_ptr<term>> clustering_key;
+        query::column_id_vector static_columns;
+        query::column_id_vector regular_columns;
+    };
+    std::optional<single_row_plan> _single_row_plan;
 protected :
     virtual future<::shared_ptr<cql_transport::messages::result_message>> do_execute(service::storage_proxy& proxy,
         service::query_state& state, const query_options& options) const;
@@ -141,8 +152,19 @@ protected :
 
     const sstring& column_family() const;
 
+    const schema_ptr& get_schema() const {
+        return _schema;
+    }
+
+    const selection::selection& get_selection() const {
+        return *_selection;
+    }
+
     query::partition_slice make_partition_slice(const query_options& options) const;
 
+    // Restrictions which replicas can check while reading, see query::row_filter.
+    query::row_filter make_row_filter(const query::partition_slice& slice, const query_options& options) const;
+
     ::shared_ptr<restrictions::statement_restrictions> get_restrictions() const;
 
     bool has_group_by() const { return _group_by_cell_indices && !_group_by_cell_indices->empty(); }
@@ -156,6 +178,10 @@ protected :
         return do_get_limit(options, _per_partition_limit, query::partition_max_rows);
     }
     bool needs_post_query_ordering() const;
+    std::optional<single_row_plan> make_single_row_plan() const;
+    // The key of the row read by the single row plan, or std::nullopt if a key
+    // value is null, unset or empty, which is left for the restrictions to handle.
+    std::optional<std::pair<partition_key, std::optional<clustering_key_prefix>>> bind_single_row_key(const query_options& options) const;
     virtual void update_stats_rows_read(int64_t rows_read) const {
         _stats.rows_read += rows_read;
     }
@@ -103,6 +103,14 @@ class term : public ::enable_shared_from_this<term> {
 
     virtual bool uses_function(const sstring& ks_name, const sstring& function_name) const = 0;
 
+    /**
+     * Whether the term always binds to the same value for the same bound values.
+     * Calls of non pure and user-defined functions may not.
+     */
+    virtual bool is_pure() const {
+        return true;
+    }
+
     virtual sstring to_string() const {
         return format("term@{:p}", static_cast<const void*>(this));
     }
@@ -151,6 +151,10 @@ class tuples {
             return std::any_of(_elements.begin(), _elements.end(), std::mem_fn(&term::contains_bind_marker));
         }
 
+        virtual bool is_pure() const override {
+            return std::all_of(_elements.begin(), _elements.end(), std::mem_fn(&term::is_pure));
+        }
+
         virtual void collect_marker_specification(variable_specifications& bound_names) const override {
             for (auto&& term : _elements) {
                 term->collect_marker_specification(bound_names);
@@ -185,6 +185,9 @@ bool user_types::delayed_value::uses_function(const sstring& ks_name, const sstr
     return boost::algorithm::any_of(_values,
                 std::bind(&term::uses_function, std::placeholders::_1, std::cref(ks_name), std::cref(function_name)));
 }
+bool user_types::delayed_value::is_pure() const {
+    return boost::algorithm::all_of(_values, std::mem_fn(&term::is_pure));
+}
 bool user_types::delayed_value::contains_bind_marker() const {
     return boost::algorithm::any_of(_values, std::mem_fn(&term::contains_bind_marker));
 }
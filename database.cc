@@ -398,6 +398,12 @@ database::setup_metrics() {
         sm::make_derive("querier_cache_drops", _querier_cache.get_stats().drops,
                        sm::description("Counts querier cache lookups that found a cached querier but had to drop it due to position mismatch")),
 
+        sm::make_derive("querier_cache_schema_version_drops", _querier_cache.get_stats().schema_version_drops,
+                       sm::description("Counts querier cache drops caused by a schema version mismatch")),
+
+        sm::make_derive("querier_cache_position_drops", _querier_cache.get_stats().position_drops,
+                       sm::description("Counts querier cache drops caused by a ring or clustering position mismatch")),
+
         sm::make_derive("querier_cache_time_based_evictions", _querier_cache.get_stats().time_based_evictions,
                        sm::description("Counts querier cache entries that timed out and were evicted.")),
 
@@ -409,6 +415,10 @@ database::setup_metrics() {
                        sm::description("Counts querier cache entries that were evicted because the memory usage "
                                        "of the cached queriers were above the limit.")),
 
+        sm::make_derive("querier_cache_table_budget_evictions", _querier_cache.get_stats().table_budget_evictions,
+                       sm::description("Counts querier cache memory based evictions of entries belonging to a table "
+                                       "which used more than its share of the cache memory.")),
+
         sm::make_gauge("querier_cache_population", _querier_cache.get_stats().population,
                        sm::description("The number of entries currently in the querier cache.")),
 
@@ -531,6 +541,9 @@ database::setup_metrics() {
 
         sm::make_total_operations("total_view_updates_failed_remote", _cf_stats.total_view_updates_failed_remote,
                 sm::description("Total number of view updates generated for tables and failed to be sent to remote replicas.")),
+
+        sm::make_total_operations("total_view_updates_read_before_write_skipped", _cf_stats.total_view_updates_read_before_write_skipped,
+                sm::description("Total number of view update read-before-writes skipped because the base partition did not exist.")),
     });
     if (this_shard_id() == 0) {
         _metrics.add_group("database", {
@@ -930,6 +943,7 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.enable_cache = _config.enable_cache;
     cfg.enable_dangerous_direct_import_of_cassandra_counters = _config.enable_dangerous_direct_import_of_cassandra_counters;
     cfg.compaction_enforce_min_threshold = _config.compaction_enforce_min_threshold;
+    cfg.view_update_skip_read_of_absent_partitions = _config.view_update_skip_read_of_absent_partitions;
     cfg.dirty_memory_manager = _config.dirty_memory_manager;
     cfg.streaming_dirty_memory_manager = _config.streaming_dirty_memory_manager;
     cfg.streaming_read_concurrency_semaphore = _config.streaming_read_concurrency_semaphore;
@@ -1489,6 +1503,7 @@ future<> database::apply_in_memory(const frozen_mutation& m, schema_ptr m_schema
 
     return cf.dirty_memory_region_group().run_when_memory_available([this, &m, m_schema = std::move(m_schema), h = std::move(h), &cf]() mutable {
         cf.apply(m, m_schema, std::move(h));
+        data_listeners().on_applied(m_schema, m);
     }, timeout);
 }
 
@@ -1647,6 +1662,7 @@ database::make_keyspace_config(const keyspace_metadata& ksm) {
     }
     cfg.enable_dangerous_direct_import_of_cassandra_counters = _cfg.enable_dangerous_direct_import_of_cassandra_counters();
     cfg.compaction_enforce_min_threshold = _cfg.compaction_enforce_min_threshold;
+    cfg.view_update_skip_read_of_absent_partitions = _cfg.view_update_skip_read_of_absent_partitions;
     cfg.dirty_memory_manager = &_dirty_memory_manager;
     cfg.streaming_dirty_memory_manager = &_streaming_dirty_memory_manager;
     cfg.streaming_read_concurrency_semaphore = &_streaming_concurrency_sem;
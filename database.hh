@@ -318,6 +318,10 @@ struct cf_stats {
     // How many view updates were dropped due to overload.
     int64_t dropped_view_updates = 0;
 
+    // How many view update read-before-writes were skipped because the base
+    // partition was provably absent.
+    uint64_t total_view_updates_read_before_write_skipped = 0;
+
     // How many times view building was paused (e.g. due to node unavailability)
     int64_t view_building_paused = 0;
 
@@ -375,6 +379,7 @@ class table : public enable_lw_shared_from_this<table> {
         bool enable_commitlog = true;
         bool enable_incremental_backups = false;
         utils::updateable_value<bool> compaction_enforce_min_threshold{false};
+        utils::updateable_value<bool> view_update_skip_read_of_absent_partitions{true};
         bool enable_dangerous_direct_import_of_cassandra_counters = false;
         ::dirty_memory_manager* dirty_memory_manager = &default_dirty_memory_manager;
         ::dirty_memory_manager* streaming_dirty_memory_manager = &default_dirty_memory_manager;
@@ -449,6 +454,10 @@ class table : public enable_lw_shared_from_this<table> {
     // sstables that should not be compacted (e.g. because they need to be used
     // to generate view updates later)
     std::unordered_map<uint64_t, sstables::shared_sstable> _sstables_staging;
+    // Estimated number of partitions and rows in _sstables, kept up to date
+    // as sstables are added and removed.
+    uint64_t _sstables_estimated_partitions = 0;
+    uint64_t _sstables_estimated_rows = 0;
     // Control background fibers waiting for sstables to be deleted
     seastar::gate _sstable_deletion_gate;
     // This semaphore ensures that an operation like snapshot won't have its selected
@@ -846,6 +855,15 @@ class table : public enable_lw_shared_from_this<table> {
 
     const sstables::sstable_set& get_sstable_set() const;
     lw_shared_ptr<const sstable_list> get_sstables() const;
+    // Estimated number of partitions and rows in the sstables of this table
+    // on this shard. Rows are only known for sstables in the 3.x formats;
+    // each partition of older sstables is counted as a single row.
+    uint64_t estimated_sstable_partitions() const {
+        return _sstables_estimated_partitions;
+    }
+    uint64_t estimated_sstable_rows() const {
+        return _sstables_estimated_rows;
+    }
     lw_shared_ptr<const sstable_list> get_sstables_including_compacted_undeleted() const;
     const std::vector<sstables::shared_sstable>& compacted_undeleted_sstables() const;
     std::vector<sstables::shared_sstable> select_sstables(const dht::partition_range& range) const;
@@ -972,8 +990,12 @@ class table : public enable_lw_shared_from_this<table> {
 
 private:
     future<row_locker::lock_holder> do_push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout, mutation_source&& source,
-            tracing::trace_state_ptr tr_state, reader_concurrency_semaphore& sem, const io_priority_class& io_priority, query::partition_slice::option_set custom_opts) const;
+            std::vector<sstables::shared_sstable> excluded_sstables, tracing::trace_state_ptr tr_state, reader_concurrency_semaphore& sem, const io_priority_class& io_priority, query::partition_slice::option_set custom_opts) const;
     std::vector<view_ptr> affected_views(const schema_ptr& base, const mutation& update, gc_clock::time_point now) const;
+    // Returns false only if the partition is known not to exist in any memtable
+    // or sstable of this table, other than excluded_sstables. Used to avoid
+    // view update read-before-writes.
+    bool may_contain_partition(const dht::decorated_key& key, const std::vector<sstables::shared_sstable>& excluded_sstables) const;
     future<> generate_and_propagate_view_updates(const schema_ptr& base,
             std::vector<db::view::view_and_base>&& views,
             mutation&& m,
@@ -1128,6 +1150,7 @@ class keyspace {
         bool enable_cache = true;
         bool enable_incremental_backups = false;
         utils::updateable_value<bool> compaction_enforce_min_threshold{false};
+        utils::updateable_value<bool> view_update_skip_read_of_absent_partitions{true};
         bool enable_dangerous_direct_import_of_cassandra_counters = false;
         ::dirty_memory_manager* dirty_memory_manager = &default_dirty_memory_manager;
         ::dirty_memory_manager* streaming_dirty_memory_manager = &default_dirty_memory_manager;
@@ -563,6 +563,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "\tYour own RPC server: You must provide a fully-qualified class name of an o.a.c.t.TServerFactory that can create a server instance.")
     , cache_hit_rate_read_balancing(this, "cache_hit_rate_read_balancing", value_status::Used, true,
         "This boolean controls whether the replicas for read query will be choosen based on cache hit ratio")
+    , latency_aware_read_balancing(this, "latency_aware_read_balancing", liveness::LiveUpdate, value_status::Used, true,
+        "This boolean controls whether the replicas of the local datacenter are ordered for reads by their observed latency and number of outstanding requests, "
+        "and whether speculative retry fires immediately when one of the chosen replicas is expected to be much slower than the speculative retry delay")
+    , read_repair_row_summaries(this, "read_repair_row_summaries", liveness::LiveUpdate, value_status::Used, true,
+        "When a single-partition read returning many rows detects a digest mismatch, first ask the replicas for per-row hashes and repair only the rows they disagree on, "
+        "instead of transferring the whole result from every replica")
     /* Advanced fault detection settings */
     /* Settings to handle poorly performing or failing nodes. */
     , dynamic_snitch_badness_threshold(this, "dynamic_snitch_badness_threshold", value_status::Unused, 0,
@@ -714,6 +720,9 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
+    , view_update_skip_read_of_absent_partitions(this, "view_update_skip_read_of_absent_partitions", liveness::LiveUpdate, value_status::Used, true,
+        "When generating view updates, skip the read-before-write of the base partition if it is provably absent "
+        "(not present in any memtable and rejected by the bloom filters of all sstables). Speeds up insert-only workloads with unique keys.")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Used, true, "Enable SSTables 'mc' format to be used as the default file format")
     , enable_sstables_md_format(this, "enable_sstables_md_format", value_status::Used, true, "Enable SSTables 'md' format to be used as the default file format (requires enable_sstables_mc_format)")
     , enable_dangerous_direct_import_of_cassandra_counters(this, "enable_dangerous_direct_import_of_cassandra_counters", value_status::Used, false, "Only turn this option on if you want to import tables from Cassandra containing counters, and you are SURE that no counters in that table were created in a version earlier than Cassandra 2.1."
@@ -39,8 +39,18 @@ void data_listeners::uninstall(data_listener* listener) {
     _listeners.erase(listener);
 }
 
+void data_listeners::install_write_listener(data_listener* listener) {
+    _write_listeners.emplace(listener);
+    dblog.debug("data_listeners: install write listener {}", listener);
+}
+
+void data_listeners::uninstall_write_listener(data_listener* listener) {
+    dblog.debug("data_listeners: uninstall write listener {}", listener);
+    _write_listeners.erase(listener);
+}
+
 bool data_listeners::exists(data_listener* listener) const {
-    return _listeners.contains(listener);
+    return _listeners.contains(listener) || _write_listeners.contains(listener);
 }
 
 flat_mutation_reader data_listeners::on_read(const schema_ptr& s, const dht::partition_range& range,
@@ -55,6 +65,27 @@ void data_listeners::on_write(const schema_ptr& s, const frozen_mutation& m) {
     for (auto&& li : _listeners) {
         li->on_write(s, m);
     }
+    for (auto&& li : _write_listeners) {
+        li->on_write(s, m);
+    }
+}
+
+void data_listeners::on_applied(const schema_ptr& s, const frozen_mutation& m) {
+    for (auto&& li : _listeners) {
+        li->on_applied(s, m);
+    }
+    for (auto&& li : _write_listeners) {
+        li->on_applied(s, m);
+    }
+}
+
+void data_listeners::on_invalidated(const schema_ptr& s) {
+    for (auto&& li : _listeners) {
+        li->on_invalidated(s);
+    }
+    for (auto&& li : _write_listeners) {
+        li->on_invalidated(s);
+    }
 }
 
 toppartitions_item_key::operator sstring() const {
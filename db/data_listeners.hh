@@ -44,6 +44,15 @@ class data_listener {
     // The schema_ptr passed is the one which corresponds to the incoming mutation, not the current schema of the table.
     virtual void on_write(const schema_ptr&, const frozen_mutation&) { }
 
+    // Invoked for each write once it is applied to the memtable, with partition granularity.
+    // Unlike in on_write(), reads started from here on see the write.
+    virtual void on_applied(const schema_ptr&, const frozen_mutation&) { }
+
+    // Invoked when data of the table changes other than by writes, e.g. when it is
+    // truncated, or gets sstables from streaming or repair. Reads started from here
+    // on see the change.
+    virtual void on_invalidated(const schema_ptr&) { }
+
     // Invoked for each query (both data query and mutation query) when a mutation reader is created.
     // Paging queries may invoke this once for a page, or less often, depending on whether they hit in the querier cache or not.
     //
@@ -61,18 +70,25 @@ class data_listener {
 class data_listeners {
     database& _db;
     std::set<data_listener*> _listeners;
+    // Listeners which only observe writes. They don't make reads go through on_read().
+    std::set<data_listener*> _write_listeners;
 
 public:
     data_listeners(database& db) : _db(db) {}
 
     void install(data_listener* listener);
     void uninstall(data_listener* listener);
+    void install_write_listener(data_listener* listener);
+    void uninstall_write_listener(data_listener* listener);
 
     flat_mutation_reader on_read(const schema_ptr& s, const dht::partition_range& range,
             const query::partition_slice& slice, flat_mutation_reader&& rd);
     void on_write(const schema_ptr& s, const frozen_mutation& m);
+    void on_applied(const schema_ptr& s, const frozen_mutation& m);
+    void on_invalidated(const schema_ptr& s);
 
     bool exists(data_listener* listener) const;
+    // Whether no listener observes reads.
     bool empty() const { return _listeners.empty(); }
 };
 
@@ -2056,7 +2056,9 @@ future<std::vector<view_build_progress>> load_view_build_progress() {
 
 future<service::paxos::paxos_state> load_paxos_state(partition_key_view key, schema_ptr s, gc_clock::time_point now,
         db::timeout_clock::time_point timeout) {
-    static auto cql = format("SELECT * FROM system.{} WHERE row_key = ? AND cf_id = ?", PAXOS);
+    static auto cql = format("SELECT promise, TTL(promise) AS promise_ttl, proposal, proposal_ballot, TTL(proposal_ballot) AS proposal_ttl,"
+            " most_recent_commit, most_recent_commit_at, TTL(most_recent_commit_at) AS most_recent_commit_ttl"
+            " FROM system.{} WHERE row_key = ? AND cf_id = ?", PAXOS);
     // FIXME: we need execute_cql_with_now()
     (void)now;
     auto f = execute_cql_with_timeout(cql, timeout, to_legacy(*key.get_compound_type(*s), key.representation()), s->id());
@@ -2065,6 +2067,12 @@ future<service::paxos::paxos_state> load_paxos_state(partition_key_view key, sch
             return service::paxos::paxos_state();
         }
         auto& row = results->one();
+        auto now = gc_clock::now();
+        auto expiry = [&] (const sstring& ttl_column) {
+            // Cells written without a TTL have none.
+            return row.has(ttl_column) ? now + std::chrono::seconds(row.get_as<int32_t>(ttl_column)) : gc_clock::time_point::max();
+        };
+        service::paxos::paxos_state::cell_expiry cells_expiry{expiry("promise_ttl"), expiry("proposal_ttl"), expiry("most_recent_commit_ttl")};
         auto promised = row.has("promise")
                         ? row.get_as<utils::UUID>("promise") : utils::UUID_gen::min_time_UUID(0);
 
@@ -2085,7 +2093,7 @@ future<service::paxos::paxos_state> load_paxos_state(partition_key_view key, sch
                     std::move(fm));
         }
 
-        return service::paxos::paxos_state(promised, std::move(accepted), std::move(most_recent));
+        return service::paxos::paxos_state(promised, std::move(accepted), std::move(most_recent), cells_expiry);
     });
 }
 
@@ -41,6 +41,7 @@
 
 #include <deque>
 #include <functional>
+#include <map>
 #include <optional>
 #include <unordered_set>
 #include <vector>
@@ -51,6 +52,7 @@
 #include <boost/range/adaptors.hpp>
 
 #include <seastar/core/future-util.hh>
+#include <seastar/core/shared_future.hh>
 
 #include "database.hh"
 #include "clustering_bounds_comparator.hh"
@@ -58,6 +60,7 @@
 #include "cql3/util.hh"
 #include "db/view/view.hh"
 #include "db/view/view_builder.hh"
+#include "db/view/view_update_coalescer.hh"
 #include "db/view/view_updating_consumer.hh"
 #include "db/system_keyspace_view_types.hh"
 #include "db/system_keyspace.hh"
@@ -181,6 +184,8 @@ void stats::register_stats() {
                     {_cf_label, _ks_label}),
             ms::make_total_operations("view_updates_failed_local", view_updates_failed_local, ms::description("Number of updates (mutations) that failed to be pushed to local view replicas"),
                     {_cf_label, _ks_label}),
+            ms::make_total_operations("view_updates_coalesced", view_updates_coalesced, ms::description("Number of updates (mutations) merged into another pending update to the same view partition"),
+                    {_cf_label, _ks_label}),
             ms::make_gauge("view_updates_pending", ms::description("Number of updates pushed to view and are still to be completed"),
                     {_cf_label, _ks_label}, writes),
     });
@@ -1110,6 +1115,58 @@ static future<> apply_to_remote_endpoints(gms::inet_address target, std::vector<
             allow_hints);
 }
 
+bool view_update_coalescer::can_merge(const pending_update& u, const frozen_mutation_and_schema& mut,
+        const std::vector<gms::inet_address>& pending_endpoints, service::allow_hints allow_hints) {
+    return u.allow_hints == allow_hints
+            && u.pending_endpoints == pending_endpoints
+            && u.mut.fm.key().equal(*mut.s, mut.fm.key());
+}
+
+void view_update_coalescer::flush() {
+    auto pending = std::exchange(_pending, {});
+    for (auto& [k, updates] : pending) {
+        for (auto& u : updates) {
+            if (u.merged) {
+                u.mut.fm = freeze(*u.merged);
+            }
+            (void)_send(k.target, std::move(u.pending_endpoints), u.mut, u.base_token, k.view_token,
+                    u.allow_hints, nullptr).then_wrapped([done = std::move(u.done)] (future<>&& f) {
+                if (f.failed()) {
+                    done->set_exception(f.get_exception());
+                } else {
+                    done->set_value();
+                }
+            });
+        }
+    }
+}
+
+future<> view_update_coalescer::send(gms::inet_address target, std::vector<gms::inet_address> pending_endpoints,
+        frozen_mutation_and_schema mut, const dht::token& base_token, const dht::token& view_token,
+        service::allow_hints allow_hints, tracing::trace_state_ptr tr_state, stats& stats) {
+    if (tr_state) {
+        return _send(target, std::move(pending_endpoints), mut, base_token, view_token, allow_hints, std::move(tr_state));
+    }
+    if (_pending.empty()) {
+        (void)later().then([this] { flush(); });
+    }
+    auto& updates = _pending[key{mut.s->version(), target, view_token}];
+    for (auto& u : updates) {
+        if (can_merge(u, mut, pending_endpoints, allow_hints)) {
+            if (!u.merged) {
+                u.merged = u.mut.fm.unfreeze(u.mut.s);
+            }
+            u.merged->apply(mut.fm.unfreeze(mut.s));
+            ++stats.view_updates_coalesced;
+            return u.done->get_shared_future();
+        }
+    }
+    updates.push_back(pending_update{std::move(mut), std::nullopt, std::move(pending_endpoints), base_token, allow_hints, make_lw_shared<shared_promise<>>()});
+    return updates.back().done->get_shared_future();
+}
+
+static thread_local view_update_coalescer the_view_update_coalescer(apply_to_remote_endpoints);
+
 // Take the view mutations generated by generate_view_updates(), which pertain
 // to a modification of a single base partition, and apply them to the
 // appropriate paired replicas. This is done asynchronously - we do not wait
@@ -1206,7 +1263,13 @@ future<> mutate_MV(
             size_t updates_pushed_remote = remote_endpoints.size() + 1;
             stats.view_updates_pushed_remote += updates_pushed_remote;
             cf_stats.total_view_updates_pushed_remote += updates_pushed_remote;
-            future<> view_update = apply_to_remote_endpoints(*target_endpoint, std::move(remote_endpoints), mut, base_token, view_token, allow_hints, tr_state).then_wrapped(
+            // Updates sent in the background can wait for the current task to
+            // yield, and be coalesced with other updates to the same view partition.
+            // Foreground updates (view building) are already batched per partition.
+            future<> send_f = wait_for_all
+                    ? apply_to_remote_endpoints(*target_endpoint, std::move(remote_endpoints), mut, base_token, view_token, allow_hints, tr_state)
+                    : the_view_update_coalescer.send(*target_endpoint, std::move(remote_endpoints), std::move(mut), base_token, view_token, allow_hints, tr_state, stats);
+            future<> view_update = std::move(send_f).then_wrapped(
                     [target_endpoint,
                      updates_pushed_remote,
                      maybe_account_failure = std::move(maybe_account_failure)] (future<>&& f) mutable {
@@ -1838,11 +1901,12 @@ class view_builder::consumer {
             auto views = with_base_info_snapshot(_views_to_build);
             auto reader = make_flat_mutation_reader_from_fragments(_step.reader.schema(), std::move(_fragments));
             reader.upgrade_schema(base_schema);
-            _step.base->populate_views(
+            _step.pending_view_updates.push_back(_step.base->populate_views(
                     std::move(views),
                     _step.current_token(),
                     std::move(reader),
-                    _now).get();
+                    _now));
+            _builder.wait_for_pending_view_updates(_step, _builder.view_update_concurrency() - 1);
             _fragments.clear();
             _fragments_memory_usage = 0;
         }
@@ -1887,7 +1951,29 @@ void view_builder::execute(build_step& step, exponential_backoff_retry r) {
             query::max_partitions,
             view_builder::consumer{*this, step, now});
     consumer.consume_new_partition(step.current_key); // Initialize the state in case we're resuming a partition
-    auto built = step.reader.consume_in_thread(std::move(consumer), db::no_timeout);
+    // The view updates of the step are acknowledged out of band, so a failure
+    // may concern a partition before the current one. Keep the state the step
+    // started with, so that the whole step can be redone in that case.
+    auto start_key = step.current_key;
+    auto start_build_status = step.build_status;
+    auto built = [&] {
+        try {
+            auto built = step.reader.consume_in_thread(std::move(consumer), db::no_timeout);
+            // The progress of the step can only be recorded after all its
+            // view updates were acknowledged.
+            wait_for_pending_view_updates(step, 0);
+            return built;
+        } catch (...) {
+            for (auto& f : step.pending_view_updates) {
+                f.wait();
+                f.ignore_ready_future();
+            }
+            step.pending_view_updates.clear();
+            step.current_key = std::move(start_key);
+            step.build_status = std::move(start_build_status);
+            throw;
+        }
+    }();
 
     _as.check();
 
@@ -1908,6 +1994,20 @@ void view_builder::execute(build_step& step, exponential_backoff_retry r) {
     }).get();
 }
 
+size_t view_builder::view_update_concurrency() const {
+    auto backlog = std::min(_db.get_view_update_backlog().relative_size(), 1.0f);
+    return std::max(size_t(1), size_t(max_view_update_concurrency * (1.0f - backlog)));
+}
+
+// Called in the context of a seastar::thread.
+void view_builder::wait_for_pending_view_updates(build_step& step, size_t max_pending) {
+    while (step.pending_view_updates.size() > max_pending) {
+        auto f = std::move(step.pending_view_updates.front());
+        step.pending_view_updates.pop_front();
+        f.get();
+    }
+}
+
 future<> view_builder::maybe_mark_view_as_built(view_ptr view, dht::token next_token) {
     _built_views.emplace(view->id());
     vlogger.debug("Shard finished building view {}.{}", view->ks_name(), view->cf_name());
@@ -41,6 +41,7 @@
 #include <seastar/core/shared_future.hh>
 #include <seastar/core/shared_ptr.hh>
 
+#include <deque>
 #include <optional>
 #include <unordered_map>
 #include <vector>
@@ -66,9 +67,11 @@ namespace db::view {
  * from one reader. We also strive for fairness, in that each build step inserts entries for
  * the views of a different base. Each build step reads and generates updates for batch_size rows.
  *
- * We lack a controller, which could potentially allow us to go faster (to execute multiple steps at
- * the same time, or consume more rows per batch), and also which would apply backpressure, so we
- * could, for example, delay executing a build step.
+ * A build step doesn't wait for the view updates of a batch to be acknowledged before reading the
+ * next one. Up to view_update_concurrency() batches can be in flight; that number shrinks as the
+ * view update backlog of the node grows, so that building backs off when foreground writes are
+ * generating view updates too. All updates of a step are acknowledged before its progress is
+ * recorded.
  *
  * View building is necessarily a sharded process. That means that on restart, if the number of shards
  * has changed, we need to calculate the most conservative token range that has been built, and build
@@ -141,6 +144,8 @@ class view_builder final : public service::migration_listener::only_view_notific
         flat_mutation_reader reader{nullptr};
         dht::decorated_key current_key{dht::minimum_token(), partition_key::make_empty()};
         std::vector<view_build_status> build_status;
+        // View updates generated by this step which were not acknowledged yet, oldest first.
+        std::deque<future<>> pending_view_updates;
 
         const dht::token& current_token() const {
             return current_key.token();
@@ -185,6 +190,8 @@ class view_builder final : public service::migration_listener::only_view_notific
     // collected batch_memory_max bytes, we can process the rows read so far.
     static constexpr size_t batch_size = 128;
     static constexpr size_t batch_memory_max = 1024*1024;
+    // Maximum number of batches whose view updates may be in flight at once, per shard.
+    static constexpr size_t max_view_update_concurrency = 8;
 
 public:
     view_builder(database&, db::system_distributed_keyspace&, service::migration_notifier&);
@@ -219,6 +226,8 @@ class view_builder final : public service::migration_listener::only_view_notific
     future<> add_new_view(view_ptr, build_step&);
     future<> do_build_step();
     void execute(build_step&, exponential_backoff_retry);
+    size_t view_update_concurrency() const;
+    void wait_for_pending_view_updates(build_step&, size_t max_pending);
     future<> maybe_mark_view_as_built(view_ptr, dht::token);
     void setup_metrics();
 
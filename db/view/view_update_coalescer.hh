@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <vector>
+
+#include <seastar/core/shared_future.hh>
+#include <seastar/util/noncopyable_function.hh>
+
+#include "db/view/view_stats.hh"
+#include "dht/token.hh"
+#include "frozen_mutation.hh"
+#include "gms/inet_address.hh"
+#include "mutation.hh"
+#include "service/storage_proxy.hh"
+#include "tracing/trace_state.hh"
+
+namespace db::view {
+
+// Coalesces background view updates which are bound for the same view
+// partition and the same set of endpoints. Updates queued until the
+// current task yields are merged into a single mutation, so that a hot
+// view partition (e.g. a view keyed by a low-cardinality base column)
+// receives one write per window instead of one write per base update.
+// The future returned for every merged update resolves when the merged
+// write completes, so the backlog units its caller holds until then are
+// accounted for as before.
+//
+// Traced updates are sent on their own, so that each keeps its trace and
+// base token.
+class view_update_coalescer {
+public:
+    using send_function = noncopyable_function<future<>(gms::inet_address target, std::vector<gms::inet_address>&& pending_endpoints,
+            frozen_mutation_and_schema& mut, const dht::token& base_token, const dht::token& view_token,
+            service::allow_hints allow_hints, tracing::trace_state_ptr tr_state)>;
+private:
+    struct key {
+        table_schema_version version;
+        gms::inet_address target;
+        dht::token view_token;
+
+        bool operator<(const key& o) const {
+            return std::tie(version, target, view_token) < std::tie(o.version, o.target, o.view_token);
+        }
+    };
+    struct pending_update {
+        frozen_mutation_and_schema mut;
+        std::optional<mutation> merged;
+        std::vector<gms::inet_address> pending_endpoints;
+        dht::token base_token;
+        service::allow_hints allow_hints;
+        lw_shared_ptr<shared_promise<>> done;
+    };
+    send_function _send;
+    std::map<key, std::vector<pending_update>> _pending;
+private:
+    static bool can_merge(const pending_update& u, const frozen_mutation_and_schema& mut,
+            const std::vector<gms::inet_address>& pending_endpoints, service::allow_hints allow_hints);
+    void flush();
+public:
+    explicit view_update_coalescer(send_function send) : _send(std::move(send)) { }
+
+    // Queues the view update for sending to target (and pending_endpoints).
+    // The returned future resolves when the (possibly merged) write completes.
+    future<> send(gms::inet_address target, std::vector<gms::inet_address> pending_endpoints,
+            frozen_mutation_and_schema mut, const dht::token& base_token, const dht::token& view_token,
+            service::allow_hints allow_hints, tracing::trace_state_ptr tr_state, stats& stats);
+};
+
+}
@@ -20,6 +20,8 @@
  */
 
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+#include <boost/range/numeric.hpp>
 #include "view_update_generator.hh"
 #include "service/priority_manager.hh"
 #include "utils/error_injection.hh"
@@ -33,10 +35,74 @@ static inline void inject_failure(std::string_view operation) {
 
 namespace db::view {
 
+// Called in the context of a seastar::thread.
+void view_update_generator::process_staging_sstables(lw_shared_ptr<table> t, std::vector<sstables::shared_sstable> sstables) {
+    schema_ptr s = t->schema();
+
+    vug_logger.trace("Processing {}.{}: {} sstables", s->ks_name(), s->cf_name(), sstables.size());
+
+    const auto num_sstables = sstables.size();
+    const auto data_size = boost::accumulate(sstables | boost::adaptors::transformed(std::mem_fn(&sstables::sstable::data_size)), uint64_t(0));
+
+    try {
+        // Exploit the fact that sstables in the staging directory
+        // are usually non-overlapping and use a partitioned set for
+        // the read.
+        auto ssts = make_lw_shared<sstables::sstable_set>(sstables::make_partitioned_sstable_set(s, make_lw_shared<sstable_list>(sstable_list{}), false));
+        for (auto& sst : sstables) {
+            ssts->insert(sst);
+        }
+
+        auto ms = mutation_source([this, ssts] (
+                    schema_ptr s,
+                    reader_permit permit,
+                    const dht::partition_range& pr,
+                    const query::partition_slice& ps,
+                    const io_priority_class& pc,
+                    tracing::trace_state_ptr ts,
+                    streamed_mutation::forwarding fwd_ms,
+                    mutation_reader::forwarding fwd_mr) {
+            return ::make_restricted_range_sstable_reader(s, std::move(permit), std::move(ssts), pr, ps, pc, std::move(ts), fwd_ms, fwd_mr);
+        });
+        auto [staging_sstable_reader, staging_sstable_reader_handle] = make_manually_paused_evictable_reader(
+                std::move(ms),
+                s,
+                _db.get_reader_concurrency_semaphore().make_permit(),
+                query::full_partition_range,
+                s->full_slice(),
+                service::get_local_streaming_priority(),
+                nullptr,
+                ::mutation_reader::forwarding::no);
+
+        inject_failure("view_update_generator_consume_staging_sstable");
+        auto result = staging_sstable_reader.consume_in_thread(view_updating_consumer(s, *t, sstables, _as, staging_sstable_reader_handle), db::no_timeout);
+        if (result == stop_iteration::yes) {
+            return;
+        }
+    } catch (...) {
+        vug_logger.warn("Processing {} failed for table {}:{}. Will retry...", s->ks_name(), s->cf_name(), std::current_exception());
+        // Need to add sstables back to the set so we can retry later. By now it may
+        // have had other updates.
+        std::move(sstables.begin(), sstables.end(), std::back_inserter(_sstables_with_tables[t]));
+        return;
+    }
+    _stats.sstables_processed += num_sstables;
+    _stats.bytes_processed += data_size;
+    try {
+        inject_failure("view_update_generator_collect_consumed_sstables");
+        // collect all staging sstables to move in a map, grouped by table.
+        std::move(sstables.begin(), sstables.end(), std::back_inserter(_sstables_to_move[t]));
+    } catch (...) {
+        // Move from staging will be retried upon restart.
+        vug_logger.warn("Moving {} from staging failed: {}:{}. Ignoring...", s->ks_name(), s->cf_name(), std::current_exception());
+    }
+    _registration_sem.signal(num_sstables);
+}
+
 future<> view_update_generator::start() {
     thread_attributes attr;
     attr.sched_group = _db.get_streaming_scheduling_group();
-    _started = seastar::async(std::move(attr), [this]() mutable {
+    _started = seastar::async(attr, [this, attr]() mutable {
         while (!_as.abort_requested()) {
             if (_sstables_with_tables.empty()) {
                 _pending_sstables.wait().get();
@@ -45,69 +111,29 @@ future<> view_update_generator::start() {
             // To ensure we don't race with updates, move the entire content
             // into a local variable.
             auto sstables_with_tables = std::exchange(_sstables_with_tables, {});
+            _sstables_in_progress = boost::accumulate(sstables_with_tables | boost::adaptors::map_values
+                    | boost::adaptors::transformed(std::mem_fn(&std::vector<sstables::shared_sstable>::size)), size_t(0));
 
             // If we got here, we will process all tables we know about so far eventually so there
-            // is no starvation
-            for (auto table_it = sstables_with_tables.begin(); table_it != sstables_with_tables.end(); table_it = sstables_with_tables.erase(table_it)) {
-                auto& [t, sstables] = *table_it;
-                schema_ptr s = t->schema();
-
-                vug_logger.trace("Processing {}.{}: {} sstables", s->ks_name(), s->cf_name(), sstables.size());
-
-                const auto num_sstables = sstables.size();
-
-                try {
-                    // Exploit the fact that sstables in the staging directory
-                    // are usually non-overlapping and use a partitioned set for
-                    // the read.
-                    auto ssts = make_lw_shared<sstables::sstable_set>(sstables::make_partitioned_sstable_set(s, make_lw_shared<sstable_list>(sstable_list{}), false));
-                    for (auto& sst : sstables) {
-                        ssts->insert(sst);
+            // is no starvation. Tables are processed concurrently, as long as their consumers'
+            // buffers fit in the memory budget.
+            parallel_for_each(sstables_with_tables, [this, &attr] (auto& table_and_sstables) {
+                return get_units(_memory_sem, view_updating_consumer::buffer_size_hard_limit).then([this, &attr, &table_and_sstables] (auto units) {
+                    if (_as.abort_requested()) {
+                        return make_ready_future<>();
                     }
-
-                    auto ms = mutation_source([this, ssts] (
-                                schema_ptr s,
-                                reader_permit permit,
-                                const dht::partition_range& pr,
-                                const query::partition_slice& ps,
-                                const io_priority_class& pc,
-                                tracing::trace_state_ptr ts,
-                                streamed_mutation::forwarding fwd_ms,
-                                mutation_reader::forwarding fwd_mr) {
-                        return ::make_restricted_range_sstable_reader(s, std::move(permit), std::move(ssts), pr, ps, pc, std::move(ts), fwd_ms, fwd_mr);
+                    ++_tables_in_progress;
+                    return seastar::async(attr, [this, &table_and_sstables] {
+                        auto num_sstables = table_and_sstables.second.size();
+                        process_staging_sstables(table_and_sstables.first, std::move(table_and_sstables.second));
+                        _sstables_in_progress -= num_sstables;
+                    }).finally([this, units = std::move(units)] {
+                        --_tables_in_progress;
                     });
-                    auto [staging_sstable_reader, staging_sstable_reader_handle] = make_manually_paused_evictable_reader(
-                            std::move(ms),
-                            s,
-                            _db.get_reader_concurrency_semaphore().make_permit(),
-                            query::full_partition_range,
-                            s->full_slice(),
-                            service::get_local_streaming_priority(),
-                            nullptr,
-                            ::mutation_reader::forwarding::no);
-
-                    inject_failure("view_update_generator_consume_staging_sstable");
-                    auto result = staging_sstable_reader.consume_in_thread(view_updating_consumer(s, *t, sstables, _as, staging_sstable_reader_handle), db::no_timeout);
-                    if (result == stop_iteration::yes) {
-                        break;
-                    }
-                } catch (...) {
-                    vug_logger.warn("Processing {} failed for table {}:{}. Will retry...", s->ks_name(), s->cf_name(), std::current_exception());
-                    // Need to add sstables back to the set so we can retry later. By now it may
-                    // have had other updates.
-                    std::move(sstables.begin(), sstables.end(), std::back_inserter(_sstables_with_tables[t]));
-                    break;
-                }
-                try {
-                    inject_failure("view_update_generator_collect_consumed_sstables");
-                    // collect all staging sstables to move in a map, grouped by table.
-                    std::move(sstables.begin(), sstables.end(), std::back_inserter(_sstables_to_move[t]));
-                } catch (...) {
-                    // Move from staging will be retried upon restart.
-                    vug_logger.warn("Moving {} from staging failed: {}:{}. Ignoring...", s->ks_name(), s->cf_name(), std::current_exception());
-                }
-                _registration_sem.signal(num_sstables);
-            }
+                });
+            }).get();
+            _sstables_in_progress = 0;
+
             // For each table, move the processed staging sstables into the table's base dir.
             for (auto it = _sstables_to_move.begin(); it != _sstables_to_move.end(); ) {
                 auto& [t, sstables] = *it;
@@ -166,7 +192,24 @@ void view_update_generator::setup_metrics() {
 
         sm::make_gauge("sstables_to_move_count",
                 sm::description("Number of sets of sstables which are already processed and wait to be moved from their staging directory"),
-                [this] { return _sstables_to_move.size(); })
+                [this] { return _sstables_to_move.size(); }),
+
+        sm::make_gauge("pending_sstables",
+                sm::description("Number of staging sstables queued or being processed for view update generation"),
+                [this] { return _sstables_in_progress + boost::accumulate(_sstables_with_tables | boost::adaptors::map_values
+                        | boost::adaptors::transformed(std::mem_fn(&std::vector<sstables::shared_sstable>::size)), size_t(0)); }),
+
+        sm::make_gauge("tables_in_progress",
+                sm::description("Number of tables whose staging sstables are being processed concurrently"),
+                [this] { return _tables_in_progress; }),
+
+        sm::make_derive("sstables_processed",
+                sm::description("Number of staging sstables for which view updates were generated"),
+                _stats.sstables_processed),
+
+        sm::make_derive("bytes_processed",
+                sm::description("Total data size of the staging sstables for which view updates were generated"),
+                _stats.bytes_processed),
     });
 }
 
@@ -34,6 +34,9 @@ namespace db::view {
 class view_update_generator {
 public:
     static constexpr size_t registration_queue_size = 5;
+    // Memory available to the buffers of the view_updating_consumers of
+    // tables processed concurrently. Each consumer takes its hard limit.
+    static constexpr size_t memory_budget = 16 * 1024 * 1024;
 
 private:
     database& _db;
@@ -41,6 +44,7 @@ class view_update_generator {
     future<> _started = make_ready_future<>();
     seastar::condition_variable _pending_sstables;
     named_semaphore _registration_sem{registration_queue_size, named_semaphore_exception_factory{"view update generator"}};
+    seastar::semaphore _memory_sem{memory_budget};
     struct sstable_with_table {
         sstables::shared_sstable sst;
         lw_shared_ptr<table> t;
@@ -48,6 +52,12 @@ class view_update_generator {
     };
     std::unordered_map<lw_shared_ptr<table>, std::vector<sstables::shared_sstable>> _sstables_with_tables;
     std::unordered_map<lw_shared_ptr<table>, std::vector<sstables::shared_sstable>> _sstables_to_move;
+    size_t _sstables_in_progress = 0;
+    size_t _tables_in_progress = 0;
+    struct stats {
+        uint64_t sstables_processed = 0;
+        uint64_t bytes_processed = 0;
+    } _stats;
     metrics::metric_groups _metrics;
 public:
     view_update_generator(database& db) : _db(db) {
@@ -61,6 +71,7 @@ class view_update_generator {
     ssize_t available_register_units() const { return _registration_sem.available_units(); }
 private:
     bool should_throttle() const;
+    void process_staging_sstables(lw_shared_ptr<table> t, std::vector<sstables::shared_sstable> sstables);
     void setup_metrics();
 };
 
@@ -142,6 +142,10 @@ extern const std::string_view HINTED_HANDOFF_SEPARATE_CONNECTION;
 extern const std::string_view LWT;
 extern const std::string_view PER_TABLE_PARTITIONERS;
 extern const std::string_view PER_TABLE_CACHING;
+extern const std::string_view ROW_SUMMARY_READ_REPAIR;
+extern const std::string_view XXHASH3;
+extern const std::string_view FILTERING_PUSHDOWN;
+extern const std::string_view RESULTS_CACHING;
 
 }
 
@@ -57,6 +57,10 @@ constexpr std::string_view features::HINTED_HANDOFF_SEPARATE_CONNECTION = "HINTE
 constexpr std::string_view features::LWT = "LWT";
 constexpr std::string_view features::PER_TABLE_PARTITIONERS = "PER_TABLE_PARTITIONERS";
 constexpr std::string_view features::PER_TABLE_CACHING = "PER_TABLE_CACHING";
+constexpr std::string_view features::ROW_SUMMARY_READ_REPAIR = "ROW_SUMMARY_READ_REPAIR";
+constexpr std::string_view features::XXHASH3 = "XXHASH3";
+constexpr std::string_view features::FILTERING_PUSHDOWN = "FILTERING_PUSHDOWN";
+constexpr std::string_view features::RESULTS_CACHING = "RESULTS_CACHING";
 
 static logging::logger logger("features");
 
@@ -92,7 +96,11 @@ feature_service::feature_service(feature_config cfg) : _config(cfg)
         , _hinted_handoff_separate_connection(*this, features::HINTED_HANDOFF_SEPARATE_CONNECTION)
         , _lwt_feature(*this, features::LWT)
         , _per_table_partitioners_feature(*this, features::PER_TABLE_PARTITIONERS)
-        , _per_table_caching_feature(*this, features::PER_TABLE_CACHING) {
+        , _per_table_caching_feature(*this, features::PER_TABLE_CACHING)
+        , _row_summary_read_repair_feature(*this, features::ROW_SUMMARY_READ_REPAIR)
+        , _xxhash3_feature(*this, features::XXHASH3)
+        , _filtering_pushdown_feature(*this, features::FILTERING_PUSHDOWN)
+        , _results_caching_feature(*this, features::RESULTS_CACHING) {
 }
 
 feature_config feature_config_from_db_config(db::config& cfg, std::set<sstring> disabled) {
@@ -185,6 +193,10 @@ std::set<std::string_view> feature_service::known_feature_set() {
         gms::features::HINTED_HANDOFF_SEPARATE_CONNECTION,
         gms::features::PER_TABLE_PARTITIONERS,
         gms::features::PER_TABLE_CACHING,
+        gms::features::ROW_SUMMARY_READ_REPAIR,
+        gms::features::XXHASH3,
+        gms::features::FILTERING_PUSHDOWN,
+        gms::features::RESULTS_CACHING,
         gms::features::LWT,
         gms::features::MC_SSTABLE,
         gms::features::MD_SSTABLE,
@@ -281,6 +293,10 @@ void feature_service::enable(const std::set<std::string_view>& list) {
         std::ref(_lwt_feature),
         std::ref(_per_table_partitioners_feature),
         std::ref(_per_table_caching_feature),
+        std::ref(_row_summary_read_repair_feature),
+        std::ref(_xxhash3_feature),
+        std::ref(_filtering_pushdown_feature),
+        std::ref(_results_caching_feature),
     })
     {
         if (list.contains(f.name())) {
@@ -104,6 +104,10 @@ class feature_service final {
     gms::feature _lwt_feature;
     gms::feature _per_table_partitioners_feature;
     gms::feature _per_table_caching_feature;
+    gms::feature _row_summary_read_repair_feature;
+    gms::feature _xxhash3_feature;
+    gms::feature _filtering_pushdown_feature;
+    gms::feature _results_caching_feature;
 
 public:
     bool cluster_supports_range_tombstones() const {
@@ -150,6 +154,18 @@ class feature_service final {
         return bool(_xxhash_feature);
     }
 
+    bool cluster_supports_xxhash3_digest_algorithm() const {
+        return bool(_xxhash3_feature);
+    }
+
+    bool cluster_supports_filtering_pushdown() const {
+        return bool(_filtering_pushdown_feature);
+    }
+
+    bool cluster_supports_results_caching() const {
+        return bool(_results_caching_feature);
+    }
+
     bool cluster_supports_user_defined_functions() const {
         return bool(_udf_feature);
     }
@@ -182,6 +198,10 @@ class feature_service final {
         return _per_table_caching_feature;
     }
 
+    bool cluster_supports_row_summary_read_repair() const {
+        return bool(_row_summary_read_repair_feature);
+    }
+
     bool cluster_supports_row_level_repair() const {
         return bool(_row_level_repair_feature);
     }
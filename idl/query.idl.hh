@@ -33,6 +33,7 @@ enum class digest_algorithm : uint8_t {
     none = 0,  // digest not required
     MD5 = 1,
     xxHash = 2,// default algorithm
+    xxHash3 = 3,
 };
 
 }
@@ -30,6 +30,20 @@ class specific_ranges {
     std::vector<nonwrapping_range<clustering_key_prefix>> ranges();
 };
 
+enum class column_filter_op : uint8_t {
+    EQ,
+    LT,
+    LTE,
+    GT,
+    GTE,
+};
+
+struct column_filter {
+    uint32_t id;
+    query::column_filter_op op;
+    bytes value;
+};
+
 class partition_slice {
     std::vector<nonwrapping_range<clustering_key_prefix>> default_row_ranges();
     utils::small_vector<uint32_t, 8> static_columns;
@@ -39,6 +53,7 @@ class partition_slice {
     cql_serialization_format cql_format();
     uint32_t partition_row_limit_low_bits() [[version 1.3]] = std::numeric_limits<uint32_t>::max();
     uint32_t partition_row_limit_high_bits() [[version 4.3]] = 0;
+    std::vector<query::column_filter> get_row_filter() [[version 4.4]] = query::row_filter();
 };
 
 struct max_result_size {
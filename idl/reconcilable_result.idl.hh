@@ -31,3 +31,14 @@ class reconcilable_result {
     query::short_read is_short_read() [[version 1.6]] = query::short_read::no;
     uint32_t row_count_high_bits() [[version 4.3]] = 0;
 };
+
+struct row_summary {
+    clustering_key key;
+    uint64_t hash;
+};
+
+struct partition_row_summary {
+    uint64_t partition_hash;
+    utils::chunked_vector<row_summary> rows;
+    query::short_read is_short_read;
+};
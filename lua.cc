@@ -52,6 +52,13 @@ struct lua_closer {
 
 static const char scylla_decimal_metatable_name[] = "Scylla.decimal";
 
+// The address of this variable is the registry key of the loaded script.
+static const char loaded_script_key = 0;
+
+// The address of this variable is the registry key of the metatable of
+// the environment of each run, see load_script_l().
+static const char env_metatable_key = 0;
+
 class lua_slice_state {
     std::unique_ptr<alloc_state> a_state;
     std::unique_ptr<lua_State, lua_closer> _l;
@@ -60,6 +67,7 @@ class lua_slice_state {
         : a_state(std::move(a_state))
         , _l(std::move(l)) {}
     operator lua_State*() { return _l.get(); }
+    alloc_state& allocs() { return *a_state; }
 };
 }
 
@@ -402,6 +410,35 @@ static const struct luaL_Reg decimal_methods[] {
     {nullptr, nullptr}
 };
 
+static int read_only_newindex(lua_State* l) {
+    return luaL_error(l, "attempt to modify a read-only table");
+}
+
+// The __index of read-only tables. Its upvalue maps the read-only views
+// of the libraries to the libraries, which are only reachable from here.
+static int read_only_index(lua_State* l) {
+    lua_pushvalue(l, 1);
+    if (lua_rawget(l, lua_upvalueindex(1)) != LUA_TTABLE) {
+        return 0;
+    }
+    lua_pushvalue(l, 2);
+    lua_rawget(l, -2);
+    return 1;
+}
+
+// rawset(), refusing tables with the read-only metatable, which is its upvalue.
+static int read_only_rawset(lua_State* l) {
+    luaL_checktype(l, 1, LUA_TTABLE);
+    luaL_checkany(l, 2);
+    luaL_checkany(l, 3);
+    if (lua_getmetatable(l, 1) && lua_rawequal(l, -1, lua_upvalueindex(1))) {
+        return read_only_newindex(l);
+    }
+    lua_settop(l, 3);
+    lua_rawset(l, 1);
+    return 1;
+}
+
 static int load_script_l(lua_State* l) {
     const auto& bitcode = *reinterpret_cast<lua::bitcode_view*>(lua_touserdata(l, 1));
     const auto& binary = bitcode.bitcode;
@@ -415,12 +452,74 @@ static int load_script_l(lua_State* l) {
     lua_pushvalue(l, -1);
     lua_setfield(l, -2, "__index");
     luaL_setfuncs(l, decimal_methods, 0);
+    lua_pushboolean(l, false);
+    lua_setfield(l, -2, "__metatable");
+    lua_pop(l, 1);
+
+    // A state is reused for many runs of the script, so each run gets an
+    // environment of its own (see run_script()), which falls back to the
+    // globals for reads. Writes to globals land in that environment. The
+    // globals themselves are made read-only, and the library tables are
+    // replaced with empty read-only views. The libraries, as well as the
+    // metatables which could lead to them, can't be reached from the
+    // script, so nothing a run stores is seen by the next one.
+    lua_pushglobaltable(l);
+    int globals = lua_gettop(l);
+    lua_newtable(l);
+    int views = lua_gettop(l);
+    lua_newtable(l);
+    int read_only = lua_gettop(l);
+    lua_pushvalue(l, views);
+    lua_pushcclosure(l, read_only_index, 1);
+    lua_setfield(l, read_only, "__index");
+    lua_pushcfunction(l, read_only_newindex);
+    lua_setfield(l, read_only, "__newindex");
+    lua_pushboolean(l, false);
+    lua_setfield(l, read_only, "__metatable");
+
+    lua_pushnil(l);
+    while (lua_next(l, globals)) {
+        if (lua_istable(l, -1) && !lua_rawequal(l, -1, globals)) {
+            lua_newtable(l);
+            lua_pushvalue(l, read_only);
+            lua_setmetatable(l, -2);
+            lua_pushvalue(l, -1);
+            lua_pushvalue(l, -3);
+            lua_rawset(l, views);
+            // Replacing the value of an existing key doesn't disturb lua_next().
+            lua_pushvalue(l, -3);
+            lua_insert(l, -2);
+            lua_rawset(l, globals);
+        }
+        lua_pop(l, 1);
+    }
+    lua_pushvalue(l, read_only);
+    lua_pushcclosure(l, read_only_rawset, 1);
+    lua_setfield(l, globals, "rawset");
+    lua_pushvalue(l, read_only);
+    lua_setmetatable(l, globals);
+
+    // Strings share a metatable, whose __index is the string library.
+    lua_pushliteral(l, "");
+    lua_getmetatable(l, -1);
+    lua_pushboolean(l, false);
+    lua_setfield(l, -2, "__metatable");
+    lua_pop(l, 2);
+
+    lua_newtable(l);
+    lua_pushvalue(l, globals);
+    lua_setfield(l, -2, "__index");
+    lua_pushboolean(l, false);
+    lua_setfield(l, -2, "__metatable");
+    lua_rawsetp(l, LUA_REGISTRYINDEX, &env_metatable_key);
+    lua_pop(l, 3);
 
     if (luaL_loadbufferx(l, binary.data(), binary.size(), "<internal>", "b")) {
         lua_error(l);
     }
+    lua_rawsetp(l, LUA_REGISTRYINDEX, &loaded_script_key);
 
-    return 1;
+    return 0;
 }
 
 static lua_slice_state load_script(const lua::runtime_config& cfg, lua::bitcode_view binary) {
@@ -431,13 +530,47 @@ static lua_slice_state load_script(const lua::runtime_config& cfg, lua::bitcode_
     // stack slots and the following push calls don't allocate.
     lua_pushcfunction(l, load_script_l);
     lua_pushlightuserdata(l, &binary);
-    if (lua_pcall(l, 1, 1, 0)) {
+    if (lua_pcall(l, 1, 0, 0)) {
         throw std::runtime_error(std::string("could not initiate: ") + lua_tostring(l, -1));
     }
 
     return l;
 }
 
+// A state with the script stored in its registry, so that it can be
+// run again once the previous run completed.
+class lua::loaded_script {
+public:
+    lua_slice_state l;
+
+    explicit loaded_script(lua_slice_state l) : l(std::move(l)) {}
+};
+
+// Keeping more idle states than this would only pin the memory of a
+// burst of concurrent calls.
+static constexpr size_t max_idle_scripts = 4;
+
+lua::script_pool::script_pool() = default;
+
+lua::script_pool::script_pool(script_pool&&) noexcept = default;
+
+lua::script_pool::~script_pool() = default;
+
+std::unique_ptr<lua::loaded_script> lua::script_pool::get() {
+    if (_idle.empty()) {
+        return nullptr;
+    }
+    auto s = std::move(_idle.back());
+    _idle.pop_back();
+    return s;
+}
+
+void lua::script_pool::put(std::unique_ptr<loaded_script> s) {
+    if (_idle.size() < max_idle_scripts) {
+        _idle.push_back(std::move(s));
+    }
+}
+
 using millisecond = std::chrono::duration<double, std::milli>;
 static auto now() { return std::chrono::system_clock::now(); }
 
@@ -1051,6 +1184,78 @@ static void push_argument(lua_slice_state& l, const data_value& arg) {
     ::visit(arg, to_lua_visitor{l});
 }
 
+template <typename T>
+static T read_floating(bytes_view v) {
+    using bits_type = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+    auto i = read_simple_exactly<bits_type>(v);
+    T d;
+    memcpy(&d, &i, sizeof(T));
+    return d;
+}
+
+// Values of the primitive types are pushed straight from their
+// serialized form. The others, and values of an unexpected size, are
+// deserialized and pushed by to_lua_visitor.
+static void push_argument(lua_slice_state& l, const abstract_type& type, const bytes_opt& arg) {
+    if (!arg) {
+        lua_pushnil(l);
+        return;
+    }
+    bytes_view v = *arg;
+    switch (type.get_kind()) {
+    case abstract_type::kind::ascii:
+    case abstract_type::kind::utf8:
+    case abstract_type::kind::bytes:
+        lua_pushlstring(l, reinterpret_cast<const char*>(v.data()), v.size());
+        return;
+    case abstract_type::kind::boolean:
+        if (v.size() == 1) {
+            lua_pushboolean(l, v[0] != 0);
+            return;
+        }
+        break;
+    case abstract_type::kind::byte:
+        if (v.size() == sizeof(int8_t)) {
+            lua_pushinteger(l, read_simple_exactly<int8_t>(v));
+            return;
+        }
+        break;
+    case abstract_type::kind::short_kind:
+        if (v.size() == sizeof(int16_t)) {
+            lua_pushinteger(l, read_simple_exactly<int16_t>(v));
+            return;
+        }
+        break;
+    case abstract_type::kind::int32:
+        if (v.size() == sizeof(int32_t)) {
+            lua_pushinteger(l, read_simple_exactly<int32_t>(v));
+            return;
+        }
+        break;
+    case abstract_type::kind::long_kind:
+        if (v.size() == sizeof(int64_t)) {
+            lua_pushinteger(l, read_simple_exactly<int64_t>(v));
+            return;
+        }
+        break;
+    case abstract_type::kind::float_kind:
+        if (v.size() == sizeof(float)) {
+            lua_pushnumber(l, read_floating<float>(v));
+            return;
+        }
+        break;
+    case abstract_type::kind::double_kind:
+        if (v.size() == sizeof(double)) {
+            lua_pushnumber(l, read_floating<double>(v));
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+    push_argument(l, type.deserialize(v));
+}
+
 lua::runtime_config lua::make_runtime_config(const db::config& config) {
     utils::updateable_value<unsigned> max_bytes(config.user_defined_function_allocation_limit_bytes);
     utils::updateable_value<unsigned> max_contiguous(config.user_defined_function_contiguous_allocation_limit_bytes());
@@ -1060,14 +1265,31 @@ lua::runtime_config lua::make_runtime_config(const db::config& config) {
 }
 
 // run the script for at most max_instructions
-future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, const std::vector<data_value>& values, data_type return_type, const lua::runtime_config& cfg) {
-    lua_slice_state l = load_script(cfg, bitcode);
-    unsigned nargs = values.size();
-    if (!lua_checkstack(l, nargs)) {
+future<bytes_opt> lua::run_script(script_pool& pool, lua::bitcode_view bitcode, const std::vector<data_type>& arg_types,
+        const std::vector<bytes_opt>& args, data_type return_type, const lua::runtime_config& cfg) {
+    std::unique_ptr<loaded_script> s = pool.get();
+    if (s) {
+        // The limits may have been changed since the state was created.
+        s->l.allocs().max = cfg.max_bytes;
+        s->l.allocs().max_contiguous = cfg.max_contiguous;
+    } else {
+        s = std::make_unique<loaded_script>(load_script(cfg, bitcode));
+    }
+    lua_slice_state& l = s->l;
+    unsigned nargs = args.size();
+    if (!lua_checkstack(l, nargs + 3)) {
         throw std::runtime_error("could push args to the stack");
     }
-    for (const data_value& arg : values) {
-        push_argument(l, arg);
+    lua_rawgetp(l, LUA_REGISTRYINDEX, &loaded_script_key);
+    // Run the script in a fresh environment, which is its first upvalue.
+    lua_newtable(l);
+    lua_pushvalue(l, -1);
+    lua_setfield(l, -2, "_G");
+    lua_rawgetp(l, LUA_REGISTRYINDEX, &env_metatable_key);
+    lua_setmetatable(l, -2);
+    lua_setupvalue(l, -2, 1);
+    for (unsigned i = 0; i < nargs; ++i) {
+        push_argument(l, *arg_types[i], args[i]);
     }
 
     // We don't update the timeout once we start executing the function
@@ -1075,15 +1297,22 @@ future<bytes_opt> lua::run_script(lua::bitcode_view bitcode, const std::vector<d
     using duration = std::chrono::system_clock::duration;
     duration elapsed{0};
     duration timeout = std::chrono::duration_cast<duration>(millisecond(cfg.timeout_in_ms));
-    return repeat_until_value([l = std::move(l), elapsed, return_type, nargs, timeout = std::move(timeout)] () mutable {
+    return repeat_until_value([&pool, s = std::move(s), elapsed, return_type, nargs, timeout = std::move(timeout)] () mutable {
+        lua_slice_state& l = s->l;
         // Set the hook before resuming. We have to do it here since the hook can reset itself
         // if it detects we are spending too much time in C.
         // The hook will be called after 1000 instructions.
         lua_sethook(l, debug_hook, LUA_MASKCALL | LUA_MASKCOUNT, 1000);
         auto start = ::now();
         switch (lua_resume(l, nullptr, nargs)) {
-        case LUA_OK:
-            return make_ready_future<std::optional<bytes_opt>>(convert_return(l, return_type));
+        case LUA_OK: {
+            auto ret = convert_return(l, return_type);
+            // A state that completed the script can run it again. One that
+            // failed or timed out is dropped.
+            lua_settop(l, 0);
+            pool.put(std::move(s));
+            return make_ready_future<std::optional<bytes_opt>>(std::move(ret));
+        }
         case LUA_YIELD: {
             nargs = 0;
             elapsed += ::now() - start;
@@ -40,7 +40,27 @@ struct runtime_config {
 
 runtime_config make_runtime_config(const db::config& config);
 
+class loaded_script;
+
+// Lua states with a script already loaded, kept so that running the
+// script again doesn't have to set up a new interpreter. A pool
+// belongs to a single shard.
+class script_pool {
+    std::vector<std::unique_ptr<loaded_script>> _idle;
+public:
+    script_pool();
+    script_pool(script_pool&&) noexcept;
+    ~script_pool();
+
+    std::unique_ptr<loaded_script> get();
+    void put(std::unique_ptr<loaded_script> s);
+};
+
 sstring compile(const runtime_config& cfg, const std::vector<sstring>& arg_names, sstring script);
-seastar::future<bytes_opt> run_script(bitcode_view bitcode, const std::vector<data_value>& values,
-                                      data_type return_type, const runtime_config& cfg);
+
+// Runs the script with the given serialized arguments. A state is
+// taken from the pool, or created if the pool is empty, and returned
+// to it once the script completes successfully.
+seastar::future<bytes_opt> run_script(script_pool& pool, bitcode_view bitcode, const std::vector<data_type>& arg_types,
+                                      const std::vector<bytes_opt>& args, data_type return_type, const runtime_config& cfg);
 }
@@ -256,6 +256,8 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private loga
     mutation_source as_data_source();
 
     bool empty() const { return partitions.empty(); }
+    // Returns true iff this memtable holds an entry for the given partition.
+    bool contains_partition(const dht::decorated_key& key) const;
     void mark_flushed(mutation_source) noexcept;
     bool is_flushed() const;
     void on_detach_from_region_group() noexcept;
@@ -494,6 +494,7 @@ static constexpr unsigned do_get_rpc_client_idx(messaging_verb verb) {
     case messaging_verb::READ_DATA:
     case messaging_verb::READ_MUTATION_DATA:
     case messaging_verb::READ_DIGEST:
+    case messaging_verb::READ_ROW_SUMMARY:
     case messaging_verb::GOSSIP_DIGEST_ACK:
     case messaging_verb::DEFINITIONS_UPDATE:
     case messaging_verb::TRUNCATE:
@@ -1171,6 +1172,16 @@ future<rpc::tuple<reconcilable_result, rpc::optional<cache_temperature>>> messag
     return send_message_timeout<future<rpc::tuple<reconcilable_result, rpc::optional<cache_temperature>>>>(this, messaging_verb::READ_MUTATION_DATA, std::move(id), timeout, cmd, pr);
 }
 
+void messaging_service::register_read_row_summary(std::function<future<partition_row_summary> (const rpc::client_info&, rpc::opt_time_point t, query::read_command cmd, ::compat::wrapping_partition_range pr)>&& func) {
+    register_handler(this, netw::messaging_verb::READ_ROW_SUMMARY, std::move(func));
+}
+future<> messaging_service::unregister_read_row_summary() {
+    return unregister_handler(netw::messaging_verb::READ_ROW_SUMMARY);
+}
+future<partition_row_summary> messaging_service::send_read_row_summary(msg_addr id, clock_type::time_point timeout, const query::read_command& cmd, const dht::partition_range& pr) {
+    return send_message_timeout<partition_row_summary>(this, messaging_verb::READ_ROW_SUMMARY, std::move(id), timeout, cmd, pr);
+}
+
 void messaging_service::register_read_digest(std::function<future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature>> (const rpc::client_info&, rpc::opt_time_point timeout, query::read_command cmd, ::compat::wrapping_partition_range pr, rpc::optional<query::digest_algorithm> oda)>&& func) {
     register_handler(this, netw::messaging_verb::READ_DIGEST, std::move(func));
 }
@@ -143,7 +143,8 @@ enum class messaging_verb : int32_t {
     HINT_MUTATION = 42,
     PAXOS_PRUNE = 43,
     GOSSIP_GET_ENDPOINT_STATES = 44,
-    LAST = 45,
+    READ_ROW_SUMMARY = 45,
+    LAST = 46,
 };
 
 } // namespace netw
@@ -482,6 +483,11 @@ class messaging_service : public seastar::async_sharded_service<messaging_servic
     future<> unregister_read_mutation_data();
     future<rpc::tuple<reconcilable_result, rpc::optional<cache_temperature>>> send_read_mutation_data(msg_addr id, clock_type::time_point timeout, const query::read_command& cmd, const dht::partition_range& pr);
 
+    // Wrapper for READ_ROW_SUMMARY
+    void register_read_row_summary(std::function<future<partition_row_summary> (const rpc::client_info&, rpc::opt_time_point timeout, query::read_command cmd, ::compat::wrapping_partition_range pr)>&& func);
+    future<> unregister_read_row_summary();
+    future<partition_row_summary> send_read_row_summary(msg_addr id, clock_type::time_point timeout, const query::read_command& cmd, const dht::partition_range& pr);
+
     // Wrapper for READ_DIGEST
     void register_read_digest(std::function<future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature>> (const rpc::client_info&, rpc::opt_time_point timeout, query::read_command cmd, ::compat::wrapping_partition_range pr, rpc::optional<query::digest_algorithm> digest)>&& func);
     future<> unregister_read_digest();
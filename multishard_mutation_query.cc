@@ -577,7 +577,7 @@ future<> read_context::save_readers(circular_buffer<mutation_fragment> unconsume
 
 namespace {
 
-using consume_result = std::tuple<std::optional<clustering_key_prefix>, reconcilable_result>;
+using consume_result = std::tuple<query::page_end_position, reconcilable_result>;
 
 struct page_consume_result {
     std::optional<clustering_key_prefix> last_ckey;
@@ -587,7 +587,7 @@ struct page_consume_result {
 
     page_consume_result(consume_result&& result, circular_buffer<mutation_fragment>&& unconsumed_fragments,
             lw_shared_ptr<compact_for_mutation_query_state>&& compaction_state)
-        : last_ckey(std::get<std::optional<clustering_key_prefix>>(std::move(result)))
+        : last_ckey(std::get<query::page_end_position>(std::move(result)).last_ckey)
         , result(std::get<reconcilable_result>(std::move(result)))
         , unconsumed_fragments(std::move(unconsumed_fragments))
         , compaction_state(std::move(compaction_state)) {
@@ -1976,12 +1976,16 @@ class mutation_querier {
     bool _live_data_in_static_row{};
     uint64_t _live_clustering_rows = 0;
     std::optional<ser::qr_partition__rows<bytes_ostream>> _rows_wr;
+    uint64_t& _filtered_out_rows;
+    // Key of the last row, if it was dropped by the slice's row filter.
+    std::optional<clustering_key> _last_filtered_out_key;
 private:
     void query_static_row(const row& r, tombstone current_tombstone);
     void prepare_writers();
+    stop_iteration write_row(const clustering_key& key, const row& cells);
 public:
     mutation_querier(const schema& s, query::result::partition_writer pw,
-                     query::result_memory_accounter& memory_accounter);
+                     query::result_memory_accounter& memory_accounter, uint64_t& filtered_out_rows);
     void consume(tombstone) { }
     // Requires that sr.has_any_live_data()
     stop_iteration consume(static_row&& sr, tombstone current_tombstone);
@@ -1992,11 +1996,12 @@ class mutation_querier {
 };
 
 mutation_querier::mutation_querier(const schema& s, query::result::partition_writer pw,
-                                   query::result_memory_accounter& memory_accounter)
+                                   query::result_memory_accounter& memory_accounter, uint64_t& filtered_out_rows)
     : _schema(s)
     , _memory_accounter(memory_accounter)
     , _pw(std::move(pw))
     , _static_cells_wr(pw.start().start_static_row().start_cells())
+    , _filtered_out_rows(filtered_out_rows)
 {
 }
 
@@ -2042,11 +2047,50 @@ void mutation_querier::prepare_writers() {
     }
 }
 
+static bool satisfies(const column_definition& def, const atomic_cell_or_collection* cell, const query::column_filter& filter) {
+    if (!cell) {
+        return false;
+    }
+    auto c = cell->as_atomic_cell(def);
+    if (!c.is_live()) {
+        return false;
+    }
+    return c.value().with_linearized([&] (bytes_view value) {
+        const auto cmp = def.type->compare(value, filter.value);
+        switch (filter.op) {
+        case query::column_filter_op::EQ:
+            return cmp == 0;
+        case query::column_filter_op::LT:
+            return cmp < 0;
+        case query::column_filter_op::LTE:
+            return cmp <= 0;
+        case query::column_filter_op::GT:
+            return cmp > 0;
+        case query::column_filter_op::GTE:
+            return cmp >= 0;
+        }
+        std::abort();
+    });
+}
+
+static bool satisfies(const schema& s, const row& cells, const query::row_filter& filter) {
+    return std::all_of(filter.begin(), filter.end(), [&] (const query::column_filter& f) {
+        return satisfies(s.regular_column_at(f.id), cells.find_cell(f.id), f);
+    });
+}
+
 stop_iteration mutation_querier::consume(clustering_row&& cr, row_tombstone current_tombstone) {
     prepare_writers();
 
     const query::partition_slice& slice = _pw.slice();
 
+    if (!slice.get_row_filter().empty() && !satisfies(_schema, cr.cells(), slice.get_row_filter())) {
+        ++_filtered_out_rows;
+        _last_filtered_out_key = std::move(cr.key());
+        return stop_iteration::no;
+    }
+    _last_filtered_out_key = std::nullopt;
+
     if (_pw.requested_digest()) {
         _pw.digest().feed_hash(cr.key(), _schema);
         _pw.digest().feed_hash(current_tombstone);
@@ -2056,15 +2100,21 @@ stop_iteration mutation_querier::consume(clustering_row&& cr, row_tombstone curr
         _pw.last_modified() = max_ts.max;
     }
 
+    return write_row(cr.key(), cr.cells());
+}
+
+stop_iteration mutation_querier::write_row(const clustering_key& key, const row& cells) {
+    const query::partition_slice& slice = _pw.slice();
+
     auto write_row = [&] (auto& rows_writer) {
         auto cells_wr = [&] {
             if (slice.options.contains(query::partition_slice::option::send_clustering_key)) {
-                return rows_writer.add().write_key(cr.key()).start_cells().start_cells();
+                return rows_writer.add().write_key(key).start_cells().start_cells();
             } else {
                 return rows_writer.add().skip_key().start_cells().start_cells();
             }
         }();
-        get_compacted_row_slice(_schema, slice, column_kind::regular_column, cr.cells(), slice.regular_columns, cells_wr);
+        get_compacted_row_slice(_schema, slice, column_kind::regular_column, cells, slice.regular_columns, cells_wr);
         std::move(cells_wr).end_cells().end_cells().end_qr_clustered_row();
     };
 
@@ -2088,6 +2138,17 @@ stop_iteration mutation_querier::consume(clustering_row&& cr, row_tombstone curr
 uint64_t mutation_querier::consume_end_of_stream() {
     prepare_writers();
 
+    if (_last_filtered_out_key) {
+        // The rows at the end of the partition were dropped by the row filter.
+        // Return a cell-less stand-in for the last of them, so that the pager
+        // resumes the query after the dropped rows rather than before them.
+        // The stand-in doesn't satisfy the filter, so the coordinator drops it.
+        if (_pw.requested_digest()) {
+            _pw.digest().feed_hash(*_last_filtered_out_key, _schema);
+        }
+        write_row(*_last_filtered_out_key, row());
+    }
+
     // If we got no rows, but have live static columns, we should only
     // give them back IFF we did not have any CK restrictions.
     // #589
@@ -2113,13 +2174,14 @@ class query_result_builder {
     query::result::builder& _rb;
     std::optional<mutation_querier> _mutation_consumer;
     stop_iteration _stop;
+    uint64_t& _filtered_out_rows;
 public:
-    query_result_builder(const schema& s, query::result::builder& rb)
-        : _schema(s), _rb(rb)
+    query_result_builder(const schema& s, query::result::builder& rb, uint64_t& filtered_out_rows)
+        : _schema(s), _rb(rb), _filtered_out_rows(filtered_out_rows)
     { }
 
     void consume_new_partition(const dht::decorated_key& dk) {
-        _mutation_consumer.emplace(mutation_querier(_schema, _rb.add_partition(_schema, dk.key()), _rb.memory_accounter()));
+        _mutation_consumer.emplace(mutation_querier(_schema, _rb.add_partition(_schema, dk.key()), _rb.memory_accounter(), _filtered_out_rows));
     }
 
     void consume(tombstone t) {
@@ -2176,10 +2238,17 @@ future<> data_query(
             ? std::move(*querier_opt)
             : query::data_querier(source, s, class_config.semaphore.make_permit(), range, slice, service::get_local_sstable_query_read_priority(), trace_ptr);
 
-    return do_with(std::move(q), [=, &builder, trace_ptr = std::move(trace_ptr), cache_ctx = std::move(cache_ctx)] (query::data_querier& q) mutable {
-        auto qrb = query_result_builder(*s, builder);
+    return do_with(std::move(q), uint64_t(0), [=, &builder, trace_ptr = std::move(trace_ptr), cache_ctx = std::move(cache_ctx)] (query::data_querier& q,
+            uint64_t& filtered_out_rows) mutable {
+        auto qrb = query_result_builder(*s, builder, filtered_out_rows);
         return q.consume_page(std::move(qrb), row_limit, partition_limit, query_time, timeout, class_config.max_memory_for_unlimited_query).then(
-                [=, &builder, &q, trace_ptr = std::move(trace_ptr), cache_ctx = std::move(cache_ctx)] () mutable {
+                [=, &builder, &q, &filtered_out_rows, trace_ptr = std::move(trace_ptr), cache_ctx = std::move(cache_ctx)] () mutable {
+            // The limits count the rows dropped by the row filter too, so
+            // reaching them doesn't mean the result is as large as requested.
+            // Mark it as short so that the pager doesn't take it for the last page.
+            if (filtered_out_rows && q.are_limits_reached()) {
+                builder.mark_as_short_read();
+            }
             if (q.are_limits_reached() || builder.is_short_read()) {
                 cache_ctx.insert(std::move(q), std::move(trace_ptr));
             }
@@ -24,6 +24,10 @@
 #include "mutation_partition_serializer.hh"
 #include "service/priority_manager.hh"
 #include "query-result-writer.hh"
+#include "atomic_cell_hash.hh"
+#include "xx_hasher.hh"
+
+#include <map>
 
 reconcilable_result::~reconcilable_result() {}
 
@@ -80,6 +84,90 @@ to_data_query_result(const reconcilable_result& r, schema_ptr s, const query::pa
     return builder.build();
 }
 
+static void feed_row_cells(xx_hasher& h, const schema& s, column_kind kind, const row& cells) {
+    cells.for_each_cell([&] (column_id id, const atomic_cell_or_collection& cell) {
+        feed_hash(h, id);
+        feed_hash(h, cell, s.column_at(kind, id));
+    });
+}
+
+partition_row_summary summarize_rows(schema_ptr s, const reconcilable_result& r) {
+    partition_row_summary summary;
+    summary.is_short_read = r.is_short_read();
+    if (r.partitions().empty()) {
+        return summary;
+    }
+    auto m = r.partitions().front().mut().unfreeze(s);
+    const auto& p = m.partition();
+
+    xx_hasher ph;
+    feed_hash(ph, p.partition_tombstone());
+    feed_row_cells(ph, *s, column_kind::static_column, p.static_row().get());
+    for (const range_tombstone& rt : p.row_tombstones()) {
+        feed_hash(ph, rt, *s);
+    }
+    summary.partition_hash = ph.finalize_uint64();
+
+    for (const rows_entry& e : p.clustered_rows()) {
+        if (e.dummy()) {
+            continue;
+        }
+        xx_hasher h;
+        feed_hash(h, e.row().marker());
+        feed_hash(h, e.row().deleted_at());
+        feed_row_cells(h, *s, column_kind::regular_column, e.row().cells());
+        summary.rows.push_back(row_summary{e.key(), h.finalize_uint64()});
+    }
+    return summary;
+}
+
+bool can_repair_with_row_summaries(const query::read_command& cmd, const dht::partition_range& pr, size_t result_size, bool enabled) {
+    return enabled
+            && pr.is_singular()
+            && !cmd.slice.options.contains(query::partition_slice::option::reversed)
+            && result_size >= row_summary_min_result_size;
+}
+
+std::optional<query::clustering_row_ranges> divergent_rows(const schema& s, const std::vector<partition_row_summary>& summaries) {
+    struct row_versions {
+        uint64_t hash;
+        size_t replicas = 0;
+        bool diverged = false;
+    };
+    std::map<clustering_key, row_versions, clustering_key::less_compare> rows{clustering_key::less_compare(s)};
+    for (const partition_row_summary& summary : summaries) {
+        if (summary.is_short_read || summary.partition_hash != summaries.front().partition_hash) {
+            return std::nullopt;
+        }
+        for (const row_summary& row : summary.rows) {
+            auto [it, inserted] = rows.try_emplace(row.key, row_versions{row.hash});
+            it->second.replicas++;
+            it->second.diverged |= it->second.hash != row.hash;
+        }
+    }
+    query::clustering_row_ranges ranges;
+    for (auto& [key, versions] : rows) {
+        if (versions.diverged || versions.replicas != summaries.size()) {
+            ranges.push_back(query::clustering_range::make_singular(key));
+        }
+    }
+    // If the rows agree the mismatch lies elsewhere, and if most of them
+    // don't there is nothing to save.
+    if (ranges.empty() || ranges.size() * 2 > rows.size()) {
+        return std::nullopt;
+    }
+    return ranges;
+}
+
+lw_shared_ptr<query::read_command> make_row_repair_command(const schema& s, const query::read_command& cmd, const partition_key& key,
+        query::clustering_row_ranges ranges) {
+    auto repair_cmd = make_lw_shared<query::read_command>(cmd);
+    repair_cmd->slice.set_range(s, key, std::move(ranges));
+    repair_cmd->set_row_limit(query::max_rows);
+    repair_cmd->slice.set_partition_row_limit(query::max_rows);
+    return repair_cmd;
+}
+
 std::ostream& operator<<(std::ostream& out, const reconcilable_result::printer& pr) {
     out << "{rows=" << pr.self.row_count() << ", short_read="
         << pr.self.is_short_read() << ", [";
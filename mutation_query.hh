@@ -167,6 +167,45 @@ class reconcilable_result_builder {
 
 query::result to_data_query_result(const reconcilable_result&, schema_ptr, const query::partition_slice&, uint64_t row_limit, uint32_t partition_limit, query::result_options opts = query::result_options::only_result());
 
+// Compact description of a single clustering row of a reconcilable_result,
+// used by read repair to locate the rows replicas disagree on without
+// shipping the rows themselves.
+struct row_summary {
+    clustering_key key;
+    // Hash of the row marker, row tombstone and all cells, including their
+    // timestamps, so that any difference in the row's write history shows up.
+    uint64_t hash;
+};
+
+struct partition_row_summary {
+    // Hash of everything in the partition that is not a clustering row:
+    // the partition tombstone, the static row and range tombstones.
+    uint64_t partition_hash = 0;
+    utils::chunked_vector<row_summary> rows;
+    query::short_read is_short_read = query::short_read::no;
+};
+
+// Summarizes the first (and, for singular reads, only) partition of r.
+partition_row_summary summarize_rows(schema_ptr, const reconcilable_result& r);
+
+// Results smaller than this are cheaper to reconcile in full than to
+// summarize, repair and read again.
+constexpr size_t row_summary_min_result_size = 64 * 1024;
+
+// Whether a digest mismatch of the read of pr by cmd, whose data result is
+// result_size bytes long, is worth repairing with row summaries, given
+// whether the cluster and the configuration allow it.
+bool can_repair_with_row_summaries(const query::read_command& cmd, const dht::partition_range& pr, size_t result_size, bool enabled);
+
+// Returns singular ranges for the rows which some of the replicas don't
+// have or have in a different version, or nothing when the summaries
+// can't narrow the repair down to a small enough set of rows.
+std::optional<query::clustering_row_ranges> divergent_rows(const schema& s, const std::vector<partition_row_summary>& summaries);
+
+// The read of the given rows of the partition with the key, which is otherwise like cmd.
+lw_shared_ptr<query::read_command> make_row_repair_command(const schema& s, const query::read_command& cmd, const partition_key& key,
+        query::clustering_row_ranges ranges);
+
 // Performs a query on given data source returning data in reconcilable form.
 //
 // Reads at most row_limit rows. If less rows are returned, the data source
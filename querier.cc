@@ -25,6 +25,8 @@
 
 #include <boost/range/adaptor/map.hpp>
 
+#include <unordered_map>
+
 namespace query {
 
 enum class can_use {
@@ -217,10 +219,11 @@ static querier_cache::entries::iterator find_querier(querier_cache::entries& ent
     return it->pos();
 }
 
-querier_cache::querier_cache(size_t max_cache_size, std::chrono::seconds entry_ttl)
+querier_cache::querier_cache(size_t max_cache_size, std::chrono::seconds entry_ttl, double table_share)
     : _expiry_timer([this] { scan_cache_entries(); })
     , _entry_ttl(entry_ttl)
-    , _max_queriers_memory_usage(max_cache_size) {
+    , _max_queriers_memory_usage(max_cache_size)
+    , _max_table_queriers_memory_usage(max_cache_size * table_share) {
     _expiry_timer.arm_periodic(entry_ttl / 2);
 }
 
@@ -242,12 +245,22 @@ class querier_inactive_read : public reader_concurrency_semaphore::inactive_read
     }
 };
 
+// A querier which stopped at a partition boundary is cheap to recreate: the
+// new reader only has to look up the next partition in the index. One which
+// stopped inside a partition has to seek into it too, skipping over the
+// already read rows, which for large partitions means going through the
+// promoted index again.
+static bool is_cheap_to_recreate(const querier_base& q) {
+    return q.is_at_partition_boundary();
+}
+
 template <typename Querier>
 static void insert_querier(
         querier_cache::entries& entries,
         querier_cache::index& index,
         querier_cache::stats& stats,
         size_t max_queriers_memory_usage,
+        size_t max_table_queriers_memory_usage,
         utils::UUID key,
         Querier&& q,
         lowres_clock::time_point expires,
@@ -264,8 +277,12 @@ static void insert_querier(
 
     tracing::trace(trace_state, "Caching querier with key {}", key);
 
-    auto memory_usage = boost::accumulate(entries | boost::adaptors::transformed(
-                [] (const querier_cache::entry& e) { return e.value().memory_usage(); }), size_t(0));
+    size_t memory_usage = 0;
+    std::unordered_map<utils::UUID, size_t> table_memory_usage;
+    for (const auto& e : entries) {
+        memory_usage += e.value().memory_usage();
+        table_memory_usage[e.value().schema().id()] += e.value().memory_usage();
+    }
 
     // We add the memory-usage of the to-be added querier to the memory-usage
     // of all the cached queriers. We now need to makes sure this number is
@@ -273,16 +290,42 @@ static void insert_querier(
     // cached queriers and substract their memory usage from this number until
     // it goes below the limit.
     memory_usage += q.memory_usage();
+    table_memory_usage[q.schema().id()] += q.memory_usage();
 
-    if (memory_usage >= max_queriers_memory_usage) {
+    // Evicts the oldest queriers matching pred, until the memory usage goes
+    // below the limit.
+    const auto evict_while_above_limit = [&] (auto pred) {
         auto it = entries.begin();
         while (it != entries.end() && memory_usage >= max_queriers_memory_usage) {
+            if (!pred(*it)) {
+                ++it;
+                continue;
+            }
+            auto& table_usage = table_memory_usage[it->value().schema().id()];
+            if (table_usage > max_table_queriers_memory_usage) {
+                ++stats.table_budget_evictions;
+            }
             memory_usage -= it->value().memory_usage();
+            table_usage -= it->value().memory_usage();
             it->value().permit().semaphore().unregister_inactive_read(std::move(*it).get_inactive_handle());
             it = entries.erase(it);
             --stats.population;
             ++stats.memory_based_evictions;
         }
+    };
+
+    if (memory_usage >= max_queriers_memory_usage) {
+        const auto is_over_budget = [&] (const querier_cache::entry& e) {
+            return table_memory_usage[e.value().schema().id()] > max_table_queriers_memory_usage;
+        };
+        // Tables using more than their share of the cache, e.g. because of
+        // many concurrent paging clients, pay first, so they don't push out
+        // the queriers of all other tables. Within that, cheap to recreate
+        // queriers go before the expensive ones.
+        evict_while_above_limit([&] (const querier_cache::entry& e) { return is_over_budget(e) && is_cheap_to_recreate(e.value()); });
+        evict_while_above_limit(is_over_budget);
+        evict_while_above_limit([] (const querier_cache::entry& e) { return is_cheap_to_recreate(e.value()); });
+        evict_while_above_limit([] (const querier_cache::entry&) { return true; });
     }
 
     auto& sem = q.permit().semaphore();
@@ -298,17 +341,20 @@ static void insert_querier(
 }
 
 void querier_cache::insert(utils::UUID key, data_querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(_entries, _data_querier_index, _stats, _max_queriers_memory_usage, key, std::move(q), lowres_clock::now() + _entry_ttl,
+    insert_querier(_entries, _data_querier_index, _stats, _max_queriers_memory_usage, _max_table_queriers_memory_usage, key, std::move(q),
+            lowres_clock::now() + _entry_ttl,
             std::move(trace_state));
 }
 
 void querier_cache::insert(utils::UUID key, mutation_querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(_entries, _mutation_querier_index, _stats, _max_queriers_memory_usage, key, std::move(q), lowres_clock::now() + _entry_ttl,
+    insert_querier(_entries, _mutation_querier_index, _stats, _max_queriers_memory_usage, _max_table_queriers_memory_usage, key, std::move(q),
+            lowres_clock::now() + _entry_ttl,
             std::move(trace_state));
 }
 
 void querier_cache::insert(utils::UUID key, shard_mutation_querier&& q, tracing::trace_state_ptr trace_state) {
-    insert_querier(_entries, _shard_mutation_querier_index, _stats, _max_queriers_memory_usage, key, std::move(q), lowres_clock::now() + _entry_ttl,
+    insert_querier(_entries, _shard_mutation_querier_index, _stats, _max_queriers_memory_usage, _max_table_queriers_memory_usage, key, std::move(q),
+            lowres_clock::now() + _entry_ttl,
             std::move(trace_state));
 }
 
@@ -346,6 +392,11 @@ static std::optional<Querier> lookup_querier(
 
     tracing::trace(trace_state, "Dropping querier because {}", cannot_use_reason(can_be_used));
     ++stats.drops;
+    if (can_be_used == can_use::no_schema_version_mismatch) {
+        ++stats.schema_version_drops;
+    } else {
+        ++stats.position_drops;
+    }
     return std::nullopt;
 }
 
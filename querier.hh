@@ -30,19 +30,28 @@
 
 namespace query {
 
+/// Where the consumption of a page stopped.
+struct page_end_position {
+    /// The last consumed clustering key, or std::nullopt if the last row
+    /// wasn't a clustering row.
+    std::optional<clustering_key_prefix> last_ckey;
+    /// Whether the last consumed fragment was the end of a partition.
+    bool partition_ended = false;
+};
+
 template <typename Consumer>
 class clustering_position_tracker {
     Consumer _consumer;
-    lw_shared_ptr<std::optional<clustering_key_prefix>> _last_ckey;
+    lw_shared_ptr<page_end_position> _position;
 
 public:
-    clustering_position_tracker(Consumer&& consumer, lw_shared_ptr<std::optional<clustering_key_prefix>> last_ckey)
+    clustering_position_tracker(Consumer&& consumer, lw_shared_ptr<page_end_position> position)
         : _consumer(std::forward<Consumer>(consumer))
-        , _last_ckey(std::move(last_ckey)) {
+        , _position(std::move(position)) {
     }
 
     void consume_new_partition(const dht::decorated_key& dk) {
-        _last_ckey->reset();
+        *_position = {};
         _consumer.consume_new_partition(dk);
     }
     void consume(tombstone t) {
@@ -52,13 +61,14 @@ class clustering_position_tracker {
         return _consumer.consume(std::move(sr), std::move(t), is_live);
     }
     stop_iteration consume(clustering_row&& cr, row_tombstone t, bool is_live) {
-        *_last_ckey = cr.key();
+        _position->last_ckey = cr.key();
         return _consumer.consume(std::move(cr), std::move(t), is_live);
     }
     stop_iteration consume(range_tombstone&& rt) {
         return _consumer.consume(std::move(rt));
     }
     stop_iteration consume_end_of_partition() {
+        _position->partition_ended = true;
         return _consumer.consume_end_of_partition();
     }
     auto consume_end_of_stream() {
@@ -70,9 +80,8 @@ class clustering_position_tracker {
 ///
 /// Uses `compaction_state` for compacting the fragments and `consumer` for
 /// building the results.
-/// Returns a future containing a tuple with the last consumed clustering key,
-/// or std::nullopt if the last row wasn't a clustering row, and whatever the
-/// consumer's `consume_end_of_stream()` method returns.
+/// Returns a future containing a tuple with the position the page stopped at
+/// and whatever the consumer's `consume_end_of_stream()` method returns.
 template <emit_only_live_rows OnlyLive, typename Consumer>
 requires CompactedFragmentsConsumer<Consumer>
 auto consume_page(flat_mutation_reader& reader,
@@ -89,10 +98,10 @@ auto consume_page(flat_mutation_reader& reader,
         const auto next_fragment_kind = next_fragment ? next_fragment->mutation_fragment_kind() : mutation_fragment::kind::partition_end;
         compaction_state->start_new_page(row_limit, partition_limit, query_time, next_fragment_kind, consumer);
 
-        auto last_ckey = make_lw_shared<std::optional<clustering_key_prefix>>();
+        auto position = make_lw_shared<page_end_position>();
         auto reader_consumer = make_stable_flattened_mutations_consumer<compact_for_query<OnlyLive, clustering_position_tracker<Consumer>>>(
                 compaction_state,
-                clustering_position_tracker(std::move(consumer), last_ckey));
+                clustering_position_tracker(std::move(consumer), position));
 
         auto consume = [&reader, &slice, reader_consumer = std::move(reader_consumer), timeout, max_size] () mutable {
             if (slice.options.contains(query::partition_slice::option::reversed)) {
@@ -104,9 +113,9 @@ auto consume_page(flat_mutation_reader& reader,
             return reader.consume(std::move(reader_consumer), timeout);
         };
 
-        return consume().then([last_ckey] (auto&&... results) mutable {
+        return consume().then([position] (auto&&... results) mutable {
             static_assert(sizeof...(results) <= 1);
-            return make_ready_future<std::tuple<std::optional<clustering_key_prefix>, std::decay_t<decltype(results)>...>>(std::tuple(std::move(*last_ckey), std::move(results)...));
+            return make_ready_future<std::tuple<page_end_position, std::decay_t<decltype(results)>...>>(std::tuple(std::move(*position), std::move(results)...));
         });
     });
 }
@@ -165,6 +174,10 @@ class querier_base {
 
     virtual position_view current_position() const = 0;
 
+    /// Whether the querier stopped between partitions, rather than after
+    /// some clustering rows of one.
+    virtual bool is_at_partition_boundary() const = 0;
+
     dht::partition_ranges_view ranges() const {
         return _query_ranges;
     }
@@ -199,6 +212,7 @@ template <emit_only_live_rows OnlyLive>
 class querier : public querier_base {
     lw_shared_ptr<compact_for_query_state<OnlyLive>> _compaction_state;
     std::optional<clustering_key_prefix> _last_ckey;
+    bool _partition_ended = false;
 
 public:
     querier(const mutation_source& ms,
@@ -226,7 +240,9 @@ class querier : public querier_base {
             query::max_result_size max_size) {
         return ::query::consume_page(_reader, _compaction_state, *_slice, std::move(consumer), row_limit, partition_limit, query_time,
                 timeout, max_size).then([this] (auto&& results) {
-            _last_ckey = std::get<std::optional<clustering_key>>(std::move(results));
+            auto position = std::get<page_end_position>(std::move(results));
+            _last_ckey = std::move(position.last_ckey);
+            _partition_ended = position.partition_ended;
             constexpr auto size = std::tuple_size<std::decay_t<decltype(results)>>::value;
             static_assert(size <= 2);
             if constexpr (size == 1) {
@@ -243,6 +259,10 @@ class querier : public querier_base {
         const clustering_key_prefix* clustering_key = _last_ckey ? &*_last_ckey : nullptr;
         return {dk, clustering_key};
     }
+
+    virtual bool is_at_partition_boundary() const override {
+        return _partition_ended || !_last_ckey;
+    }
 };
 
 using data_querier = querier<emit_only_live_rows::yes>;
@@ -295,6 +315,14 @@ class shard_mutation_querier : public querier_base {
         return {&_nominal_pkey, _nominal_ckey ? &*_nominal_ckey : nullptr};
     }
 
+    virtual bool is_at_partition_boundary() const override {
+        // The fragments left over from the page were pushed back into the reader.
+        if (!_reader.is_buffer_empty()) {
+            return _reader.peek_buffer().is_partition_start();
+        }
+        return !_nominal_ckey;
+    }
+
     std::unique_ptr<const dht::partition_range> reader_range() && {
         return std::move(_range);
     }
@@ -336,6 +364,9 @@ class shard_mutation_querier : public querier_base {
 class querier_cache {
 public:
     static const std::chrono::seconds default_entry_ttl;
+    // The share of the cache memory a single table can use before its
+    // queriers are the first ones evicted under memory pressure.
+    static constexpr double default_table_share = 0.5;
 
     struct stats {
         // The number of inserts into the cache.
@@ -347,6 +378,10 @@ class querier_cache {
         // The subset of lookups that hit but the looked up querier had to be
         // dropped due to position mismatch.
         uint64_t drops = 0;
+        // The subset of drops caused by a schema version mismatch.
+        uint64_t schema_version_drops = 0;
+        // The subset of drops caused by a ring or clustering position mismatch.
+        uint64_t position_drops = 0;
         // The number of queriers evicted due to their TTL expiring.
         uint64_t time_based_evictions = 0;
         // The number of queriers evicted to free up resources to be able to
@@ -355,6 +390,9 @@ class querier_cache {
         // The number of queriers evicted to because the maximum memory usage
         // was reached.
         uint64_t memory_based_evictions = 0;
+        // The subset of memory based evictions which hit a table that used
+        // more than its share of the cache memory.
+        uint64_t table_budget_evictions = 0;
         // The number of queriers currently in the cache.
         uint64_t population = 0;
     };
@@ -426,11 +464,13 @@ class querier_cache {
     std::chrono::seconds _entry_ttl;
     stats _stats;
     size_t _max_queriers_memory_usage;
+    size_t _max_table_queriers_memory_usage;
 
     void scan_cache_entries();
 
 public:
-    explicit querier_cache(size_t max_cache_size = 1'000'000, std::chrono::seconds entry_ttl = default_entry_ttl);
+    explicit querier_cache(size_t max_cache_size = 1'000'000, std::chrono::seconds entry_ttl = default_entry_ttl,
+            double table_share = default_table_share);
 
     querier_cache(const querier_cache&) = delete;
     querier_cache& operator=(const querier_cache&) = delete;
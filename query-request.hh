@@ -117,6 +117,27 @@ class specific_ranges {
     clustering_row_ranges _ranges;
 };
 
+enum class column_filter_op : uint8_t {
+    EQ,
+    LT,
+    LTE,
+    GT,
+    GTE,
+};
+
+// Compares the value of a regular column with a constant.
+struct column_filter {
+    column_id id;
+    column_filter_op op;
+    bytes value;
+};
+
+// Restrictions on regular columns which replicas apply when building a data
+// query result: rows which don't satisfy all of them are not returned (nor
+// digested). It may hold only a subset of the query's restrictions, so the
+// coordinator still has to filter the merged result.
+using row_filter = std::vector<column_filter>;
+
 constexpr auto max_rows = std::numeric_limits<uint64_t>::max();
 constexpr auto partition_max_rows = std::numeric_limits<uint64_t>::max();
 constexpr auto max_rows_if_set = std::numeric_limits<uint32_t>::max();
@@ -166,13 +187,15 @@ class partition_slice {
     cql_serialization_format _cql_format;
     uint32_t _partition_row_limit_low_bits;
     uint32_t _partition_row_limit_high_bits;
+    row_filter _row_filter;
 public:
     partition_slice(clustering_row_ranges row_ranges, column_id_vector static_columns,
         column_id_vector regular_columns, option_set options,
         std::unique_ptr<specific_ranges> specific_ranges,
         cql_serialization_format,
         uint32_t partition_row_limit_low_bits,
-        uint32_t partition_row_limit_high_bits);
+        uint32_t partition_row_limit_high_bits,
+        row_filter filter = {});
     partition_slice(clustering_row_ranges row_ranges, column_id_vector static_columns,
         column_id_vector regular_columns, option_set options,
         std::unique_ptr<specific_ranges> specific_ranges = nullptr,
@@ -216,6 +239,12 @@ class partition_slice {
         _partition_row_limit_low_bits = static_cast<uint64_t>(limit);
         _partition_row_limit_high_bits = static_cast<uint64_t>(limit >> 32);
     }
+    const row_filter& get_row_filter() const {
+        return _row_filter;
+    }
+    void set_row_filter(row_filter filter) {
+        _row_filter = std::move(filter);
+    }
 
     friend std::ostream& operator<<(std::ostream& out, const partition_slice& ps);
     friend std::ostream& operator<<(std::ostream& out, const specific_ranges& ps);
@@ -117,7 +117,8 @@ partition_slice::partition_slice(clustering_row_ranges row_ranges,
     std::unique_ptr<specific_ranges> specific_ranges,
     cql_serialization_format cql_format,
     uint32_t partition_row_limit_low_bits,
-    uint32_t partition_row_limit_high_bits)
+    uint32_t partition_row_limit_high_bits,
+    row_filter filter)
     : _row_ranges(std::move(row_ranges))
     , static_columns(std::move(static_columns))
     , regular_columns(std::move(regular_columns))
@@ -126,6 +127,7 @@ partition_slice::partition_slice(clustering_row_ranges row_ranges,
     , _cql_format(std::move(cql_format))
     , _partition_row_limit_low_bits(partition_row_limit_low_bits)
     , _partition_row_limit_high_bits(partition_row_limit_high_bits)
+    , _row_filter(std::move(filter))
 {}
 
 partition_slice::partition_slice(clustering_row_ranges row_ranges,
@@ -168,6 +170,7 @@ partition_slice::partition_slice(const partition_slice& s)
     , _specific_ranges(s._specific_ranges ? std::make_unique<specific_ranges>(*s._specific_ranges) : nullptr)
     , _cql_format(s._cql_format)
     , _partition_row_limit_low_bits(s._partition_row_limit_low_bits)
+    , _row_filter(s._row_filter)
 {}
 
 partition_slice::~partition_slice()
@@ -271,51 +274,102 @@ static void write_partial_partition(ser::writer_of_qr_partition<bytes_ostream>&&
     std::move(rows_wr).end_rows().end_qr_partition();
 }
 
-foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
-    if (_partial.size() == 1) {
-        return std::move(_partial[0]);
+struct result_merger::writer {
+    bytes_ostream buf;
+    decltype(ser::writer_of_query_result<bytes_ostream>(std::declval<bytes_ostream&>()).start_partitions()) partitions;
+
+    writer() : partitions(ser::writer_of_query_result<bytes_ostream>(buf).start_partitions()) { }
+};
+
+result_merger::result_merger(uint64_t max_rows, uint32_t max_partitions)
+        : _max_rows(max_rows)
+        , _max_partitions(max_partitions)
+{ }
+
+result_merger::result_merger(result_merger&&) noexcept = default;
+
+result_merger::~result_merger() = default;
+
+void result_merger::operator()(foreign_ptr<lw_shared_ptr<query::result>> r) {
+    if (done()) {
+        return;
     }
+    if (_first) {
+        // More than one result, from now on they are merged as they come.
+        _writer = std::make_unique<writer>();
+        append(*_first);
+        _first = { };
+        if (done()) {
+            return;
+        }
+    }
+    if (!_writer) {
+        _first = std::move(r);
+        _short_read = _first->is_short_read();
+        return;
+    }
+    append(*r);
+}
 
-    bytes_ostream w;
-    auto partitions = ser::writer_of_query_result<bytes_ostream>(w).start_partitions();
-    uint64_t row_count = 0;
-    short_read is_short_read;
-    uint32_t partition_count = 0;
-
-    for (auto&& r : _partial) {
-        result_view::do_with(*r, [&] (result_view rv) {
-            for (auto&& pv : rv._v.partitions()) {
-                auto rows = pv.rows();
-                // If rows.empty(), then there's a static row, or there wouldn't be a partition
-                const uint64_t rows_in_partition = rows.size() ? : 1;
-                const uint64_t rows_to_include = std::min(_max_rows - row_count, rows_in_partition);
-                row_count += rows_to_include;
-                if (rows_to_include >= rows_in_partition) {
-                    partitions.add(pv);
-                    if (++partition_count >= _max_partitions) {
-                        return;
-                    }
-                } else if (rows_to_include > 0) {
-                    ++partition_count;
-                    write_partial_partition(partitions.add(), pv, rows_to_include);
-                    return;
-                } else {
+void result_merger::append(const query::result& r) {
+    result_view::do_with(r, [&] (result_view rv) {
+        for (auto&& pv : rv._v.partitions()) {
+            auto rows = pv.rows();
+            // If rows.empty(), then there's a static row, or there wouldn't be a partition
+            const uint64_t rows_in_partition = rows.size() ? : 1;
+            const uint64_t rows_to_include = std::min(_max_rows - _row_count, rows_in_partition);
+            _row_count += rows_to_include;
+            if (rows_to_include >= rows_in_partition) {
+                _writer->partitions.add(pv);
+                if (++_partition_count >= _max_partitions) {
                     return;
                 }
+            } else if (rows_to_include > 0) {
+                ++_partition_count;
+                write_partial_partition(_writer->partitions.add(), pv, rows_to_include);
+                return;
+            } else {
+                return;
             }
-        });
-        if (r->is_short_read()) {
-            is_short_read = short_read::yes;
-            break;
-        }
-        if (row_count >= _max_rows || partition_count >= _max_partitions) {
-            break;
         }
+    });
+    if (r.is_short_read()) {
+        _short_read = short_read::yes;
+    }
+}
+
+uint64_t result_merger::row_count() const {
+    if (_first) {
+        return _first->row_count() ? *_first->row_count()
+                : result_view::do_with(*_first, [] (result_view rv) { return std::get<1>(rv.count_partitions_and_rows()); });
+    }
+    return _row_count;
+}
+
+uint32_t result_merger::partition_count() const {
+    if (_first) {
+        return _first->partition_count() ? *_first->partition_count()
+                : result_view::do_with(*_first, [] (result_view rv) { return std::get<0>(rv.count_partitions_and_rows()); });
+    }
+    return _partition_count;
+}
+
+bool result_merger::is_short_read() const {
+    return bool(_short_read);
+}
+
+foreign_ptr<lw_shared_ptr<query::result>> result_merger::get() {
+    if (_first) {
+        return std::move(_first);
+    }
+    if (!_writer) {
+        _writer = std::make_unique<writer>();
     }
 
-    std::move(partitions).end_partitions().end_query_result();
+    auto w = std::move(_writer);
+    std::move(w->partitions).end_partitions().end_query_result();
 
-    return make_foreign(make_lw_shared<query::result>(std::move(w), is_short_read, row_count, partition_count));
+    return make_foreign(make_lw_shared<query::result>(std::move(w->buf), _short_read, _row_count, _partition_count));
 }
 
 }
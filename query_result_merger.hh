@@ -28,25 +28,40 @@ namespace query {
 
 // Merges non-overlapping results into one
 // Implements @Reducer concept from distributed.hh
+//
+// Results are expected to be fed in order. Each result is appended to the
+// merged one as soon as it arrives and can be released right away, so that
+// the partial results don't have to be kept around until get() is called.
+// A lone result is passed through without copying.
 class result_merger {
-    std::vector<foreign_ptr<lw_shared_ptr<query::result>>> _partial;
+    struct writer;
+
+    foreign_ptr<lw_shared_ptr<query::result>> _first;
+    std::unique_ptr<writer> _writer;
     const uint64_t _max_rows;
     const uint32_t _max_partitions;
+    uint64_t _row_count = 0;
+    uint32_t _partition_count = 0;
+    short_read _short_read = short_read::no;
+private:
+    void append(const query::result& r);
 public:
-    explicit result_merger(uint64_t max_rows, uint32_t max_partitions)
-            : _max_rows(max_rows)
-            , _max_partitions(max_partitions)
-    { }
+    explicit result_merger(uint64_t max_rows, uint32_t max_partitions);
+    result_merger(result_merger&&) noexcept;
+    ~result_merger();
 
-    void reserve(size_t size) {
-        _partial.reserve(size);
-    }
+    void operator()(foreign_ptr<lw_shared_ptr<query::result>> r);
 
-    void operator()(foreign_ptr<lw_shared_ptr<query::result>> r) {
-        if (!_partial.empty() && _partial.back()->is_short_read()) {
-            return;
-        }
-        _partial.emplace_back(std::move(r));
+    // Rows and partitions merged so far, and whether the merged result is
+    // a short read.
+    uint64_t row_count() const;
+    uint32_t partition_count() const;
+    bool is_short_read() const;
+
+    // Whether the merged result is complete, i.e. it reached one of the
+    // limits or is a short read, so any further result will be ignored.
+    bool done() const {
+        return _short_read || _row_count >= _max_rows || _partition_count >= _max_partitions;
     }
 
     // FIXME: Eventually we should return a composite_query_result here
@@ -56,3 +71,4 @@ class result_merger {
 };
 
 }
+
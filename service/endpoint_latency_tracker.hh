@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gms/inet_address.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+
+namespace service {
+
+/**
+ * Tracks, per endpoint, the response time of the reads this shard sent to it
+ * (as an exponentially weighted moving average) and the number of its reads
+ * which are still outstanding.
+ *
+ * Endpoints are ranked the way C3 does it: the average response time is
+ * scaled by the cube of the queue size, so a replica which stalls (GC pause,
+ * compaction burst) and accumulates outstanding reads quickly falls behind
+ * the others, long before its moving average catches up, and recovers as
+ * soon as its queue drains.
+ */
+class endpoint_latency_tracker {
+public:
+    using clock_type = std::chrono::steady_clock;
+    using duration = std::chrono::microseconds;
+
+private:
+    // Weight of the newest sample in the moving average.
+    static constexpr double alpha = 0.25;
+    // The response time assumed for an endpoint none of whose reads completed
+    // yet, so that the ones queued on it still count against it.
+    static constexpr double unsampled_latency_us = 1000;
+
+    struct endpoint_state {
+        std::optional<double> ewma_us;
+        unsigned outstanding = 0;
+
+        double latency_us() const {
+            return ewma_us.value_or(outstanding ? unsampled_latency_us : 0);
+        }
+    };
+    std::unordered_map<gms::inet_address, endpoint_state> _endpoints;
+
+public:
+    void on_request(gms::inet_address ep) {
+        ++_endpoints[ep].outstanding;
+    }
+
+    void on_response(gms::inet_address ep, clock_type::duration latency) {
+        auto& s = _endpoints[ep];
+        auto sample = std::chrono::duration_cast<duration>(latency).count();
+        s.ewma_us = s.ewma_us ? alpha * sample + (1 - alpha) * *s.ewma_us : sample;
+        s.outstanding -= bool(s.outstanding);
+    }
+
+    // The response time a new read sent to ep is expected to have, given the
+    // reads already queued on it. Unknown endpoints are expected to be fast,
+    // so that they get probed.
+    duration expected_latency(gms::inet_address ep) const {
+        auto it = _endpoints.find(ep);
+        if (it == _endpoints.end()) {
+            return duration(0);
+        }
+        return duration(int64_t(it->second.latency_us() * (1 + it->second.outstanding)));
+    }
+
+    double score(gms::inet_address ep) const {
+        auto it = _endpoints.find(ep);
+        if (it == _endpoints.end()) {
+            return 0;
+        }
+        double q = 1 + it->second.outstanding;
+        return it->second.latency_us() * q * q * q;
+    }
+
+    // Stable-sorts the endpoints in [begin, end) by increasing score.
+    template <typename Iterator>
+    void sort(Iterator begin, Iterator end) const {
+        std::stable_sort(begin, end, [this] (gms::inet_address a, gms::inet_address b) {
+            return score(a) < score(b);
+        });
+    }
+
+    void remove_endpoint(gms::inet_address ep) {
+        _endpoints.erase(ep);
+    }
+};
+
+}
@@ -75,6 +75,9 @@ class query_pager {
     struct stats {
         // Total number of rows read by this pager, based on all pages it fetched
         size_t rows_read_total = 0;
+        // Whether the first page fetched by this pager was served from a
+        // page prefetched by a previous request of the same query
+        bool used_prefetched_page = false;
     };
 
 protected:
@@ -96,6 +99,7 @@ class query_pager {
     paging_state::replicas_per_token_range _last_replicas;
     std::optional<db::read_repair_decision> _query_read_repair_decision;
     uint64_t _rows_fetched_for_last_partition = 0;
+    bool _prefetch_looked_up = false;
     stats _stats;
 public:
     query_pager(schema_ptr s, shared_ptr<const cql3::selection::selection> selection,
@@ -149,6 +153,17 @@ class query_pager {
      */
     lw_shared_ptr<const paging_state> state() const;
 
+    /**
+     * Starts fetching, in the background, the page following the one
+     * fetched last. The result is parked in a shard-local, memory bounded
+     * cache, keyed by the query id and the current paging state, from
+     * which it is picked up by the pager serving the next request of the
+     * same query, if that request arrives on this shard.
+     *
+     * @return whether a prefetch was started.
+     */
+    bool prefetch_next_page(uint32_t page_size, db::timeout_clock::duration timeout);
+
     const stats& stats() const {
         return _stats;
     }
@@ -160,17 +175,21 @@ class query_pager {
     future<service::storage_proxy::coordinator_query_result>
     do_fetch_page(uint32_t page_size, gc_clock::time_point now, db::timeout_clock::time_point timeout);
 
+    // Restricts the command and the ranges to what is left to be read
+    // after the last fetched position.
+    void prepare_page(query::read_command& cmd, dht::partition_range_vector& ranges, uint32_t page_size) const;
+
     template<typename Visitor>
     requires query::ResultVisitor<Visitor>
     void handle_result(Visitor&& visitor,
                       const foreign_ptr<lw_shared_ptr<query::result>>& results,
                       uint32_t page_size, gc_clock::time_point now);
 
-    virtual uint64_t max_rows_to_fetch(uint32_t page_size) {
+    virtual uint64_t max_rows_to_fetch(uint32_t page_size) const {
         return std::min(_max, static_cast<uint64_t>(page_size));
     }
 
-    virtual void maybe_adjust_per_partition_limit(uint32_t page_size) const { }
+    virtual void maybe_adjust_per_partition_limit(query::read_command& cmd, uint32_t page_size) const { }
 };
 
 }
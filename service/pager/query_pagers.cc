@@ -46,8 +46,11 @@
 #include "cql3/restrictions/statement_restrictions.hh"
 #include "log.hh"
 #include "service/storage_proxy.hh"
+#include "db/consistency_level_validations.hh"
 #include "to_string.hh"
 
+#include <seastar/core/memory.hh>
+
 static logging::logger qlogger("paging");
 
 namespace service::pager {
@@ -60,6 +63,134 @@ struct noop_visitor {
     uint64_t accept_partition_end(const query::result_row_view& static_row) { return 0; }
 };
 
+// Pages prefetched on behalf of clients which opted in with the
+// SCYLLA_PAGE_PREFETCH protocol extension, waiting for the next request of
+// their query. Each page is bounded by the paging result size limit, and
+// the number of pages parked on a shard is bounded by a fraction of its
+// memory, so abandoned queries cannot pin an unbounded amount of results.
+class prefetched_page_cache {
+    struct entry {
+        lw_shared_ptr<const paging_state> position;
+        table_schema_version schema_version;
+        uint64_t row_limit;
+        uint32_t partition_limit;
+        query::partition_slice slice;
+        dht::partition_range_vector ranges;
+        db::consistency_level cl;
+        size_t memory;
+        lowres_clock::time_point expiry;
+        future<storage_proxy::coordinator_query_result> result;
+    };
+    std::unordered_map<utils::UUID, entry> _entries;
+    size_t _memory = 0;
+private:
+    static size_t max_memory() {
+        return memory::stats().total_memory() / 100;
+    }
+    void erase(std::unordered_map<utils::UUID, entry>::iterator it) {
+        _memory -= it->second.memory;
+        // Nobody is going to consume the page anymore, but the read
+        // itself may still fail and must not be reported as ignored.
+        (void)std::move(it->second.result).discard_result().handle_exception([] (std::exception_ptr) { });
+        _entries.erase(it);
+    }
+    void evict_expired() {
+        auto now = lowres_clock::now();
+        for (auto it = _entries.begin(); it != _entries.end();) {
+            auto next = std::next(it);
+            if (it->second.expiry <= now) {
+                erase(it);
+            }
+            it = next;
+        }
+    }
+    static bool same_position(const schema& s, const paging_state& a, const paging_state& b) {
+        auto same_ckey = [&] {
+            auto& ca = a.get_clustering_key();
+            auto& cb = b.get_clustering_key();
+            return bool(ca) == bool(cb) && (!ca || ca->equal(s, *cb));
+        };
+        return a.get_remaining() == b.get_remaining()
+                && a.get_rows_fetched_for_last_partition() == b.get_rows_fetched_for_last_partition()
+                && a.get_partition_key().equal(s, b.get_partition_key())
+                && same_ckey();
+    }
+    static bool same_row_ranges(const schema& s, const query::clustering_row_ranges& a, const query::clustering_row_ranges& b) {
+        auto cmp = [&s] (const clustering_key_prefix& a, const clustering_key_prefix& b) {
+            return a.equal(s, b) ? 0 : 1;
+        };
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [&] (const query::clustering_range& a, const query::clustering_range& b) {
+            return a.equal(b, cmp);
+        });
+    }
+    static bool same_slice(const schema& s, const query::partition_slice& a, const query::partition_slice& b) {
+        auto same_specific_ranges = [&] {
+            auto& ra = a.get_specific_ranges();
+            auto& rb = b.get_specific_ranges();
+            return bool(ra) == bool(rb) && (!ra || (ra->pk().equal(s, rb->pk()) && same_row_ranges(s, ra->ranges(), rb->ranges())));
+        };
+        auto same_filter = [] (const query::column_filter& a, const query::column_filter& b) {
+            return a.id == b.id && a.op == b.op && a.value == b.value;
+        };
+        auto& fa = a.get_row_filter();
+        auto& fb = b.get_row_filter();
+        return a.options.mask() == b.options.mask()
+                && a.static_columns == b.static_columns
+                && a.regular_columns == b.regular_columns
+                && a.partition_row_limit() == b.partition_row_limit()
+                && a.cql_format() == b.cql_format()
+                && same_row_ranges(s, a.default_row_ranges(), b.default_row_ranges())
+                && same_specific_ranges()
+                && std::equal(fa.begin(), fa.end(), fb.begin(), fb.end(), same_filter);
+    }
+    static bool same_ranges(const schema& s, const dht::partition_range_vector& a, const dht::partition_range_vector& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(), [cmp = dht::ring_position_comparator(s)] (const dht::partition_range& a, const dht::partition_range& b) {
+            return a.equal(b, cmp);
+        });
+    }
+public:
+    bool can_admit(utils::UUID query_uuid, size_t memory) {
+        evict_expired();
+        if (auto it = _entries.find(query_uuid); it != _entries.end()) {
+            erase(it);
+        }
+        return _memory + memory <= max_memory();
+    }
+    void insert(const schema& s, const query::read_command& cmd, const dht::partition_range_vector& ranges,
+            lw_shared_ptr<const paging_state> position, db::consistency_level cl,
+            db::timeout_clock::duration ttl, future<storage_proxy::coordinator_query_result> result) {
+        size_t memory = cmd.max_result_size->hard_limit;
+        _memory += memory;
+        _entries.emplace(cmd.query_uuid, entry{std::move(position), s.version(), cmd.get_row_limit(),
+                cmd.partition_limit, cmd.slice, ranges, cl, memory,
+                lowres_clock::now() + std::chrono::duration_cast<lowres_clock::duration>(ttl), std::move(result)});
+    }
+    // Returns the prefetched page for the command, if one was prefetched
+    // for exactly the same command and ranges, from the position the paging
+    // state points at.
+    std::optional<future<storage_proxy::coordinator_query_result>> take(const schema& s, const query::read_command& cmd,
+            const dht::partition_range_vector& ranges, const paging_state& state, db::consistency_level cl) {
+        auto it = _entries.find(state.get_query_uuid());
+        if (it == _entries.end()) {
+            return std::nullopt;
+        }
+        auto& e = it->second;
+        if (e.schema_version != s.version() || e.row_limit != cmd.get_row_limit()
+                || e.partition_limit != cmd.partition_limit || e.cl != cl
+                || e.expiry <= lowres_clock::now() || !same_position(s, *e.position, state)
+                || !same_slice(s, e.slice, cmd.slice) || !same_ranges(s, e.ranges, ranges)) {
+            erase(it);
+            return std::nullopt;
+        }
+        auto f = std::move(e.result);
+        _memory -= e.memory;
+        _entries.erase(it);
+        return f;
+    }
+};
+
+static thread_local prefetched_page_cache prefetched_pages;
+
 static bool has_clustering_keys(const schema& s, const query::read_command& cmd) {
     return s.clustering_key_size() > 0
             && !cmd.slice.options.contains<query::partition_slice::option::distinct>();
@@ -108,11 +239,32 @@ static bool has_clustering_keys(const schema& s, const query::read_command& cmd)
         }
         qlogger.trace("fetch_page query id {}", _cmd->query_uuid);
 
+        prepare_page(*_cmd, _ranges, page_size);
+
+        if (state && !_prefetch_looked_up) {
+            _prefetch_looked_up = true;
+            if (auto f = prefetched_pages.take(*_schema, *_cmd, _ranges, *state, _options.get_consistency())) {
+                qlogger.trace("fetch_page query id {}: using prefetched page", _cmd->query_uuid);
+                _stats.used_prefetched_page = true;
+                return std::move(*f);
+            }
+        }
+
+        auto ranges = _ranges;
+        auto command = ::make_lw_shared<query::read_command>(*_cmd);
+        return proxy.query(_schema,
+                std::move(command),
+                std::move(ranges),
+                _options.get_consistency(),
+                {timeout, _state.get_permit(), _state.get_client_state(), _state.get_trace_state(), std::move(_last_replicas), _query_read_repair_decision});
+    }
+
+    void query_pager::prepare_page(query::read_command& cmd, dht::partition_range_vector& ranges, uint32_t page_size) const {
         if (_last_pkey) {
             auto dpk = dht::decorate_key(*_schema, *_last_pkey);
             dht::ring_position lo(dpk);
 
-            auto reversed = _cmd->slice.options.contains<query::partition_slice::option::reversed>();
+            auto reversed = cmd.slice.options.contains<query::partition_slice::option::reversed>();
 
             qlogger.trace("PKey={}, CKey={}, reversed={}", dpk, _last_ckey, reversed);
 
@@ -167,40 +319,65 @@ static bool has_clustering_keys(const schema& s, const query::read_command& cmd)
 
             // If we have no clustering keys, it should mean we only have one row
             // per PK. Thus we can just bypass the last one.
-            modify_ranges(_ranges, lo, has_ck, dht::ring_position_comparator(*_schema));
+            modify_ranges(ranges, lo, has_ck, dht::ring_position_comparator(*_schema));
 
             if (has_ck) {
-                query::clustering_row_ranges row_ranges = _cmd->slice.default_row_ranges();
+                query::clustering_row_ranges row_ranges = cmd.slice.default_row_ranges();
                 clustering_key_prefix ckp = clustering_key_prefix::from_exploded(*_schema, _last_ckey->explode(*_schema));
                 query::trim_clustering_row_ranges_to(*_schema, row_ranges, ckp, reversed);
 
-                _cmd->slice.set_range(*_schema, *_last_pkey, row_ranges);
+                cmd.slice.set_range(*_schema, *_last_pkey, row_ranges);
             }
         }
 
         auto max_rows = max_rows_to_fetch(page_size);
 
         // We always need PK so we can determine where to start next.
-        _cmd->slice.options.set<query::partition_slice::option::send_partition_key>();
+        cmd.slice.options.set<query::partition_slice::option::send_partition_key>();
         // don't add empty bytes (cks) unless we have to
         if (_has_clustering_keys) {
-            _cmd->slice.options.set<
+            cmd.slice.options.set<
                     query::partition_slice::option::send_clustering_key>();
         }
-        _cmd->set_row_limit(max_rows);
-        maybe_adjust_per_partition_limit(page_size);
+        cmd.set_row_limit(max_rows);
+        maybe_adjust_per_partition_limit(cmd, page_size);
 
         qlogger.debug("Fetching {}, page size={}, max_rows={}",
-                _cmd->cf_id, page_size, max_rows
+                cmd.cf_id, page_size, max_rows
                 );
 
-        auto ranges = _ranges;
+    }
+
+    bool query_pager::prefetch_next_page(uint32_t page_size, db::timeout_clock::duration timeout) {
+        auto cl = _options.get_consistency();
+        if (_exhausted || db::is_serial_consistency(cl)) {
+            return false;
+        }
+        // Reversed queries are not limited to a single page worth of memory,
+        // keeping their pages around would be too expensive.
+        if (!_cmd->max_result_size || _cmd->max_result_size->hard_limit > query::result_memory_limiter::maximum_result_size) {
+            return false;
+        }
+        if (!prefetched_pages.can_admit(_cmd->query_uuid, _cmd->max_result_size->hard_limit)) {
+            return false;
+        }
         auto command = ::make_lw_shared<query::read_command>(*_cmd);
-        return proxy.query(_schema,
-                std::move(command),
-                std::move(ranges),
-                _options.get_consistency(),
-                {timeout, _state.get_permit(), _state.get_client_state(), _state.get_trace_state(), std::move(_last_replicas), _query_read_repair_decision});
+        auto ranges = _ranges;
+        command->is_first_page = query::is_first_page::no;
+        prepare_page(*command, ranges, page_size);
+
+        qlogger.trace("prefetch_page query id {}", command->query_uuid);
+        // The request which started the prefetch is gone by the time the next
+        // one picks the page up, so the read must not reference its state.
+        // It keeps the request's permit though, so that the memory it was
+        // admitted with stays taken until the page is read.
+        auto f = get_local_storage_proxy().query(_schema,
+                command,
+                ranges,
+                cl,
+                {db::timeout_clock::now() + timeout, _state.get_permit(), client_state::for_internal_calls(), nullptr, _last_replicas, _query_read_repair_decision});
+        prefetched_pages.insert(*_schema, *command, ranges, state(), cl, timeout, std::move(f));
+        return true;
     }
 
     future<> query_pager::fetch_page(cql3::selection::result_set_builder& builder, uint32_t page_size, gc_clock::time_point now, db::timeout_clock::time_point timeout) {
@@ -262,12 +439,12 @@ class filtering_query_pager : public query_pager {
     }
 
 protected:
-    virtual uint64_t max_rows_to_fetch(uint32_t page_size) override {
+    virtual uint64_t max_rows_to_fetch(uint32_t page_size) const override {
         return static_cast<uint64_t>(page_size);
     }
 
-    virtual void maybe_adjust_per_partition_limit(uint32_t page_size) const override {
-        _cmd->slice.set_partition_row_limit(page_size);
+    virtual void maybe_adjust_per_partition_limit(query::read_command& cmd, uint32_t page_size) const override {
+        cmd.slice.set_partition_row_limit(page_size);
     }
 };
 
@@ -32,11 +32,14 @@
 
 #include "utils/error_injection.hh"
 
+#include <seastar/core/memory.hh>
+
 namespace service::paxos {
 
 logging::logger paxos_state::logger("paxos");
 thread_local paxos_state::key_lock_map paxos_state::_paxos_table_lock;
 thread_local paxos_state::key_lock_map paxos_state::_coordinator_lock;
+thread_local paxos_state::state_cache paxos_state::_state_cache;
 
 paxos_state::key_lock_map::semaphore& paxos_state::key_lock_map::get_semaphore_for_key(const dht::token& key) {
     return _locks.try_emplace(key, 1).first->second;
@@ -49,6 +52,245 @@ void paxos_state::key_lock_map::release_semaphore_for_key(const dht::token& key)
     }
 }
 
+static gc_clock::time_point paxos_expiry(const schema& s) {
+    // Mirrors the TTL used for the paxos table writes, see db::system_keyspace.
+    if (s.paxos_grace_seconds().count() == 0) {
+        return gc_clock::time_point::max();
+    }
+    return gc_clock::now() + s.paxos_grace_seconds();
+}
+
+size_t paxos_state::state_cache::max_memory_usage() const {
+    return _max_memory_usage ? _max_memory_usage : memory::stats().total_memory() / 100;
+}
+
+paxos_state::state_cache::entry* paxos_state::state_cache::find(const schema& s, partition_key_view key) {
+    auto it = _entries.find(key_type(s.id(), to_bytes(key.representation())));
+    if (it == _entries.end()) {
+        return nullptr;
+    }
+    _lru.splice(_lru.begin(), _lru, it->second);
+    return &*it->second;
+}
+
+void paxos_state::state_cache::update_memory_usage(entry& e) {
+    auto proposal_size = [] (const std::optional<proposal>& p) {
+        return p ? p->update.representation().size() : 0;
+    };
+    _memory_usage -= e.memory_usage;
+    e.memory_usage = sizeof(entry) + e.key.second.size() + proposal_size(e.accepted_proposal) + proposal_size(e.most_recent_commit);
+    _memory_usage += e.memory_usage;
+}
+
+void paxos_state::state_cache::invalidate(entry* e) {
+    ++_generation;
+    if (!e) {
+        return;
+    }
+    _memory_usage -= e->memory_usage;
+    auto it = _entries.find(e->key);
+    _lru.erase(it->second);
+    _entries.erase(it);
+}
+
+void paxos_state::state_cache::evict() {
+    while (_memory_usage > max_memory_usage() && !_lru.empty()) {
+        auto& e = _lru.back();
+        _memory_usage -= e.memory_usage;
+        _entries.erase(e.key);
+        _lru.pop_back();
+    }
+}
+
+std::optional<paxos_state> paxos_state::state_cache::get(const schema& s, partition_key_view key) {
+    auto* e = find(s, key);
+    if (!e) {
+        return std::nullopt;
+    }
+    auto now = gc_clock::now();
+    paxos_state state;
+    if (e->promise_expiry > now) {
+        state._promised_ballot = e->promised_ballot;
+    }
+    if (e->accepted_proposal && e->accepted_expiry > now) {
+        state._accepted_proposal = e->accepted_proposal;
+    }
+    if (e->most_recent_commit && e->commit_expiry > now) {
+        state._most_recent_commit = e->most_recent_commit;
+    }
+    return state;
+}
+
+void paxos_state::state_cache::populate(const schema& s, partition_key_view key, const paxos_state& state, uint64_t generation) {
+    if (generation != _generation || find(s, key)) {
+        return;
+    }
+    // The load does not return the cells' timestamps. They are those of the
+    // ballots, and a missing proposal was erased by the most recent decision.
+    entry e;
+    e.key = key_type(s.id(), to_bytes(key.representation()));
+    e.promised_ballot = state._promised_ballot;
+    e.promise_ts = utils::UUID_gen::micros_timestamp(state._promised_ballot);
+    e.promise_expiry = state._expiry.promise;
+    if (state._most_recent_commit) {
+        e.most_recent_commit = state._most_recent_commit;
+        e.commit_ts = utils::UUID_gen::micros_timestamp(state._most_recent_commit->ballot);
+        e.commit_expiry = state._expiry.commit;
+    }
+    if (state._accepted_proposal) {
+        e.accepted_proposal = state._accepted_proposal;
+        e.accepted_ts = utils::UUID_gen::micros_timestamp(state._accepted_proposal->ballot);
+        e.accepted_expiry = state._expiry.accepted;
+    } else {
+        e.accepted_ts = e.commit_ts;
+    }
+    _lru.push_front(std::move(e));
+    _entries.emplace(_lru.front().key, _lru.begin());
+    update_memory_usage(_lru.front());
+    evict();
+}
+
+void paxos_state::state_cache::on_promise_saved(const schema& s, const partition_key& key, const utils::UUID& ballot) {
+    auto* e = find(s, key);
+    auto ts = utils::UUID_gen::micros_timestamp(ballot);
+    if (!e || (ts == e->promise_ts && ballot != e->promised_ballot)) {
+        // Either there is nothing to update or the table breaks the tie by
+        // comparing the values, which we do not follow.
+        invalidate(e);
+        return;
+    }
+    if (ts >= e->promise_ts) {
+        e->promised_ballot = ballot;
+        e->promise_ts = ts;
+        e->promise_expiry = paxos_expiry(s);
+    }
+}
+
+void paxos_state::state_cache::on_proposal_saved(const schema& s, const proposal& proposal) {
+    auto* e = find(s, proposal.update.key());
+    auto ts = utils::UUID_gen::micros_timestamp(proposal.ballot);
+    if (!e || (ts == e->promise_ts && proposal.ballot != e->promised_ballot)
+            || (ts == e->accepted_ts && (!e->accepted_proposal || proposal.ballot != e->accepted_proposal->ballot))) {
+        invalidate(e);
+        return;
+    }
+    auto expiry = paxos_expiry(s);
+    if (ts >= e->promise_ts) {
+        e->promised_ballot = proposal.ballot;
+        e->promise_ts = ts;
+        e->promise_expiry = expiry;
+    }
+    if (ts >= e->accepted_ts) {
+        e->accepted_proposal = proposal;
+        e->accepted_ts = ts;
+        e->accepted_expiry = expiry;
+    }
+    update_memory_usage(*e);
+    evict();
+}
+
+void paxos_state::state_cache::on_decision_saved(const schema& s, const proposal& decision) {
+    auto* e = find(s, decision.update.key());
+    auto ts = utils::UUID_gen::micros_timestamp(decision.ballot);
+    if (!e || (ts == e->commit_ts && (!e->most_recent_commit || decision.ballot != e->most_recent_commit->ballot))) {
+        invalidate(e);
+        return;
+    }
+    // Erasing the proposal wins over a proposal written with the same timestamp.
+    if (ts >= e->accepted_ts) {
+        e->accepted_proposal = std::nullopt;
+        e->accepted_ts = ts;
+    }
+    if (ts >= e->commit_ts) {
+        if (ts > e->commit_pruned_ts) {
+            e->most_recent_commit = decision;
+        } else {
+            e->most_recent_commit = proposal(decision.ballot, freeze(mutation(s.shared_from_this(), decision.update.key())));
+        }
+        e->commit_ts = ts;
+        e->commit_expiry = paxos_expiry(s);
+    }
+    update_memory_usage(*e);
+    evict();
+}
+
+void paxos_state::state_cache::on_decision_deleted(const schema& s, const partition_key& key, const utils::UUID& ballot) {
+    auto* e = find(s, key);
+    if (!e) {
+        ++_generation;
+        return;
+    }
+    auto ts = utils::UUID_gen::micros_timestamp(ballot);
+    e->commit_pruned_ts = std::max(e->commit_pruned_ts, ts);
+    if (e->most_recent_commit && ts >= e->commit_ts) {
+        // Only the value is deleted, the ballot of the most recent commit stays.
+        e->most_recent_commit = proposal(e->most_recent_commit->ballot, freeze(mutation(s.shared_from_this(), key)));
+        update_memory_usage(*e);
+    }
+}
+
+void paxos_state::state_cache::on_write_failed(const schema& s, partition_key_view key) {
+    invalidate(find(s, key));
+}
+
+future<paxos_state> paxos_state::load(schema_ptr s, partition_key_view key, gc_clock::time_point now, clock_type::time_point timeout) {
+    auto& stats = get_local_storage_proxy().get_stats();
+    if (auto state = _state_cache.get(*s, key)) {
+        ++stats.cas_replica_state_cache_hits;
+        return make_ready_future<paxos_state>(std::move(*state));
+    }
+    ++stats.cas_replica_state_cache_misses;
+    auto generation = _state_cache.generation();
+    return db::system_keyspace::load_paxos_state(key, s, now, timeout).then([s, key, generation] (paxos_state state) {
+        _state_cache.populate(*s, key, state, generation);
+        return state;
+    });
+}
+
+future<> paxos_state::save_promise(schema_ptr s, const partition_key& key, const utils::UUID& ballot, clock_type::time_point timeout) {
+    return db::system_keyspace::save_paxos_promise(*s, key, ballot, timeout).then_wrapped([s, key, ballot] (future<> f) {
+        if (f.failed()) {
+            _state_cache.on_write_failed(*s, key);
+        } else {
+            _state_cache.on_promise_saved(*s, key, ballot);
+        }
+        return f;
+    });
+}
+
+future<> paxos_state::save_proposal(schema_ptr s, const proposal& proposal, clock_type::time_point timeout) {
+    return db::system_keyspace::save_paxos_proposal(*s, proposal, timeout).then_wrapped([s, &proposal] (future<> f) {
+        if (f.failed()) {
+            _state_cache.on_write_failed(*s, proposal.update.key());
+        } else {
+            _state_cache.on_proposal_saved(*s, proposal);
+        }
+        return f;
+    });
+}
+
+future<> paxos_state::save_decision(schema_ptr s, const proposal& decision, clock_type::time_point timeout) {
+    return db::system_keyspace::save_paxos_decision(*s, decision, timeout).then_wrapped([s, &decision] (future<> f) {
+        if (f.failed()) {
+            _state_cache.on_write_failed(*s, decision.update.key());
+        } else {
+            _state_cache.on_decision_saved(*s, decision);
+        }
+        return f;
+    });
+}
+
+future<> paxos_state::delete_decision(schema_ptr s, const partition_key& key, const utils::UUID& ballot, clock_type::time_point timeout) {
+    return db::system_keyspace::delete_paxos_decision(*s, key, ballot, timeout).then_wrapped([s, key, ballot] (future<> f) {
+        if (f.failed()) {
+            _state_cache.on_write_failed(*s, key);
+        } else {
+            _state_cache.on_decision_deleted(*s, key, ballot);
+        }
+        return f;
+    });
+}
+
 future<prepare_response> paxos_state::prepare(tracing::trace_state_ptr tr_state, schema_ptr schema,
         const query::read_command& cmd, const partition_key& key, utils::UUID ballot,
         bool only_digest, query::digest_algorithm da, clock_type::time_point timeout) {
@@ -64,7 +306,7 @@ future<prepare_response> paxos_state::prepare(tracing::trace_state_ptr tr_state,
             // tombstone that hides any re-submit). See CASSANDRA-12043 for details.
             auto now_in_sec = utils::UUID_gen::unix_timestamp_in_sec(ballot);
 
-            auto f = db::system_keyspace::load_paxos_state(key, schema, gc_clock::time_point(now_in_sec), timeout);
+            auto f = load(schema, key, gc_clock::time_point(now_in_sec), timeout);
             return f.then([&cmd, token = std::move(token), &key, ballot, tr_state, schema, only_digest, da, timeout] (paxos_state state) {
                 // If received ballot is newer that the one we already accepted it has to be accepted as well,
                 // but we will return the previously accepted proposal so that the new coordinator will use it instead of
@@ -75,7 +317,7 @@ future<prepare_response> paxos_state::prepare(tracing::trace_state_ptr tr_state,
                     if (utils::get_local_injector().enter("paxos_error_before_save_promise")) {
                         return make_exception_future<prepare_response>(utils::injected_error("injected_error_before_save_promise"));
                     }
-                    auto f1 = futurize_invoke(db::system_keyspace::save_paxos_promise, *schema, std::ref(key), ballot, timeout);
+                    auto f1 = futurize_invoke(save_promise, schema, std::ref(key), ballot, timeout);
                     auto f2 = futurize_invoke([&] {
                         return do_with(dht::partition_range_vector({dht::partition_range::make_singular({token, key})}),
                                 [tr_state, schema, &cmd, only_digest, da, timeout] (const dht::partition_range_vector& prv) {
@@ -133,7 +375,7 @@ future<bool> paxos_state::accept(tracing::trace_state_ptr tr_state, schema_ptr s
         lc.start();
         return with_locked_key(token, timeout, [&proposal, schema, tr_state, timeout] () mutable {
             auto now_in_sec = utils::UUID_gen::unix_timestamp_in_sec(proposal.ballot);
-            auto f = db::system_keyspace::load_paxos_state(proposal.update.key(), schema, gc_clock::time_point(now_in_sec), timeout);
+            auto f = load(schema, proposal.update.key(), gc_clock::time_point(now_in_sec), timeout);
             return f.then([&proposal, tr_state, schema, timeout] (paxos_state state) {
                 // Accept the proposal if we promised to accept it or the proposal is newer than the one we promised.
                 // Otherwise the proposal was cutoff by another Paxos proposer and has to be rejected.
@@ -145,7 +387,7 @@ future<bool> paxos_state::accept(tracing::trace_state_ptr tr_state, schema_ptr s
                         return make_exception_future<bool>(utils::injected_error("injected_error_before_save_proposal"));
                     }
 
-                    return db::system_keyspace::save_paxos_proposal(*schema, proposal, timeout).then([] {
+                    return save_proposal(schema, proposal, timeout).then([] {
                         if (utils::get_local_injector().enter("paxos_error_after_save_proposal")) {
                             return make_exception_future<bool>(utils::injected_error("injected_error_after_save_proposal"));
                         }
@@ -218,7 +460,7 @@ future<> paxos_state::learn(schema_ptr schema, proposal decision, clock_type::ti
             // We don't need to lock the partition key if there is no gap between loading paxos
             // state and saving it, and here we're just blindly updating.
             return utils::get_local_injector().inject("paxos_timeout_after_save_decision", timeout, [&decision, schema, timeout] {
-                return db::system_keyspace::save_paxos_decision(*schema, decision, timeout);
+                return save_decision(schema, decision, timeout);
             });
         });
     }).finally([schema, lc] () mutable {
@@ -232,7 +474,7 @@ future<> paxos_state::prune(schema_ptr schema, const partition_key& key, utils::
         tracing::trace_state_ptr tr_state) {
     logger.debug("Delete paxos state for ballot {}", ballot);
     tracing::trace(tr_state, "Delete paxos state for ballot {}", ballot);
-    return db::system_keyspace::delete_paxos_decision(*schema, key, ballot, timeout);
+    return delete_decision(schema, key, ballot, timeout);
 }
 
 } // end of namespace "service::paxos"
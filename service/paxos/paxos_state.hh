@@ -44,7 +44,9 @@
 #include "log.hh"
 #include "digest_algorithm.hh"
 #include "db/timeout_clock.hh"
+#include "gc_clock.hh"
 #include <unordered_map>
+#include <list>
 #include "utils/UUID_gen.hh"
 #include "service/paxos/prepare_response.hh"
 
@@ -94,9 +96,94 @@ class paxos_state {
         return _paxos_table_lock.with_locked_key(key, timeout, std::move(func));
     }
 
+public:
+    // When the cells of the paxos table row a state was loaded from expire.
+    struct cell_expiry {
+        gc_clock::time_point promise = gc_clock::time_point::max();
+        gc_clock::time_point accepted = gc_clock::time_point::max();
+        gc_clock::time_point commit = gc_clock::time_point::max();
+    };
+
+    // A cache of the paxos table rows of recently used keys, local to the shard
+    // which owns the corresponding token range, so that prepare and accept do
+    // not have to read the paxos table. Every write still goes to the paxos
+    // table, and is applied to the cache only after it succeeded, following the
+    // same last-write-wins rules the table applies. All paxos table cells are
+    // written with the timestamp of the ballot they carry.
+    class state_cache {
+        using key_type = std::pair<utils::UUID, bytes>;
+        struct key_hash {
+            size_t operator()(const key_type& k) const {
+                return std::hash<utils::UUID>()(k.first) ^ std::hash<bytes_view>()(k.second);
+            }
+        };
+        struct entry {
+            key_type key;
+            utils::UUID promised_ballot = utils::UUID_gen::min_time_UUID(0);
+            api::timestamp_type promise_ts = api::missing_timestamp;
+            gc_clock::time_point promise_expiry = gc_clock::time_point::max();
+            std::optional<proposal> accepted_proposal;
+            api::timestamp_type accepted_ts = api::missing_timestamp;
+            gc_clock::time_point accepted_expiry = gc_clock::time_point::max();
+            std::optional<proposal> most_recent_commit;
+            api::timestamp_type commit_ts = api::missing_timestamp;
+            gc_clock::time_point commit_expiry = gc_clock::time_point::max();
+            // The timestamp of the last prune of the most recent commit value.
+            api::timestamp_type commit_pruned_ts = api::missing_timestamp;
+            size_t memory_usage = 0;
+        };
+        using lru_type = std::list<entry>;
+
+        lru_type _lru;
+        std::unordered_map<key_type, lru_type::iterator, key_hash> _entries;
+        size_t _memory_usage = 0;
+        // Zero stands for 1% of the shard's memory.
+        size_t _max_memory_usage = 0;
+        // Bumped by every write the cache could not follow. A load which
+        // started before a bump may have read stale data and is not cached.
+        uint64_t _generation = 0;
+
+        entry* find(const schema& s, partition_key_view key);
+        void update_memory_usage(entry& e);
+        void invalidate(entry* e);
+        void evict();
+        size_t max_memory_usage() const;
+    public:
+        state_cache() = default;
+        explicit state_cache(size_t max_memory_usage) : _max_memory_usage(max_memory_usage) {}
+        std::optional<paxos_state> get(const schema& s, partition_key_view key);
+        uint64_t generation() const {
+            return _generation;
+        }
+        size_t size() const {
+            return _entries.size();
+        }
+        size_t memory_usage() const {
+            return _memory_usage;
+        }
+        void populate(const schema& s, partition_key_view key, const paxos_state& state, uint64_t generation);
+        void on_promise_saved(const schema& s, const partition_key& key, const utils::UUID& ballot);
+        void on_proposal_saved(const schema& s, const proposal& proposal);
+        void on_decision_saved(const schema& s, const proposal& decision);
+        void on_decision_deleted(const schema& s, const partition_key& key, const utils::UUID& ballot);
+        // Called when a write of the key failed and may or may not have been applied.
+        void on_write_failed(const schema& s, partition_key_view key);
+    };
+
+private:
+    static thread_local state_cache _state_cache;
+
+    // Access to the paxos table through the cache.
+    static future<paxos_state> load(schema_ptr s, partition_key_view key, gc_clock::time_point now, clock_type::time_point timeout);
+    static future<> save_promise(schema_ptr s, const partition_key& key, const utils::UUID& ballot, clock_type::time_point timeout);
+    static future<> save_proposal(schema_ptr s, const proposal& proposal, clock_type::time_point timeout);
+    static future<> save_decision(schema_ptr s, const proposal& decision, clock_type::time_point timeout);
+    static future<> delete_decision(schema_ptr s, const partition_key& key, const utils::UUID& ballot, clock_type::time_point timeout);
+
     utils::UUID _promised_ballot = utils::UUID_gen::min_time_UUID(0);
     std::optional<proposal> _accepted_proposal;
     std::optional<proposal> _most_recent_commit;
+    cell_expiry _expiry;
 
 public:
 
@@ -111,10 +198,22 @@ class paxos_state {
 
     paxos_state() {}
 
-    paxos_state(utils::UUID promised, std::optional<proposal> accepted, std::optional<proposal> commit)
+    paxos_state(utils::UUID promised, std::optional<proposal> accepted, std::optional<proposal> commit, cell_expiry expiry = {})
         : _promised_ballot(std::move(promised))
         , _accepted_proposal(std::move(accepted))
-        , _most_recent_commit(std::move(commit)) {}
+        , _most_recent_commit(std::move(commit))
+        , _expiry(expiry) {}
+
+    const utils::UUID& promised_ballot() const {
+        return _promised_ballot;
+    }
+    const std::optional<proposal>& accepted_proposal() const {
+        return _accepted_proposal;
+    }
+    const std::optional<proposal>& most_recent_commit() const {
+        return _most_recent_commit;
+    }
+
     // Replica RPC endpoint for Paxos "prepare" phase.
     static future<prepare_response> prepare(tracing::trace_state_ptr tr_state, schema_ptr schema,
             const query::read_command& cmd, const partition_key& key, utils::UUID ballot,
@@ -77,6 +77,7 @@
 #include <boost/range/algorithm/min_element.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/intrusive/list.hpp>
+#include <boost/range/irange.hpp>
 #include "utils/latency.hh"
 #include "schema.hh"
 #include "schema_registry.hh"
@@ -84,6 +85,7 @@
 #include <seastar/util/lazy.hh>
 #include <seastar/core/metrics.hh>
 #include <seastar/core/execution_stage.hh>
+#include <cmath>
 #include "db/timeout_clock.hh"
 #include "multishard_mutation_query.hh"
 #include "database.hh"
@@ -124,6 +126,9 @@ using fbu = utils::fb_utilities;
 
 static inline
 query::digest_algorithm digest_algorithm(service::storage_proxy& proxy) {
+    if (proxy.features().cluster_supports_xxhash3_digest_algorithm()) {
+        return query::digest_algorithm::xxHash3;
+    }
     return proxy.features().cluster_supports_xxhash_digest_algorithm()
          ? query::digest_algorithm::xxHash
          : query::digest_algorithm::MD5;
@@ -1566,6 +1571,14 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of background read repairs"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
 
+        sm::make_total_operations("row_summary_read_repairs", read_repair_row_summary_repairs,
+                       sm::description("number of foreground read repairs which transferred only the rows the replicas disagreed on"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
+        sm::make_total_operations("row_summary_read_repair_fallbacks", read_repair_row_summary_fallbacks,
+                       sm::description("number of foreground read repairs which requested row summaries but fell back to transferring the whole result"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
         sm::make_total_operations("read_timeouts", read_timeouts._count,
                        sm::description("number of read request failed due to a timeout"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
@@ -1635,6 +1648,14 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("CAS read rounds issued only if previous value is missing on some replica"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
 
+        sm::make_total_operations("cas_background_learn", cas_background_learn,
+                       sm::description("how many times a CAS returned to the client without waiting for its decision to be learned"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
+        sm::make_total_operations("cas_batched", cas_batched,
+                       sm::description("how many CAS operations were decided by the Paxos round of another operation on the same key"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
         sm::make_histogram("cas_read_contention", sm::description("how many contended reads were encountered"),
                        {storage_proxy_stats::current_scheduling_group_label()},
                        [this]{ return cas_read_contention.get_histogram(1, 8);}),
@@ -1693,6 +1714,10 @@ void storage_proxy_stats::stats::register_stats() {
                        sm::description("number of remote digest read requests this Node received"),
                        {storage_proxy_stats::current_scheduling_group_label(), storage_proxy_stats::op_type_label("digest")}),
 
+        sm::make_total_operations("reads", replica_row_summary_reads,
+                       sm::description("number of remote row summary read requests this Node received"),
+                       {storage_proxy_stats::current_scheduling_group_label(), storage_proxy_stats::op_type_label("row_summary")}),
+
         sm::make_total_operations("cross_shard_ops", replica_cross_shard_ops,
                        sm::description("number of operations that crossed a shard boundary"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
@@ -1700,6 +1725,14 @@ void storage_proxy_stats::stats::register_stats() {
         sm::make_total_operations("cas_dropped_prune", cas_replica_dropped_prune,
                        sm::description("how many times a coordinator did not perfom prune after cas"),
                        {storage_proxy_stats::current_scheduling_group_label()}),
+
+        sm::make_total_operations("cas_state_cache_hits", cas_replica_state_cache_hits,
+                       sm::description("how many times the paxos state of a key was found in the in-memory cache"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
+
+        sm::make_total_operations("cas_state_cache_misses", cas_replica_state_cache_misses,
+                       sm::description("how many times the paxos state of a key was read from the paxos table"),
+                       {storage_proxy_stats::current_scheduling_group_label()}),
     });
 }
 
@@ -3410,6 +3443,15 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     }
 
 protected:
+    // Accounts the request made by func to ep in the proxy's endpoint latency tracker.
+    template <typename Func>
+    futurize_t<std::invoke_result_t<Func>> track_latency(gms::inet_address ep, Func&& func) {
+        _proxy->_endpoint_latency_tracker.on_request(ep);
+        auto start = endpoint_latency_tracker::clock_type::now();
+        return futurize_invoke(std::forward<Func>(func)).finally([proxy = _proxy, ep, start] {
+            proxy->_endpoint_latency_tracker.on_response(ep, endpoint_latency_tracker::clock_type::now() - start);
+        });
+    }
     future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> make_mutation_data_request(lw_shared_ptr<query::read_command> cmd, gms::inet_address ep, clock_type::time_point timeout) {
         ++_proxy->get_stats().mutation_data_read_attempts.get_ep_stat(ep);
         if (fbu::is_me(ep)) {
@@ -3458,9 +3500,21 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
             });
         }
     }
+    future<partition_row_summary> make_row_summary_request(gms::inet_address ep, clock_type::time_point timeout) {
+        if (fbu::is_me(ep)) {
+            tracing::trace(_trace_state, "read_row_summary: querying locally");
+            return _proxy->query_row_summary_locally(_schema, _cmd, _partition_range, timeout, _trace_state);
+        } else {
+            tracing::trace(_trace_state, "read_row_summary: sending a message to /{}", ep);
+            return _proxy->_messaging.send_read_row_summary(netw::messaging_service::msg_addr{ep, 0}, timeout, *_cmd, _partition_range).then([this, ep] (partition_row_summary summary) {
+                tracing::trace(_trace_state, "read_row_summary: got response from /{}", ep);
+                return summary;
+            });
+        }
+    }
     future<> make_mutation_data_requests(lw_shared_ptr<query::read_command> cmd, data_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         return parallel_for_each(begin, end, [this, &cmd, resolver = std::move(resolver), timeout] (gms::inet_address ep) {
-            return make_mutation_data_request(cmd, ep, timeout).then_wrapped([this, resolver, ep] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> f) {
+            return track_latency(ep, [&] { return make_mutation_data_request(cmd, ep, timeout); }).then_wrapped([this, resolver, ep] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> f) {
                 try {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<1>(v));
@@ -3475,7 +3529,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     }
     future<> make_data_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout, bool want_digest) {
         return parallel_for_each(begin, end, [this, resolver = std::move(resolver), timeout, want_digest] (gms::inet_address ep) {
-            return make_data_request(ep, timeout, want_digest).then_wrapped([this, resolver, ep] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
+            return track_latency(ep, [&] { return make_data_request(ep, timeout, want_digest); }).then_wrapped([this, resolver, ep] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
                 try {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<1>(v));
@@ -3491,7 +3545,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     }
     future<> make_digest_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         return parallel_for_each(begin, end, [this, resolver = std::move(resolver), timeout] (gms::inet_address ep) {
-            return make_digest_request(ep, timeout).then_wrapped([this, resolver, ep] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature>> f) {
+            return track_latency(ep, [&] { return make_digest_request(ep, timeout); }).then_wrapped([this, resolver, ep] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature>> f) {
                 try {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<2>(v));
@@ -3616,6 +3670,101 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
         reconcile(cl, timeout, _cmd);
     }
 
+    bool can_reconcile_with_row_summaries(const query::result& data) const {
+        return can_repair_with_row_summaries(*_cmd, _partition_range, data.buf().size(),
+                _proxy->features().cluster_supports_row_summary_read_repair() && _proxy->_db.local().get_config().read_repair_row_summaries());
+    }
+
+    void fall_back_to_reconcile(db::consistency_level cl, storage_proxy::clock_type::time_point timeout) {
+        _proxy->get_stats().read_repair_row_summary_fallbacks++;
+        reconcile(cl, timeout);
+    }
+
+    // Repairs a digest mismatch of a single-partition read by transferring
+    // only the rows the replicas disagree on, as told by per-row hashes, and
+    // then repeats the read. Falls back to reconcile() whenever the summaries
+    // can't locate the difference or the replicas still disagree afterwards.
+    void reconcile_with_row_summaries(db::consistency_level cl, storage_proxy::clock_type::time_point timeout) {
+        adjust_targets_for_reconciliation();
+        if (_targets.size() < 2) {
+            fall_back_to_reconcile(cl, timeout);
+            return;
+        }
+        auto exec = shared_from_this();
+        auto summaries = make_lw_shared<std::vector<partition_row_summary>>(_targets.size());
+
+        // Waited on indirectly.
+        (void)parallel_for_each(boost::irange<size_t>(0, _targets.size()), [this, summaries, timeout] (size_t i) {
+            auto ep = _targets[i];
+            return track_latency(ep, [&] { return make_row_summary_request(ep, timeout); }).then([summaries, i] (partition_row_summary summary) {
+                (*summaries)[i] = std::move(summary);
+            });
+        }).then_wrapped([this, exec, summaries, cl, timeout] (future<> f) {
+            if (f.failed()) {
+                slogger.debug("Failed to read row summaries, reconciling the whole result: {}", f.get_exception());
+                fall_back_to_reconcile(cl, timeout);
+                return;
+            }
+            auto ranges = divergent_rows(*_schema, *summaries);
+            if (!ranges) {
+                fall_back_to_reconcile(cl, timeout);
+                return;
+            }
+            tracing::trace(_trace_state, "Repairing {} divergent rows found by row summaries", ranges->size());
+            repair_rows(cl, timeout, make_row_repair_command(*_schema, *_cmd, _partition_range.start()->value().as_decorated_key().key(),
+                    std::move(*ranges)));
+        });
+    }
+
+    void repair_rows(db::consistency_level cl, storage_proxy::clock_type::time_point timeout, lw_shared_ptr<query::read_command> cmd) {
+        data_resolver_ptr data_resolver = ::make_shared<data_read_resolver>(_schema, cl, _targets.size(), timeout);
+        auto exec = shared_from_this();
+
+        // Waited on indirectly.
+        (void)make_mutation_data_requests(cmd, data_resolver, _targets.begin(), _targets.end(), timeout).finally([exec]{});
+
+        // Waited on indirectly.
+        (void)data_resolver->done().then([this, exec, data_resolver, cmd] {
+            data_resolver->resolve(_schema, *cmd, query::max_rows, query::max_rows, query::max_partitions);
+            return _proxy->schedule_repair(data_resolver->get_diffs_for_repair(), _cl, _trace_state, _permit);
+        }).then_wrapped([this, exec, cl, timeout] (future<> f) {
+            if (f.failed()) {
+                slogger.debug("Failed to repair divergent rows, reconciling the whole result: {}", f.get_exception());
+                fall_back_to_reconcile(cl, timeout);
+                return;
+            }
+            read_after_row_repair(cl, timeout);
+        });
+    }
+
+    void read_after_row_repair(db::consistency_level cl, storage_proxy::clock_type::time_point timeout) {
+        digest_resolver_ptr digest_resolver = ::make_shared<digest_read_resolver>(_schema, _cl, _block_for,
+                db::is_datacenter_local(_cl) ? db::count_local_endpoints(_targets): _targets.size(), timeout);
+        digest_resolver->add_wait_targets(_targets.size());
+        auto exec = shared_from_this();
+
+        auto f_data = futurize_invoke([&] { return make_data_requests(digest_resolver, _targets.begin(), _targets.begin() + 1, timeout, true); });
+        auto f_digest = futurize_invoke([&] { return make_digest_requests(digest_resolver, _targets.begin() + 1, _targets.end(), timeout); });
+        // Waited on indirectly.
+        (void)when_all_succeed(std::move(f_data), std::move(f_digest)).discard_result().handle_exception([] (auto&&) { }).finally([exec] {});
+
+        // Waited on indirectly.
+        (void)digest_resolver->has_cl().then_wrapped([this, exec, cl, timeout] (future<digest_read_result> f) {
+            try {
+                auto&& [result, digests_match] = f.get0();
+                if (digests_match) {
+                    _proxy->get_stats().read_repair_row_summary_repairs++;
+                    _result_promise.set_value(std::move(result));
+                    on_read_resolved();
+                    return;
+                }
+            } catch (...) {
+                slogger.debug("Failed to read after repairing divergent rows, reconciling the whole result: {}", std::current_exception());
+            }
+            fall_back_to_reconcile(cl, timeout);
+        });
+    }
+
 public:
     virtual future<foreign_ptr<lw_shared_ptr<query::result>>> execute(storage_proxy::clock_type::time_point timeout) {
         digest_resolver_ptr digest_resolver = ::make_shared<digest_read_resolver>(_schema, _cl, _block_for,
@@ -3655,7 +3804,11 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
                             exec->_targets.erase(i, exec->_targets.end());
                         }
                     }
-                    exec->reconcile(exec->_cl, timeout);
+                    if (exec->can_reconcile_with_row_summaries(*result)) {
+                        exec->reconcile_with_row_summaries(exec->_cl, timeout);
+                    } else {
+                        exec->reconcile(exec->_cl, timeout);
+                    }
                     exec->_proxy->get_stats().read_repair_repaired_blocking++;
                 }
             } catch (...) {
@@ -3710,6 +3863,9 @@ class always_speculating_read_executor : public abstract_read_executor {
 
 // this executor sends request to an additional replica after some time below timeout
 class speculating_read_executor : public abstract_read_executor {
+    // How much slower than the speculation delay a replica is expected to
+    // respond before we stop waiting for it at all.
+    static constexpr int degraded_replica_latency_factor = 4;
     timer<storage_proxy::clock_type> _speculate_timer;
 public:
     using abstract_read_executor::abstract_read_executor;
@@ -3735,6 +3891,20 @@ class speculating_read_executor : public abstract_read_executor {
         auto t = (sr.get_type() == speculative_retry::type::PERCENTILE) ?
             std::min(_cf->get_coordinator_read_latency_percentile(sr.get_value()), std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2)) :
             std::chrono::milliseconds(unsigned(sr.get_value()));
+        if (_proxy->get_db().local().get_config().latency_aware_read_balancing()) {
+            // If one of the replicas we wait for is expected to be much slower
+            // than the delay, e.g. because its reads are piling up, waiting for
+            // the delay to expire only adds to the latency. Speculate right away.
+            auto& tracker = _proxy->_endpoint_latency_tracker;
+            auto slowest = boost::accumulate(boost::make_iterator_range(_targets.begin(), _targets.end() - 1),
+                    endpoint_latency_tracker::duration(0), [&tracker] (endpoint_latency_tracker::duration d, gms::inet_address ep) {
+                return std::max(d, tracker.expected_latency(ep));
+            });
+            if (slowest > t * degraded_replica_latency_factor) {
+                tracing::trace(_trace_state, "Speculating immediately, expected latency of the slowest replica is {}us", slowest.count());
+                t = std::chrono::milliseconds(0);
+            }
+        }
         _speculate_timer.arm(t);
 
         // if CL + RR result in covering all replicas, getReadExecutor forces AlwaysSpeculating.  So we know
@@ -3809,6 +3979,13 @@ ::shared_ptr<abstract_read_executor> storage_proxy::get_read_executor(lw_shared_
     // orders the list by proximity to the local endpoint.
     is_read_non_local |= !all_replicas.empty() && all_replicas.front() != utils::fb_utilities::get_broadcast_address();
 
+    if (_db.local().get_config().latency_aware_read_balancing()) {
+        // Order the replicas of the local datacenter, which come first, by
+        // their observed latency and queue size rather than just proximity.
+        auto local_end = std::find_if_not(all_replicas.begin(), all_replicas.end(), db::is_local);
+        _endpoint_latency_tracker.sort(all_replicas.begin(), local_end);
+    }
+
     auto cf = _db.local().find_column_family(schema).shared_from_this();
     std::vector<gms::inet_address> target_replicas = db::filter_for_query(cl, ks, all_replicas, preferred_endpoints, repair_decision,
             retry_type == speculative_retry::type::NONE ? nullptr : &extra_replica,
@@ -3914,86 +4091,194 @@ void storage_proxy::handle_read_error(std::exception_ptr eptr, bool range) {
     }
 }
 
+// Feeds the results of a round of reads to the merger shared by all
+// rounds of a singular query or a range scan.
+// Implements @Reducer concept from distributed.hh
+struct shared_result_merger {
+    lw_shared_ptr<query::result_merger> merger;
+
+    void operator()(foreign_ptr<lw_shared_ptr<query::result>> r) {
+        (*merger)(std::move(r));
+    }
+};
+
+// Number of partitions of a singular (IN) query to read in the next round,
+// given the rows and live partitions returned by the `queried` partitions read
+// so far. Queries without a limit read all of their partitions in one round.
+static size_t singular_query_round_size(uint64_t remaining_row_count, uint32_t remaining_partition_count,
+        uint64_t rows, uint32_t partitions, size_t queried, size_t left) {
+    auto per_partition = [queried] (double found) {
+        return queried ? found / queried : 1.0;
+    };
+    auto needed = [] (double remaining, double per_partition) {
+        return per_partition > 0 ? remaining / per_partition : std::numeric_limits<double>::infinity();
+    };
+    auto n = std::min(needed(remaining_row_count, per_partition(rows)), needed(remaining_partition_count, per_partition(partitions)));
+    // Read some extra partitions to absorb the variance between them, like
+    // range scans do, so that the limit is likely reached in a single round.
+    n = std::ceil(n * 1.1);
+    return size_t(std::min(std::max(n, 1.0), double(left)));
+}
+
 future<storage_proxy::coordinator_query_result>
 storage_proxy::query_singular(lw_shared_ptr<query::read_command> cmd,
         dht::partition_range_vector&& partition_ranges,
         db::consistency_level cl,
         storage_proxy::coordinator_query_options query_options) {
-    std::vector<std::pair<::shared_ptr<abstract_read_executor>, dht::token_range>> exec;
-    exec.reserve(partition_ranges.size());
-
-    schema_ptr schema = local_schema_registry().get(cmd->schema_version);
-
-    db::read_repair_decision repair_decision = query_options.read_repair_decision
-        ? *query_options.read_repair_decision : new_read_repair_decision(*schema);
-
-    // Update reads_coordinator_outside_replica_set once per request,
-    // not once per partition.
-    bool is_read_non_local = false;
-
     for (auto&& pr: partition_ranges) {
         if (!pr.is_singular()) {
             throw std::runtime_error("mixed singular and non singular range are not supported");
         }
-
-        auto token_range = dht::token_range::make_singular(pr.start()->value().token());
-        auto it = query_options.preferred_replicas.find(token_range);
-        const auto replicas = it == query_options.preferred_replicas.end()
-            ? std::vector<gms::inet_address>{} : replica_ids_to_endpoints(_token_metadata, it->second);
-
-        auto read_executor = get_read_executor(cmd, schema, std::move(pr), cl, repair_decision,
-                                               query_options.trace_state, replicas, is_read_non_local,
-                                               query_options.permit);
-
-        exec.emplace_back(read_executor, std::move(token_range));
-    }
-    if (is_read_non_local) {
-        get_stats().reads_coordinator_outside_replica_set++;
     }
 
-    query::result_merger merger(cmd->get_row_limit(), cmd->partition_limit);
-    merger.reserve(exec.size());
+    schema_ptr schema = local_schema_registry().get(cmd->schema_version);
+
+    db::read_repair_decision repair_decision = query_options.read_repair_decision
+        ? *query_options.read_repair_decision : new_read_repair_decision(*schema);
 
+    auto merger = make_lw_shared<query::result_merger>(cmd->get_row_limit(), cmd->partition_limit);
     auto used_replicas = make_lw_shared<replicas_per_token_range>();
 
-    auto f = ::map_reduce(exec.begin(), exec.end(), [p = shared_from_this(), timeout = query_options.timeout(*this), used_replicas] (
-                std::pair<::shared_ptr<abstract_read_executor>, dht::token_range>& executor_and_token_range) {
-        auto& [rex, token_range] = executor_and_token_range;
-        utils::latency_counter lc;
-        lc.start();
-        return rex->execute(timeout).then_wrapped([p = std::move(p), lc, rex, used_replicas, token_range = std::move(token_range)] (
-                    future<foreign_ptr<lw_shared_ptr<query::result>>> f) mutable {
-            if (!f.failed()) {
-                used_replicas->emplace(std::move(token_range), endpoints_to_replica_ids(p->_token_metadata, rex->used_targets()));
+    struct singular_query_state {
+        dht::partition_range_vector partition_ranges;
+        coordinator_query_options query_options;
+        size_t next = 0;
+        // Update reads_coordinator_outside_replica_set once per request,
+        // not once per partition.
+        bool is_read_non_local = false;
+    };
+
+    // The partitions are read in rounds, in request order, and the results
+    // are merged as they arrive. Once the merged result reaches the row or
+    // partition limit, or is short, the partitions which are left would be
+    // dropped by the merger anyway, so they are not read at all.
+    auto f = do_with(singular_query_state{std::move(partition_ranges), std::move(query_options)},
+            [this, p = shared_from_this(), cmd, cl, schema, repair_decision, merger, used_replicas] (singular_query_state& st) {
+        return repeat([this, p, &st, cmd, cl, schema, repair_decision, merger, used_replicas] {
+            auto n = singular_query_round_size(cmd->get_row_limit() - merger->row_count(), cmd->partition_limit - merger->partition_count(),
+                    merger->row_count(), merger->partition_count(), st.next, st.partition_ranges.size() - st.next);
+
+            std::vector<std::pair<::shared_ptr<abstract_read_executor>, dht::token_range>> exec;
+            exec.reserve(n);
+            for (auto end = st.next + n; st.next != end; ++st.next) {
+                auto& pr = st.partition_ranges[st.next];
+                auto token_range = dht::token_range::make_singular(pr.start()->value().token());
+                auto it = st.query_options.preferred_replicas.find(token_range);
+                const auto replicas = it == st.query_options.preferred_replicas.end()
+                    ? std::vector<gms::inet_address>{} : replica_ids_to_endpoints(_token_metadata, it->second);
+
+                auto read_executor = get_read_executor(cmd, schema, std::move(pr), cl, repair_decision,
+                                                       st.query_options.trace_state, replicas, st.is_read_non_local,
+                                                       st.query_options.permit);
+
+                exec.emplace_back(read_executor, std::move(token_range));
             }
-            if (lc.is_start()) {
-                rex->get_cf()->add_coordinator_read_latency(lc.stop().latency());
+
+            return do_with(std::move(exec), [p, &st, merger, used_replicas] (std::vector<std::pair<::shared_ptr<abstract_read_executor>, dht::token_range>>& exec) {
+                // hold onto exec until read is complete
+                return ::map_reduce(exec.begin(), exec.end(), [p, timeout = st.query_options.timeout(*p), used_replicas] (
+                            std::pair<::shared_ptr<abstract_read_executor>, dht::token_range>& executor_and_token_range) {
+                    auto& [rex, token_range] = executor_and_token_range;
+                    utils::latency_counter lc;
+                    lc.start();
+                    return rex->execute(timeout).then_wrapped([p = std::move(p), lc, rex, used_replicas, token_range = token_range] (
+                                future<foreign_ptr<lw_shared_ptr<query::result>>> f) mutable {
+                        if (!f.failed()) {
+                            used_replicas->emplace(std::move(token_range), endpoints_to_replica_ids(p->_token_metadata, rex->used_targets()));
+                        }
+                        if (lc.is_start()) {
+                            rex->get_cf()->add_coordinator_read_latency(lc.stop().latency());
+                        }
+                        return std::move(f);
+                    });
+                }, shared_result_merger{merger});
+            }).then([&st, merger] {
+                return stop_iteration(merger->done() || st.next == st.partition_ranges.size());
+            });
+        }).finally([p, &st] {
+            if (st.is_read_non_local) {
+                p->get_stats().reads_coordinator_outside_replica_set++;
             }
-            return std::move(f);
         });
-    }, std::move(merger));
+    });
 
-    return f.then_wrapped([exec = std::move(exec),
-            p = shared_from_this(),
+    return f.then_wrapped([p = shared_from_this(),
+            merger,
             used_replicas,
-            repair_decision] (future<foreign_ptr<lw_shared_ptr<query::result>>> f) {
+            repair_decision] (future<> f) {
         if (f.failed()) {
             auto eptr = f.get_exception();
-            // hold onto exec until read is complete
             p->handle_read_error(eptr, false);
             return make_exception_future<storage_proxy::coordinator_query_result>(eptr);
         }
-        return make_ready_future<coordinator_query_result>(coordinator_query_result(std::move(f.get0()), std::move(*used_replicas), repair_decision));
+        return make_ready_future<coordinator_query_result>(coordinator_query_result(merger->get(), std::move(*used_replicas), repair_decision));
     });
 }
 
+int range_scan_ranges_needed(uint64_t remaining_row_count, uint32_t remaining_partition_count,
+        double rows_per_range, double partitions_per_range) {
+    auto needed = [] (double remaining, double per_range) {
+        return per_range > 0 ? remaining / per_range : std::numeric_limits<double>::infinity();
+    };
+    auto ranges = std::min(needed(remaining_row_count, rows_per_range), needed(remaining_partition_count, partitions_per_range));
+    // Query some extra ranges to absorb the variance between ranges, so that
+    // the page is likely to be filled in a single round.
+    ranges = std::ceil(ranges * 1.1);
+    return int(std::clamp(ranges, 1.0, double(max_range_scan_concurrency_factor)));
+}
+
+int first_range_scan_concurrency_factor(uint64_t row_limit, uint32_t partition_limit,
+        double rows_per_range, double partitions_per_range) {
+    if (partitions_per_range <= 0) {
+        return 1;
+    }
+    return std::min(range_scan_ranges_needed(row_limit, partition_limit, rows_per_range, partitions_per_range),
+            max_first_range_scan_concurrency_factor);
+}
+
+int next_range_scan_concurrency_factor(const range_scan_progress& progress, int concurrency_factor,
+        uint64_t remaining_row_count, uint32_t remaining_partition_count) {
+    if (!progress.rows && !progress.partitions) {
+        // Nothing was found so far, the table is sparse (or the ranges we
+        // read so far were empty). Widen the scan quickly.
+        return std::min(concurrency_factor * 4, max_range_scan_concurrency_factor);
+    }
+    return range_scan_ranges_needed(remaining_row_count, remaining_partition_count,
+            double(progress.rows) / progress.ranges, double(progress.partitions) / progress.ranges);
+}
+
+// Estimated number of rows and partitions in a vnode range, from the data
+// of the table on this shard. Both are 0 if this node holds no data for the
+// table.
+struct range_scan_density {
+    double rows_per_range = 0;
+    double partitions_per_range = 0;
+};
+
+static range_scan_density estimate_range_scan_density(column_family& cf, const keyspace& ks, const locator::token_metadata& tm) {
+    uint64_t sstable_partitions = cf.estimated_sstable_partitions();
+    uint64_t memtable_partitions = cf.active_memtable().partition_count();
+    auto partitions = sstable_partitions + memtable_partitions;
+    auto local_tokens = tm.get_tokens(utils::fb_utilities::get_broadcast_address()).size();
+    auto rf = ks.get_replication_strategy().get_replication_factor();
+    if (!partitions || !local_tokens || !rf) {
+        return {};
+    }
+    // Assume partitions in the memtable are as wide as those in sstables.
+    double rows_per_partition = sstable_partitions ? double(cf.estimated_sstable_rows()) / sstable_partitions : 1;
+    // Every node replicates rf ranges per token it owns, spread across all shards.
+    double partitions_per_range = double(partitions) * smp::count / (local_tokens * rf);
+    return range_scan_density{partitions_per_range * std::max(rows_per_partition, 1.0), partitions_per_range};
+}
+
 future<query_partition_key_range_concurrent_result>
 storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::time_point timeout,
-        std::vector<foreign_ptr<lw_shared_ptr<query::result>>>&& results,
+        lw_shared_ptr<query::result_merger> merger,
         lw_shared_ptr<query::read_command> cmd,
         db::consistency_level cl,
         query_ranges_to_vnodes_generator&& ranges_to_vnodes,
         int concurrency_factor,
+        range_scan_progress progress,
         tracing::trace_state_ptr trace_state,
         uint64_t remaining_row_count,
         uint32_t remaining_partition_count,
@@ -4021,6 +4306,7 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
     // eventualy zero out resulting in an infinite recursion. This line makes sure that concurrency factor is never
     // get stuck on 0 and never increased too much if the number of results remains small.
     concurrency_factor = std::max(size_t(1), ranges.size());
+    progress.ranges += ranges.size();
 
     while (i != ranges.end()) {
         dht::partition_range& range = *i;
@@ -4106,32 +4392,42 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
         ranges_per_exec.emplace(exec.back().get(), std::move(merged_ranges));
     }
 
-    query::result_merger merger(cmd->get_row_limit(), cmd->partition_limit);
-    merger.reserve(exec.size());
+    const auto rows_before = merger->row_count();
+    const auto partitions_before = merger->partition_count();
 
+    // Results of all rounds are appended to the same merger as they arrive,
+    // so each replica result is released as soon as it is merged and the
+    // rounds don't need to be merged again once the scan is complete.
     auto f = ::map_reduce(exec.begin(), exec.end(), [timeout] (::shared_ptr<abstract_read_executor>& rex) {
         return rex->execute(timeout);
-    }, std::move(merger));
+    }, shared_result_merger{merger});
 
     return f.then([p,
             exec = std::move(exec),
-            results = std::move(results),
+            merger,
+            rows_before,
+            partitions_before,
             ranges_to_vnodes = std::move(ranges_to_vnodes),
             cl,
             cmd,
             concurrency_factor,
+            progress,
             timeout,
             remaining_row_count,
             remaining_partition_count,
             trace_state = std::move(trace_state),
             preferred_replicas = std::move(preferred_replicas),
             ranges_per_exec = std::move(ranges_per_exec),
-            permit = std::move(permit)] (foreign_ptr<lw_shared_ptr<query::result>>&& result) mutable {
-        result->ensure_counts();
-        remaining_row_count -= result->row_count().value();
-        remaining_partition_count -= result->partition_count().value();
-        results.emplace_back(std::move(result));
-        if (ranges_to_vnodes.empty() || !remaining_row_count || !remaining_partition_count) {
+            permit = std::move(permit)] () mutable {
+        const auto rows = merger->row_count() - rows_before;
+        const auto partitions = merger->partition_count() - partitions_before;
+        remaining_row_count -= rows;
+        remaining_partition_count -= partitions;
+        progress.rows += rows;
+        progress.partitions += partitions;
+        // Nothing past a short read makes it into the result, so there is
+        // no point in querying further ranges.
+        if (ranges_to_vnodes.empty() || !remaining_row_count || !remaining_partition_count || merger->is_short_read()) {
             auto used_replicas = replicas_per_token_range();
             for (auto& e : exec) {
                 // We add used replicas in separate per-vnode entries even if
@@ -4144,12 +4440,17 @@ storage_proxy::query_partition_key_range_concurrent(storage_proxy::clock_type::t
                     used_replicas.emplace(std::move(r), replica_ids);
                 }
             }
-            return make_ready_future<query_partition_key_range_concurrent_result>(query_partition_key_range_concurrent_result{std::move(results), std::move(used_replicas)});
+            return make_ready_future<query_partition_key_range_concurrent_result>(query_partition_key_range_concurrent_result{merger->get(), std::move(used_replicas)});
         } else {
             cmd->set_row_limit(remaining_row_count);
             cmd->partition_limit = remaining_partition_count;
-            return p->query_partition_key_range_concurrent(timeout, std::move(results), cmd, cl, std::move(ranges_to_vnodes),
-                    concurrency_factor * 2, std::move(trace_state), remaining_row_count, remaining_partition_count, std::move(preferred_replicas), std::move(permit));
+            auto next_concurrency_factor = next_range_scan_concurrency_factor(progress, concurrency_factor, remaining_row_count, remaining_partition_count);
+            slogger.debug("Fetched {} rows from {} ranges so far; remaining rows: {}, next concurrent range requests: {}",
+                    progress.rows, progress.ranges, remaining_row_count, next_concurrency_factor);
+            tracing::trace(trace_state, "Fetched {} rows from {} ranges so far, querying {} ranges next",
+                    progress.rows, progress.ranges, next_concurrency_factor);
+            return p->query_partition_key_range_concurrent(timeout, std::move(merger), cmd, cl, std::move(ranges_to_vnodes),
+                    next_concurrency_factor, progress, std::move(trace_state), remaining_row_count, remaining_partition_count, std::move(preferred_replicas), std::move(permit));
         }
     }).handle_exception([p] (std::exception_ptr eptr) {
         p->handle_read_error(eptr, true);
@@ -4169,50 +4470,39 @@ storage_proxy::query_partition_key_range(lw_shared_ptr<query::read_command> cmd,
     // expensive in clusters with vnodes)
     query_ranges_to_vnodes_generator ranges_to_vnodes(_token_metadata, schema, std::move(partition_ranges), ks.get_replication_strategy().get_type() == locator::replication_strategy_type::local);
 
-    int result_rows_per_range = 0;
-    int concurrency_factor = 1;
-
-    std::vector<foreign_ptr<lw_shared_ptr<query::result>>> results;
+    // Seed the number of ranges queried in the first round from the local
+    // size estimate of the table. Later rounds use the rows actually
+    // returned per range instead.
+    auto& cf = _db.local().find_column_family(schema);
+    auto density = estimate_range_scan_density(cf, ks, _token_metadata);
+    double result_rows_per_range = density.rows_per_range;
+    int concurrency_factor = first_range_scan_concurrency_factor(cmd->get_row_limit(), cmd->partition_limit,
+            density.rows_per_range, density.partitions_per_range);
 
     slogger.debug("Estimated result rows per range: {}; requested rows: {}, concurrent range requests: {}",
             result_rows_per_range, cmd->get_row_limit(), concurrency_factor);
 
     // The call to `query_partition_key_range_concurrent()` below
-    // updates `cmd` directly when processing the results. Under
-    // some circumstances, when the query executes without deferring,
-    // this updating will happen before the lambda object is constructed
-    // and hence the updates will be visible to the lambda. This will
-    // result in the merger below trimming the results according to the
-    // updated (decremented) limits and causing the paging logic to
-    // declare the query exhausted due to the non-full page. To avoid
-    // this save the original values of the limits here and pass these
-    // to the lambda below.
-    const auto row_limit = cmd->get_row_limit();
-    const auto partition_limit = cmd->partition_limit;
+    // updates `cmd` directly when processing the results. The merger
+    // must trim the results according to the original limits, not the
+    // updated (decremented) ones, or the paging logic would declare the
+    // query exhausted due to the non-full page. So create it here, before
+    // `cmd` is touched.
+    auto merger = make_lw_shared<query::result_merger>(cmd->get_row_limit(), cmd->partition_limit);
 
     return query_partition_key_range_concurrent(query_options.timeout(*this),
-            std::move(results),
+            std::move(merger),
             cmd,
             cl,
             std::move(ranges_to_vnodes),
             concurrency_factor,
+            range_scan_progress{},
             std::move(query_options.trace_state),
             cmd->get_row_limit(),
             cmd->partition_limit,
             std::move(query_options.preferred_replicas),
-            std::move(query_options.permit)).then([row_limit, partition_limit] (
-                    query_partition_key_range_concurrent_result result) {
-        std::vector<foreign_ptr<lw_shared_ptr<query::result>>>& results = result.result;
-        replicas_per_token_range& used_replicas = result.replicas;
-
-        query::result_merger merger(row_limit, partition_limit);
-        merger.reserve(results.size());
-
-        for (auto&& r: results) {
-            merger(std::move(r));
-        }
-
-        return make_ready_future<coordinator_query_result>(coordinator_query_result(merger.get(), std::move(used_replicas)));
+            std::move(query_options.permit)).then([] (query_partition_key_range_concurrent_result result) {
+        return make_ready_future<coordinator_query_result>(coordinator_query_result(std::move(result.result), std::move(result.replicas)));
     });
 }
 
@@ -4418,6 +4708,189 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
         cmd = read_nothing_read_command(schema);
     }
 
+    utils::latency_counter lc;
+    lc.start();
+
+    auto token = partition_ranges[0].start()->value().as_decorated_key().token();
+    auto it = _pending_cas.find(token);
+    if (it != _pending_cas.end() && it->second.size() < max_pending_cas_per_key) {
+        // Another operation is running a Paxos round on the key. Queue behind it:
+        // the running round may decide this operation as well, and otherwise it
+        // runs its own round once the ones queued before it are done.
+        size_t block_for;
+        try {
+            block_for = get_paxos_participants(schema->ks_name(), token, cl_for_paxos).required_participants;
+        } catch (exceptions::unavailable_exception& ex) {
+            write ?  get_stats().cas_write_unavailables.mark() : get_stats().cas_read_unavailables.mark();
+            throw;
+        }
+        tracing::trace(query_options.trace_state, "Queued behind the Paxos round running on the key");
+        auto op = make_lw_shared<pending_cas>(pending_cas{std::move(schema), std::move(request), std::move(cmd),
+                std::move(partition_ranges), std::move(query_options), cl_for_paxos, cl_for_learn,
+                write_timeout, cas_timeout, write, block_for, lc});
+        it->second.push_back(op);
+        arm_pending_cas_expiry(token, *op);
+        // Keeps the operation, and its expiry timer, alive until it is decided.
+        return op->result.get_future().finally([op] { });
+    }
+    if (it != _pending_cas.end()) {
+        // Too many operations are queued on the key already. Wait for the lock
+        // the rounds on the key take.
+        return do_cas(std::move(schema), std::move(request), std::move(cmd), std::move(partition_ranges), std::move(query_options),
+                cl_for_paxos, cl_for_learn, write_timeout, cas_timeout, write, lc);
+    }
+    _pending_cas.emplace(token, std::list<lw_shared_ptr<pending_cas>>());
+
+    return futurize_invoke([&] {
+        return do_cas(std::move(schema), std::move(request), std::move(cmd), std::move(partition_ranges), std::move(query_options),
+                cl_for_paxos, cl_for_learn, write_timeout, cas_timeout, write, lc);
+    }).finally([p = shared_from_this(), token] {
+        p->run_next_pending_cas(token);
+    });
+}
+
+void storage_proxy::arm_pending_cas_expiry(dht::token token, pending_cas& op) {
+    op.expiry.set_callback([this, token, &op] {
+        auto& queue = _pending_cas[token];
+        auto it = std::find_if(queue.begin(), queue.end(), [&op] (const lw_shared_ptr<pending_cas>& p) { return p.get() == &op; });
+        auto expired = std::move(*it);
+        queue.erase(it);
+        // Fail the way a round that could not get the key's lock in time would.
+        paxos::paxos_state::logger.trace("CAS: timeout while queued behind the Paxos round on the key");
+        tracing::trace(op.query_options.trace_state, "Timed out waiting for the Paxos round running on the key");
+        if (op.write) {
+            get_stats().cas_write_timeouts.mark();
+            op.result.set_exception(mutation_write_timeout_exception(op.schema->ks_name(), op.schema->cf_name(),
+                    op.cl_for_paxos, 0, op.block_for, db::write_type::CAS));
+        } else {
+            get_stats().cas_read_timeouts.mark();
+            op.result.set_exception(read_timeout_exception(op.schema->ks_name(), op.schema->cf_name(),
+                    op.cl_for_paxos, 0, op.block_for, 0));
+        }
+    });
+    op.expiry.arm(op.cas_timeout);
+}
+
+void storage_proxy::run_next_pending_cas(dht::token token) {
+    auto it = _pending_cas.find(token);
+    if (it->second.empty()) {
+        _pending_cas.erase(it);
+        return;
+    }
+    auto op = std::move(it->second.front());
+    it->second.pop_front();
+    op->expiry.cancel();
+    // Running in the background, the caller of cas() waits for op->result.
+    (void)futurize_invoke([this, op] {
+        return do_cas(op->schema, op->request, op->cmd, std::move(op->partition_ranges), std::move(op->query_options),
+                op->cl_for_paxos, op->cl_for_learn, op->write_timeout, op->cas_timeout, op->write, op->lc);
+    }).then_wrapped([p = shared_from_this(), op, token] (future<bool> f) {
+        p->run_next_pending_cas(token);
+        f.forward_to(std::move(op->result));
+    });
+}
+
+static bool same_partition_slice(const schema& s, const query::partition_slice& a, const query::partition_slice& b) {
+    auto cmp = clustering_key_prefix::prefix_equal_tri_compare(s);
+    return a.options.mask() == b.options.mask()
+            && a.static_columns == b.static_columns
+            && a.regular_columns == b.regular_columns
+            && a.partition_row_limit() == b.partition_row_limit()
+            && !a.get_specific_ranges() && !b.get_specific_ranges()
+            && std::equal(a.default_row_ranges().begin(), a.default_row_ranges().end(),
+                    b.default_row_ranges().begin(), b.default_row_ranges().end(),
+                    [&cmp] (const query::clustering_range& x, const query::clustering_range& y) {
+                return x.equal(y, cmp);
+            });
+}
+
+bool storage_proxy::pending_cas::can_join(const schema& s, const partition_key& key, const query::read_command& round_cmd,
+        db::consistency_level round_cl_for_paxos, db::consistency_level round_cl_for_learn) const {
+    return schema->version() == s.version()
+            && cl_for_paxos == round_cl_for_paxos
+            && cl_for_learn == round_cl_for_learn
+            && partition_ranges[0].start()->value().as_decorated_key().key().equal(s, key)
+            && cmd->get_row_limit() == round_cmd.get_row_limit()
+            && cmd->partition_limit == round_cmd.partition_limit
+            && same_partition_slice(s, cmd->slice, round_cmd.slice);
+}
+
+std::optional<mutation> storage_proxy::join_pending_cas(const paxos_response_handler& handler, const query::read_command& cmd,
+        db::consistency_level cl_for_paxos, db::consistency_level cl_for_learn, const query::result& qr, api::timestamp_type ts,
+        std::vector<lw_shared_ptr<pending_cas>>& joined) {
+    std::optional<mutation> m;
+    auto it = _pending_cas.find(handler.token());
+    if (it == _pending_cas.end()) {
+        return m;
+    }
+    auto& queue = it->second;
+    for (auto op_it = queue.begin(); op_it != queue.end() && !m;) {
+        auto& op = **op_it;
+        if (!op.can_join(*handler.schema(), handler.key(), cmd, cl_for_paxos, cl_for_learn)) {
+            ++op_it;
+            continue;
+        }
+        op.expiry.cancel();
+        try {
+            m = op.request->apply(make_foreign(make_lw_shared<query::result>(qr)), op.cmd->slice, ts);
+        } catch (...) {
+            // The operation failed on its own, e.g. it is an invalid request.
+            op.result.set_exception(std::current_exception());
+            op_it = queue.erase(op_it);
+            continue;
+        }
+        op.condition_met = m.has_value() || !op.write;
+        tracing::trace(op.query_options.trace_state, "Evaluated in the Paxos round of CAS[{}]", handler.id());
+        joined.push_back(std::move(*op_it));
+        op_it = queue.erase(op_it);
+    }
+    if (!joined.empty()) {
+        paxos::paxos_state::logger.debug("CAS[{}] deciding {} queued operations in this round", handler.id(), joined.size());
+        tracing::trace(handler.tr_state, "Deciding {} queued CAS operations in this round", joined.size());
+    }
+    return m;
+}
+
+void storage_proxy::finish_joined_cas(const paxos_response_handler& handler, std::vector<lw_shared_ptr<pending_cas>>& joined, bool decided,
+        unsigned contentions) {
+    if (decided) {
+        for (auto& op : joined) {
+            ++get_stats().cas_batched;
+            if (!op->condition_met && op->write) {
+                tracing::trace(op->query_options.trace_state, "CAS precondition does not match current values");
+                ++get_stats().cas_write_condition_not_met;
+            }
+            tracing::trace(op->query_options.trace_state, "CAS successful");
+            record_cas_latency(op->lc, contentions, op->write);
+            op->result.set_value(op->condition_met);
+        }
+    } else {
+        // The round did not complete, so the conditions have to be evaluated
+        // again. Put the operations back in front of the queue, in order.
+        auto& queue = _pending_cas[handler.token()];
+        queue.insert(queue.begin(), joined.begin(), joined.end());
+        for (auto& op : joined) {
+            arm_pending_cas_expiry(handler.token(), *op);
+        }
+    }
+    joined.clear();
+}
+
+void storage_proxy::record_cas_latency(utils::latency_counter& lc, unsigned contentions, bool write) {
+    write ? get_stats().cas_write.mark(lc.stop().latency()) : get_stats().cas_read.mark(lc.stop().latency());
+    if (lc.is_start()) {
+        write ? get_stats().estimated_cas_write.add(lc.latency()) :
+                get_stats().estimated_cas_read.add(lc.latency());
+    }
+    if (contentions > 0) {
+        write ? get_stats().cas_write_contention.add(contentions) : get_stats().cas_read_contention.add(contentions);
+    }
+}
+
+future<bool> storage_proxy::do_cas(schema_ptr schema, shared_ptr<cas_request> request, lw_shared_ptr<query::read_command> cmd,
+        dht::partition_range_vector&& partition_ranges, storage_proxy::coordinator_query_options query_options,
+        db::consistency_level cl_for_paxos, db::consistency_level cl_for_learn,
+        clock_type::time_point write_timeout, clock_type::time_point cas_timeout, bool write, utils::latency_counter lc) {
     shared_ptr<paxos_response_handler> handler;
     try {
         handler = seastar::make_shared<paxos_response_handler>(shared_from_this(),
@@ -4433,22 +4906,20 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
         db::consistency_level::LOCAL_QUORUM : db::consistency_level::QUORUM;
 
     return do_with(unsigned(0), [this, handler, schema, cmd, request, partition_ranges = std::move(partition_ranges),
-            query_options = std::move(query_options), cl, write_timeout, cl_for_paxos, write] (unsigned& contentions) mutable {
+            query_options = std::move(query_options), cl, write_timeout, cl_for_paxos, cl_for_learn, write, lc] (unsigned& contentions) mutable {
         dht::token token = partition_ranges[0].start()->value().as_decorated_key().token();
-        utils::latency_counter lc;
-        lc.start();
 
         return paxos::paxos_state::with_cas_lock(token, write_timeout, [this, lc, handler, schema, cmd, request,
                      partition_ranges = std::move(partition_ranges), query_options = std::move(query_options), cl,
-                     &contentions, write] () mutable {
+                     cl_for_paxos, cl_for_learn, &contentions, write] () mutable {
             return repeat_until_value([this, handler, schema, cmd, request, partition_ranges = std::move(partition_ranges),
-                                       query_options = std::move(query_options), cl, &contentions, write] () mutable {
+                                       query_options = std::move(query_options), cl, cl_for_paxos, cl_for_learn, &contentions, write] () mutable {
                 // Finish the previous PAXOS round, if any, and, as a side effect, compute
                 // a ballot (round identifier) which is a) unique b) has good chances of being
                 // recent enough.
                 return handler->begin_and_repair_paxos(query_options.cstate, contentions, write)
-                        .then([this, handler, schema, cmd, request, partition_ranges, query_options, cl, &contentions, write]
-                               (paxos_response_handler::ballot_and_data v) mutable {
+                        .then([this, handler, schema, cmd, request, partition_ranges, query_options, cl, cl_for_paxos, cl_for_learn,
+                               &contentions, write] (paxos_response_handler::ballot_and_data v) mutable {
                     // Read the current values and check they validate the conditions.
                     auto f = [&]() {
                         if (v.data) {
@@ -4468,8 +4939,17 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
                             });
                         }
                     }();
-                    return f.then([this, handler, schema, cmd, request, ballot = v.ballot, &contentions, write] (auto&& qr) {
-                        auto mutation = request->apply(std::move(qr), cmd->slice, utils::UUID_gen::micros_timestamp(ballot));
+                    // Operations queued behind this one on the same key are decided in this round
+                    // too, as long as the conditions evaluated so far did not produce a mutation
+                    // and so the data read by the round is what they would read themselves.
+                    auto joined = make_lw_shared<std::vector<lw_shared_ptr<pending_cas>>>();
+                    return f.then([this, handler, schema, cmd, request, ballot = v.ballot, cl_for_paxos, cl_for_learn, joined,
+                            &contentions, write] (auto&& qr) {
+                        auto ts = utils::UUID_gen::micros_timestamp(ballot);
+                        auto pending = _pending_cas.find(handler->token());
+                        auto has_pending = pending != _pending_cas.end() && !pending->second.empty();
+                        auto mutation = request->apply(has_pending ? make_foreign(make_lw_shared<query::result>(*qr)) : std::move(qr),
+                                cmd->slice, ts);
                         bool condition_met = true;
                         if (!mutation) {
                             if (write) {
@@ -4478,6 +4958,11 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
                                 ++get_stats().cas_write_condition_not_met;
                                 condition_met = false;
                             }
+                            if (has_pending) {
+                                mutation = join_pending_cas(*handler, *cmd, cl_for_paxos, cl_for_learn, *qr, ts, *joined);
+                            }
+                        }
+                        if (!mutation) {
                             // If a condition is not met we still need to complete paxos round to achieve
                             // linearizability otherwise next write attempt may read differnt value as described
                             // in https://github.com/scylladb/scylla/issues/6299
@@ -4493,12 +4978,28 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
 
                         auto proposal = make_lw_shared<paxos::proposal>(ballot, freeze(*mutation));
 
-                        return handler->accept_proposal(proposal).then([handler, proposal, &contentions, condition_met] (bool is_accepted) mutable {
+                        return handler->accept_proposal(proposal).then([this, handler, proposal, &contentions, condition_met] (bool is_accepted) mutable {
                             if (is_accepted) {
                                 // The majority (aka a QUORUM) has promised the coordinator to
                                 // accept the action associated with the computed ballot.
                                 // Apply the mutation.
-                                return handler->learn_decision(std::move(proposal)).then([handler, condition_met] {
+                                auto f = make_ready_future<>();
+                                if (handler->cl_for_learn() == db::consistency_level::ANY && !_cas_background_learns.is_closed()) {
+                                    // The decision is chosen once a quorum accepted it. With learn CL ANY
+                                    // nobody expects to read it back at a non-SERIAL consistency, and the next
+                                    // Paxos round on the key completes an unlearned decision in
+                                    // begin_and_repair_paxos() anyway, so do not make the client wait for the
+                                    // learn round trip. This also covers a CAS whose condition was not met.
+                                    ++get_stats().cas_background_learn;
+                                    (void)with_gate(_cas_background_learns, [handler, proposal = std::move(proposal)] () mutable {
+                                        return handler->learn_decision(std::move(proposal));
+                                    }).handle_exception([handler] (std::exception_ptr eptr) {
+                                        paxos::paxos_state::logger.debug("CAS[{}] background learn failed: {}", handler->id(), eptr);
+                                    });
+                                } else {
+                                    f = handler->learn_decision(std::move(proposal));
+                                }
+                                return f.then([handler, condition_met] {
                                     paxos::paxos_state::logger.debug("CAS[{}] successful", handler->id());
                                     tracing::trace(handler->tr_state, "CAS successful");
                                     return std::optional<bool>(condition_met);
@@ -4510,19 +5011,20 @@ future<bool> storage_proxy::cas(schema_ptr schema, shared_ptr<cas_request> reque
                             ++contentions;
                             return sleep_approx_50ms().then([] { return std::optional<bool>(); });
                         });
+                    }).then_wrapped([this, handler, joined, &contentions] (future<std::optional<bool>> f) {
+                        if (f.failed()) {
+                            finish_joined_cas(*handler, *joined, false, contentions);
+                            return f;
+                        }
+                        auto result = f.get0();
+                        finish_joined_cas(*handler, *joined, result.has_value(), contentions);
+                        return make_ready_future<std::optional<bool>>(result);
                     });
                 });
             });
         }).then_wrapped([this, lc, &contentions, handler, schema, cl_for_paxos, write] (future<bool> f) mutable {
             get_stats().cas_foreground--;
-            write ? get_stats().cas_write.mark(lc.stop().latency()) : get_stats().cas_read.mark(lc.stop().latency());
-            if (lc.is_start()) {
-                write ? get_stats().estimated_cas_write.add(lc.latency()) :
-                        get_stats().estimated_cas_read.add(lc.latency());
-            }
-            if (contentions > 0) {
-                write ? get_stats().cas_write_contention.add(contentions) : get_stats().cas_read_contention.add(contentions);
-            }
+            record_cas_latency(lc, contentions, write);
             try {
                 return make_ready_future<bool>(f.get0());
             } catch (read_failure_exception& ex) {
@@ -5007,6 +5509,33 @@ void storage_proxy::init_messaging_service() {
             });
         });
     });
+    ms.register_read_row_summary([] (const rpc::client_info& cinfo, rpc::opt_time_point t, query::read_command cmd, ::compat::wrapping_partition_range pr) {
+        tracing::trace_state_ptr trace_state_ptr;
+        auto src_addr = netw::messaging_service::get_source(cinfo);
+        if (cmd.trace_info) {
+            trace_state_ptr = tracing::tracing::get_local_tracing_instance().create_session(*cmd.trace_info);
+            tracing::begin(trace_state_ptr);
+            tracing::trace(trace_state_ptr, "read_row_summary: message received from /{}", src_addr.addr);
+        }
+        if (!cmd.max_result_size) {
+            cmd.max_result_size.emplace(cinfo.retrieve_auxiliary<uint64_t>("max_result_size"));
+        }
+        return do_with(std::move(pr), get_local_shared_storage_proxy(), std::move(trace_state_ptr), [&cinfo, cmd = make_lw_shared<query::read_command>(std::move(cmd)), src_addr = std::move(src_addr), t] (::compat::wrapping_partition_range& pr, shared_ptr<storage_proxy>& p, tracing::trace_state_ptr& trace_state_ptr) mutable {
+            p->get_stats().replica_row_summary_reads++;
+            auto src_ip = src_addr.addr;
+            return get_schema_for_read(cmd->schema_version, std::move(src_addr), p->_messaging).then([cmd, &pr, &p, &trace_state_ptr, t] (schema_ptr s) {
+                auto pr2 = ::compat::unwrap(std::move(pr), *s);
+                if (pr2.second) {
+                    // this function assumes singular queries but doesn't validate
+                    throw std::runtime_error("READ_ROW_SUMMARY called with wrapping range");
+                }
+                auto timeout = t ? *t : db::no_timeout;
+                return p->query_row_summary_locally(std::move(s), cmd, std::move(pr2.first), timeout, trace_state_ptr);
+            }).finally([&trace_state_ptr, src_ip] () mutable {
+                tracing::trace(trace_state_ptr, "read_row_summary handling is done, sending a response to /{}", src_ip);
+            });
+        });
+    });
     ms.register_truncate([this](sstring ksname, sstring cfname) {
         return do_with(utils::make_joinpoint([] { return db_clock::now();}),
                         [this, ksname, cfname](auto& tsf) {
@@ -5130,6 +5659,7 @@ future<> storage_proxy::uninit_messaging_service() {
         ms.unregister_read_data(),
         ms.unregister_read_mutation_data(),
         ms.unregister_read_digest(),
+        ms.unregister_read_row_summary(),
         ms.unregister_truncate(),
         ms.unregister_paxos_prepare(),
         ms.unregister_paxos_accept(),
@@ -5168,6 +5698,18 @@ storage_proxy::query_mutations_locally(schema_ptr s, lw_shared_ptr<query::read_c
     }
 }
 
+future<partition_row_summary>
+storage_proxy::query_row_summary_locally(schema_ptr s, lw_shared_ptr<query::read_command> cmd, dht::partition_range pr,
+                                         storage_proxy::clock_type::time_point timeout,
+                                         tracing::trace_state_ptr trace_state) {
+    return do_with(std::move(pr), [this, s = std::move(s), cmd = std::move(cmd), timeout, trace_state = std::move(trace_state)] (dht::partition_range& pr) mutable {
+        return query_mutations_locally(s, std::move(cmd), pr, timeout, std::move(trace_state)).then([s] (rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature> result_and_hit_rate) {
+            // The result is only read here, which is safe to do from another shard.
+            return summarize_rows(s, *std::get<0>(result_and_hit_rate));
+        });
+    });
+}
+
 future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>>
 storage_proxy::query_nonsingular_mutations_locally(schema_ptr s,
                                                    lw_shared_ptr<query::read_command> cmd,
@@ -5192,7 +5734,9 @@ void storage_proxy::allow_replaying_hints() noexcept {
 
 void storage_proxy::on_join_cluster(const gms::inet_address& endpoint) {};
 
-void storage_proxy::on_leave_cluster(const gms::inet_address& endpoint) {};
+void storage_proxy::on_leave_cluster(const gms::inet_address& endpoint) {
+    _endpoint_latency_tracker.remove_endpoint(endpoint);
+};
 
 void storage_proxy::on_up(const gms::inet_address& endpoint) {};
 
@@ -5227,7 +5771,7 @@ future<> storage_proxy::drain_on_shutdown() {
 
 future<>
 storage_proxy::stop() {
-    return make_ready_future<>();
+    return _cas_background_learns.close();
 }
 
 }
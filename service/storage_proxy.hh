@@ -47,6 +47,7 @@
 #include "query-result-set.hh"
 #include <seastar/core/distributed.hh>
 #include <seastar/core/execution_stage.hh>
+#include <seastar/core/gate.hh>
 #include <seastar/core/scheduling_specific.hh>
 #include "db/consistency_level_type.hh"
 #include "db/read_repair_decision.hh"
@@ -54,6 +55,7 @@
 #include "db/hints/manager.hh"
 #include "db/view/view_update_backlog.hh"
 #include "db/view/node_view_update_backlog.hh"
+#include "service/endpoint_latency_tracker.hh"
 #include "utils/histogram.hh"
 #include "utils/estimated_histogram.hh"
 #include "tracing/trace_state.hh"
@@ -63,8 +65,10 @@
 #include "service_permit.hh"
 #include "service/client_state.hh"
 #include "cdc/stats.hh"
+#include <list>
 
 class reconcilable_result;
+struct partition_row_summary;
 class frozen_mutation_and_schema;
 class frozen_mutation;
 
@@ -87,6 +91,12 @@ class one_or_two_partition_ranges;
 
 }
 
+namespace query {
+
+class result_merger;
+
+}
+
 namespace cdc {
     class cdc_service;    
 }
@@ -108,10 +118,42 @@ struct hint_wrapper;
 using replicas_per_token_range = std::unordered_map<dht::token_range, std::vector<utils::UUID>>;
 
 struct query_partition_key_range_concurrent_result {
-    std::vector<foreign_ptr<lw_shared_ptr<query::result>>> result;
+    foreign_ptr<lw_shared_ptr<query::result>> result;
     replicas_per_token_range replicas;
 };
 
+// Rows and partitions returned so far by a range scan, together with the
+// number of vnode ranges they were read from. Used to estimate how many
+// ranges the next round has to query to fill the page.
+struct range_scan_progress {
+    uint64_t ranges = 0;
+    uint64_t rows = 0;
+    uint64_t partitions = 0;
+};
+
+// Upper bound on the number of vnode ranges queried concurrently in a single
+// round of a range scan.
+constexpr int max_range_scan_concurrency_factor = 256;
+// Upper bound for the first round, which is sized from a local estimate of
+// the table's density only. The estimate can't tell how many rows the query
+// filters out, so it is not trusted with a full round.
+constexpr int max_first_range_scan_concurrency_factor = 16;
+
+// Number of vnode ranges that have to be queried to return the remaining
+// rows or partitions, given the expected number of each per range.
+int range_scan_ranges_needed(uint64_t remaining_row_count, uint32_t remaining_partition_count,
+        double rows_per_range, double partitions_per_range);
+
+// Picks the number of vnode ranges to query in the first round of a range
+// scan from the estimated rows and partitions per range.
+int first_range_scan_concurrency_factor(uint64_t row_limit, uint32_t partition_limit,
+        double rows_per_range, double partitions_per_range);
+
+// Picks the number of vnode ranges to query in the next round of a range scan
+// from the rows and partitions returned per range so far.
+int next_range_scan_concurrency_factor(const range_scan_progress& progress, int concurrency_factor,
+        uint64_t remaining_row_count, uint32_t remaining_partition_count);
+
 struct view_update_backlog_timestamped {
     db::view::update_backlog backlog;
     api::timestamp_type ts;
@@ -289,6 +331,45 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             lw_shared_ptr<cdc::operation_result_tracker>> _mutate_stage;
     db::view::node_update_backlog& _max_view_update_backlog;
     std::unordered_map<gms::inet_address, view_update_backlog_timestamped> _view_update_backlogs;
+    // Latency and queue size of the reads sent from this shard, per replica.
+    endpoint_latency_tracker _endpoint_latency_tracker;
+
+    // A CAS operation queued behind the Paxos round of another operation on
+    // the same key, see cas().
+    struct pending_cas {
+        schema_ptr schema;
+        shared_ptr<cas_request> request;
+        lw_shared_ptr<query::read_command> cmd;
+        dht::partition_range_vector partition_ranges;
+        coordinator_query_options query_options;
+        db::consistency_level cl_for_paxos;
+        db::consistency_level cl_for_learn;
+        clock_type::time_point write_timeout;
+        clock_type::time_point cas_timeout;
+        bool write;
+        // Replicas a round of the operation needs, as reported when it times out.
+        size_t block_for;
+        // Started when the operation is queued.
+        utils::latency_counter lc;
+        // Fails the operation if it is still queued at its cas_timeout.
+        timer<clock_type> expiry;
+        // The result of the operation if it was decided by another operation's round.
+        bool condition_met = false;
+        promise<bool> result;
+
+        // Whether the operation can be decided by a round of another operation
+        // with the given parameters, i.e. whether it reads the same data.
+        bool can_join(const schema& s, const partition_key& key, const query::read_command& round_cmd,
+                db::consistency_level round_cl_for_paxos, db::consistency_level round_cl_for_learn) const;
+    };
+    // CAS operations waiting for the Paxos round currently running on their
+    // key. There is an entry for every key with a round in progress.
+    std::unordered_map<dht::token, std::list<lw_shared_ptr<pending_cas>>> _pending_cas;
+    // Operations beyond this many on a key wait for the key's lock instead,
+    // and run a round of their own.
+    static constexpr size_t max_pending_cas_per_key = 128;
+    // Learns of CAS decisions the client did not wait for, see do_cas(). Closed by stop().
+    seastar::gate _cas_background_learns;
 
     //NOTICE(sarna): This opaque pointer is here just to avoid moving write handler class definitions from .cc to .hh. It's slow path.
     class view_update_handlers_list;
@@ -371,11 +452,12 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             coordinator_query_options optional_params);
     static std::vector<gms::inet_address> intersection(const std::vector<gms::inet_address>& l1, const std::vector<gms::inet_address>& l2);
     future<query_partition_key_range_concurrent_result> query_partition_key_range_concurrent(clock_type::time_point timeout,
-            std::vector<foreign_ptr<lw_shared_ptr<query::result>>>&& results,
+            lw_shared_ptr<query::result_merger> merger,
             lw_shared_ptr<query::read_command> cmd,
             db::consistency_level cl,
             query_ranges_to_vnodes_generator&& ranges_to_vnodes,
             int concurrency_factor,
+            range_scan_progress progress,
             tracing::trace_state_ptr trace_state,
             uint64_t remaining_row_count,
             uint32_t remaining_partition_count,
@@ -571,10 +653,31 @@ class storage_proxy : public seastar::async_sharded_service<storage_proxy>, publ
             clock_type::time_point timeout,
             tracing::trace_state_ptr trace_state = nullptr);
 
+    // Runs a mutation query for a single partition and returns the
+    // per-row summary of its result (see summarize_rows()).
+    future<partition_row_summary> query_row_summary_locally(
+            schema_ptr s, lw_shared_ptr<query::read_command> cmd, dht::partition_range pr,
+            clock_type::time_point timeout,
+            tracing::trace_state_ptr trace_state = nullptr);
+
     future<bool> cas(schema_ptr schema, shared_ptr<cas_request> request, lw_shared_ptr<query::read_command> cmd,
             dht::partition_range_vector&& partition_ranges, coordinator_query_options query_options,
             db::consistency_level cl_for_paxos, db::consistency_level cl_for_learn,
             clock_type::time_point write_timeout, clock_type::time_point cas_timeout, bool write = true);
+private:
+    future<bool> do_cas(schema_ptr schema, shared_ptr<cas_request> request, lw_shared_ptr<query::read_command> cmd,
+            dht::partition_range_vector&& partition_ranges, coordinator_query_options query_options,
+            db::consistency_level cl_for_paxos, db::consistency_level cl_for_learn,
+            clock_type::time_point write_timeout, clock_type::time_point cas_timeout, bool write, utils::latency_counter lc);
+    void record_cas_latency(utils::latency_counter& lc, unsigned contentions, bool write);
+    void arm_pending_cas_expiry(dht::token token, pending_cas& op);
+    void run_next_pending_cas(dht::token token);
+    std::optional<mutation> join_pending_cas(const paxos_response_handler& handler, const query::read_command& cmd,
+            db::consistency_level cl_for_paxos, db::consistency_level cl_for_learn, const query::result& qr,
+            api::timestamp_type ts, std::vector<lw_shared_ptr<pending_cas>>& joined);
+    void finish_joined_cas(const paxos_response_handler& handler, std::vector<lw_shared_ptr<pending_cas>>& joined, bool decided,
+            unsigned contentions);
+public:
 
     future<> stop();
     future<> start_hints_manager(shared_ptr<gms::gossiper> gossiper_ptr, shared_ptr<service::storage_service> ss_ptr);
@@ -728,9 +831,15 @@ class paxos_response_handler : public enable_shared_from_this<paxos_response_han
     const partition_key& key() const {
         return _key.key();
     }
+    const dht::token& token() const {
+        return _key.token();
+    }
     void set_cl_for_learn(db::consistency_level cl) {
         _cl_for_learn = cl;
     }
+    db::consistency_level cl_for_learn() const {
+        return _cl_for_learn;
+    }
     // this is called with an id of a replica that replied to learn request
     // adn returns true when quorum of such requests are accumulated
     bool learned(gms::inet_address ep);
@@ -116,10 +116,14 @@ struct write_stats {
     uint64_t cas_write_condition_not_met = 0;
     uint64_t cas_write_timeout_due_to_uncertainty = 0;
     uint64_t cas_failed_read_round_optimization = 0;
+    uint64_t cas_background_learn = 0;
+    uint64_t cas_batched = 0;
     uint16_t cas_now_pruning = 0;
     uint64_t cas_prune = 0;
     uint64_t cas_coordinator_dropped_prune = 0;
     uint64_t cas_replica_dropped_prune = 0;
+    uint64_t cas_replica_state_cache_hits = 0;
+    uint64_t cas_replica_state_cache_misses = 0;
 
 
     std::chrono::microseconds last_mv_flow_control_delay; // delay added for MV flow control in the last request
@@ -149,6 +153,11 @@ struct stats : public write_stats {
     uint64_t read_repair_repaired_blocking = 0;
     uint64_t read_repair_repaired_background = 0;
     uint64_t global_read_repairs_canceled_due_to_concurrent_write = 0;
+    // foreground read repairs which transferred only the divergent rows
+    uint64_t read_repair_row_summary_repairs = 0;
+    // foreground read repairs which requested row summaries but had to
+    // transfer the whole result anyway
+    uint64_t read_repair_row_summary_fallbacks = 0;
 
     // number of mutations received as a coordinator
     uint64_t received_mutations = 0;
@@ -164,6 +173,7 @@ struct stats : public write_stats {
     uint64_t replica_data_reads = 0;
     uint64_t replica_digest_reads = 0;
     uint64_t replica_mutation_data_reads = 0;
+    uint64_t replica_row_summary_reads = 0;
 
     uint64_t replica_cross_shard_ops = 0;
 
@@ -588,6 +588,13 @@ void table::update_stats_for_new_sstable(uint64_t disk_space_used_by_sstable) no
     _stats.live_sstable_count++;
 }
 
+// Only the 3.x formats record the number of rows, so every partition of an
+// older sstable is counted as a single row.
+static uint64_t estimated_row_count(const sstables::sstable& sst) {
+    auto rows = sst.get_stats_metadata().rows_count;
+    return rows > 0 ? uint64_t(rows) : sst.get_estimated_key_count();
+}
+
 inline void table::add_sstable_to_backlog_tracker(compaction_backlog_tracker& tracker, sstables::shared_sstable sstable) {
     tracker.add_sstable(std::move(sstable));
 }
@@ -600,11 +607,14 @@ void table::add_sstable(sstables::shared_sstable sstable) {
     if (belongs_to_other_shard(sstable->get_shards_for_this_sstable())) {
         on_internal_error(tlogger, format("Attempted to load the shared SSTable {} at table", sstable->get_filename()));
     }
+    auto estimated_rows = estimated_row_count(*sstable);
     // allow in-progress reads to continue using old list
     auto new_sstables = make_lw_shared<sstables::sstable_set>(*_sstables);
     new_sstables->insert(sstable);
     _sstables = std::move(new_sstables);
     update_stats_for_new_sstable(sstable->bytes_on_disk());
+    _sstables_estimated_partitions += sstable->get_estimated_key_count();
+    _sstables_estimated_rows += estimated_rows;
     if (sstable->requires_view_building()) {
         _sstables_staging.emplace(sstable->generation(), sstable);
     } else {
@@ -619,7 +629,11 @@ table::add_sstable_and_update_cache(sstables::shared_sstable sst) {
         // atomically load all opened sstables into column family.
         add_sstable(sst);
         trigger_compaction();
-    }, dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true}));
+    }, dht::partition_range::make({sst->get_first_decorated_key(), true}, {sst->get_last_decorated_key(), true})).then([this] {
+        if (_config.data_listeners) {
+            _config.data_listeners->on_invalidated(_schema);
+        }
+    });
 }
 
 future<>
@@ -936,6 +950,13 @@ void table::rebuild_statistics() {
                                          std::move(*_sstables->all()))) {
         update_stats_for_new_sstable(tab->bytes_on_disk());
     }
+
+    _sstables_estimated_partitions = 0;
+    _sstables_estimated_rows = 0;
+    for (auto&& sst : *_sstables->all()) {
+        _sstables_estimated_partitions += sst->get_estimated_key_count();
+        _sstables_estimated_rows += estimated_row_count(*sst);
+    }
 }
 
 void
@@ -1586,6 +1607,9 @@ future<db::replay_position> table::discard_sstables(db_clock::time_point truncat
         tlogger.debug("cleaning out row cache");
     }).then([this, p]() mutable {
         rebuild_statistics();
+        if (_config.data_listeners) {
+            _config.data_listeners->on_invalidated(_schema);
+        }
 
         return parallel_for_each(p->remove, [this](sstables::shared_sstable s) {
             remove_sstable_from_backlog_tracker(_compaction_strategy.get_backlog_tracker(), s);
@@ -2126,7 +2150,26 @@ future<row_locker::lock_holder> table::push_view_replica_updates(const schema_pt
     return push_view_replica_updates(s, std::move(m), timeout, std::move(tr_state), sem);
 }
 
+bool table::may_contain_partition(const dht::decorated_key& key, const std::vector<sstables::shared_sstable>& excluded_sstables) const {
+    for (auto& mt : *_memtables) {
+        if (mt->contains_partition(key)) {
+            return true;
+        }
+    }
+    auto pr = dht::partition_range::make_singular(key);
+    for (auto& sst : _sstables->select(pr)) {
+        if (std::find(excluded_sstables.begin(), excluded_sstables.end(), sst) != excluded_sstables.end()) {
+            continue;
+        }
+        if (sst->filter_has_key(*_schema, key.key())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 future<row_locker::lock_holder> table::do_push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout, mutation_source&& source,
+        std::vector<sstables::shared_sstable> excluded_sstables,
         tracing::trace_state_ptr tr_state, reader_concurrency_semaphore& sem, const io_priority_class& io_priority, query::partition_slice::option_set custom_opts) const {
     if (!_config.view_update_concurrency_semaphore->current()) {
         // We don't have resources to generate view updates for this write. If we reached this point, we failed to
@@ -2175,12 +2218,25 @@ future<row_locker::lock_holder> table::do_push_view_replica_updates(const schema
     future<row_locker::lock_holder> lockf = local_base_lock(base, m.decorated_key(), slice.default_row_ranges(), timeout);
     return utils::get_local_injector().inject("table_push_view_replica_updates_timeout", timeout).then([lockf = std::move(lockf), timeout] () mutable {
         return std::move(lockf);
-    }).then([m = std::move(m), slice = std::move(slice), views = std::move(views), base, this, timeout, now, source = std::move(source), &sem, tr_state = std::move(tr_state), &io_priority] (row_locker::lock_holder lock) mutable {
+    }).then([m = std::move(m), slice = std::move(slice), views = std::move(views), base, this, timeout, now, source = std::move(source),
+            excluded_sstables = std::move(excluded_sstables), &sem, tr_state = std::move(tr_state), &io_priority] (row_locker::lock_holder lock) mutable {
       return do_with(
         dht::partition_range::make_singular(m.decorated_key()),
         std::move(slice),
         std::move(m),
-        [base, views = std::move(views), lock = std::move(lock), this, timeout, now, source = std::move(source), &sem, &io_priority, tr_state = std::move(tr_state)] (auto& pk, auto& slice, auto& m) mutable {
+        [base, views = std::move(views), lock = std::move(lock), this, timeout, now, source = std::move(source),
+                excluded_sstables = std::move(excluded_sstables), &sem, &io_priority, tr_state = std::move(tr_state)] (auto& pk, auto& slice, auto& m) mutable {
+            // The existence check is done under the row lock, so no concurrent
+            // update of the rows we would have read can sneak in after it.
+            // It looks at the same data as the source: the sstables the
+            // source excludes can't make the partition exist.
+            if (_config.view_update_skip_read_of_absent_partitions() && !may_contain_partition(m.decorated_key(), excluded_sstables)) {
+                tracing::trace(tr_state, "Base partition does not exist, skipping read-before-write");
+                ++_config.cf_stats->total_view_updates_read_before_write_skipped;
+                return this->generate_and_propagate_view_updates(base, std::move(views), std::move(m), { }, tr_state, now).then([lock = std::move(lock)] () mutable {
+                    return std::move(lock);
+                });
+            }
             auto reader = source.make_reader(base, sem.make_permit(), pk, slice, io_priority, tr_state, streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
             return this->generate_and_propagate_view_updates(base, std::move(views), std::move(m), std::move(reader), tr_state, now).then([base, tr_state = std::move(tr_state), lock = std::move(lock)] () mutable {
                 tracing::trace(tr_state, "View updates for {}.{} were generated and propagated", base->ks_name(), base->cf_name());
@@ -2195,7 +2251,7 @@ future<row_locker::lock_holder> table::do_push_view_replica_updates(const schema
 
 future<row_locker::lock_holder> table::push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout,
         tracing::trace_state_ptr tr_state, reader_concurrency_semaphore& sem) const {
-    return do_push_view_replica_updates(s, std::move(m), timeout, as_mutation_source(),
+    return do_push_view_replica_updates(s, std::move(m), timeout, as_mutation_source(), {},
             std::move(tr_state), sem, service::get_local_sstable_query_read_priority(), {});
 }
 
@@ -2207,6 +2263,7 @@ table::stream_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeou
             std::move(m),
             timeout,
             as_mutation_source_excluding(excluded_sstables),
+            excluded_sstables,
             tracing::trace_state_ptr(),
             *_config.streaming_read_concurrency_semaphore,
             service::get_local_streaming_priority(),
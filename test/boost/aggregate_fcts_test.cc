@@ -286,3 +286,69 @@ SEASTAR_TEST_CASE(test_minmax_on_set) {
         }
     });
 }
+
+// Aggregates consume their inputs in blocks; check that the results
+// don't depend on where blocks start and end, or on null values in them.
+SEASTAR_TEST_CASE(test_aggregate_over_many_rows) {
+    return do_with_cql_env_thread([&] (auto& e) {
+        e.execute_cql("CREATE TABLE test (p int, c int, v int, d bigint, f double, primary key (p, c))").get();
+        const int rows = 300;
+        for (int p = 0; p < 3; ++p) {
+            for (int c = 0; c < rows; ++c) {
+                if (c % 7 == 0) {
+                    e.execute_cql(format("INSERT INTO test (p, c, d, f) VALUES ({}, {}, {}, {})", p, c, int64_t(c) << 40, c / 4.0)).get();
+                } else {
+                    e.execute_cql(format("INSERT INTO test (p, c, v, d, f) VALUES ({}, {}, {}, {}, {})", p, c, c - 100 + p, int64_t(c) << 40, c / 4.0)).get();
+                }
+            }
+        }
+
+        auto expected = [&] (int p) {
+            int64_t count = 0, sum = 0;
+            int32_t min = std::numeric_limits<int32_t>::max(), max = std::numeric_limits<int32_t>::min();
+            for (int c = 0; c < rows; ++c) {
+                if (c % 7 != 0) {
+                    int32_t v = c - 100 + p;
+                    ++count;
+                    sum += v;
+                    min = std::min(min, v);
+                    max = std::max(max, v);
+                }
+            }
+            return std::vector<bytes_opt>{long_type->decompose(count),
+                                          int32_type->decompose(int32_t(sum)),
+                                          int32_type->decompose(int32_t(sum / count)),
+                                          int32_type->decompose(min),
+                                          int32_type->decompose(max)};
+        };
+
+        {
+            auto msg = e.execute_cql("SELECT count(v), sum(v), avg(v), min(v), max(v) FROM test WHERE p = 1").get0();
+            assert_that(msg).is_rows().with_size(1).with_row(expected(1));
+        }
+        {
+            int64_t sum_d = 0;
+            double sum_f = 0;
+            for (int c = 0; c < rows; ++c) {
+                sum_d += int64_t(c) << 40;
+                sum_f += c / 4.0;
+            }
+            auto msg = e.execute_cql("SELECT sum(d), max(d), min(f), sum(f), avg(f) FROM test WHERE p = 2").get0();
+            assert_that(msg).is_rows().with_size(1).with_row({{long_type->decompose(sum_d)},
+                                                              {long_type->decompose(int64_t(rows - 1) << 40)},
+                                                              {double_type->decompose(0.0)},
+                                                              {double_type->decompose(sum_f)},
+                                                              {double_type->decompose(sum_f / rows)}});
+        }
+        {
+            auto msg = e.execute_cql("SELECT p, count(v), sum(v), avg(v), min(v), max(v) FROM test GROUP BY p").get0();
+            std::vector<std::vector<bytes_opt>> expected_rows;
+            for (int p : {0, 1, 2}) {
+                auto row = expected(p);
+                row.insert(row.begin(), int32_type->decompose(p));
+                expected_rows.push_back(std::move(row));
+            }
+            assert_that(msg).is_rows().with_rows_ignore_order(expected_rows);
+        }
+    });
+}
@@ -92,6 +92,26 @@ SEASTAR_TEST_CASE(test_like_operator_on_clustering_key) {
     });
 }
 
+SEASTAR_TEST_CASE(test_like_operator_prefix_on_clustering_key) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        // The literal prefix of the pattern limits the clustering range read.
+        for (auto order : {"asc", "desc"}) {
+            cquery_nofail(e, format("create table t_{} (p int, s text, primary key(p, s)) with clustering order by (s {})", order, order).c_str());
+            for (auto s : {"a", "ab", "abc", "abd", "ac", "b", "ab\xc3\xbf", "ab\xc4\x80", "\xc3\xbf"}) {
+                cquery_nofail(e, format("insert into t_{} (p, s) values (1, '{}')", order, s).c_str());
+            }
+            require_rows(e, format("select s from t_{} where p = 1 and s like 'ab%' allow filtering", order),
+                         {{T("ab")}, {T("abc")}, {T("abd")}, {T("ab\xc3\xbf")}, {T("ab\xc4\x80")}});
+            require_rows(e, format("select s from t_{} where p = 1 and s like 'ab_' allow filtering", order),
+                         {{T("abc")}, {T("abd")}, {T("ab\xc3\xbf")}, {T("ab\xc4\x80")}});
+            require_rows(e, format("select s from t_{} where s like 'a%c' allow filtering", order), {{T("abc")}, {T("ac")}});
+            require_rows(e, format("select s from t_{} where p = 1 and s like '\xc3\xbf' allow filtering", order),
+                         {{T("\xc3\xbf")}});
+            require_rows(e, format("select s from t_{} where p = 1 and s like 'x%' allow filtering", order), {});
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(test_like_operator_conjunction) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         cquery_nofail(e, "create table t (s1 text primary key, s2 text)");
@@ -34,11 +34,13 @@
 #include <seastar/testing/thread_test_case.hh>
 #include "test/lib/cql_test_env.hh"
 #include "test/lib/cql_assertions.hh"
+#include "test/lib/eventually.hh"
 #include "test/lib/log.hh"
 
 #include <seastar/core/future-util.hh>
 #include <seastar/core/sleep.hh>
 #include "transport/messages/result_message.hh"
+#include "transport/request.hh"
 #include "utils/big_decimal.hh"
 #include "types/user.hh"
 #include "types/map.hh"
@@ -54,6 +56,10 @@
 #include <regex>
 #include "gms/feature.hh"
 #include "db/query_context.hh"
+#include "service/pager/paging_state.hh"
+#include "service/storage_proxy.hh"
+#include "utils/error_injection.hh"
+#include "utils/serialization.hh"
 
 using namespace std::literals::chrono_literals;
 
@@ -4746,3 +4752,535 @@ SEASTAR_TEST_CASE(test_counter_column_added_into_non_counter_table) {
                 exceptions::configuration_exception);
     });
 }
+
+SEASTAR_TEST_CASE(test_concurrent_lwt_on_same_partition) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (pk int PRIMARY KEY, v int)");
+        cquery_nofail(e, "INSERT INTO t (pk, v) VALUES (0, 0)");
+
+        // Every operation which runs a Paxos round of its own has a response handler.
+        auto paxos_operations = [] {
+            return service::get_storage_proxy().map_reduce0([] (service::storage_proxy& sp) {
+                return sp.get_stats().cas_total_operations;
+            }, uint64_t(0), std::plus<uint64_t>()).get0();
+        };
+        auto operations_before = paxos_operations();
+
+        // Concurrent conditional updates of the same partition are queued behind
+        // each other and may be decided in a single Paxos round. Exactly one of
+        // the updates expecting the same value must apply.
+        for (int round = 0; round < 3; ++round) {
+            std::vector<future<shared_ptr<cql_transport::messages::result_message>>> updates;
+            for (int i = 0; i < 10; ++i) {
+                updates.push_back(e.execute_cql(format("UPDATE t SET v = {} WHERE pk = 0 IF v = {}", round + 1, round)));
+            }
+            int applied = 0;
+            for (auto& f : updates) {
+                auto res = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(f.get0());
+                auto rows = res->rs().result_set().rows();
+                BOOST_REQUIRE_EQUAL(rows.size(), 1);
+                if (*rows[0][0] == boolean_type->decompose(true)) {
+                    ++applied;
+                }
+            }
+            BOOST_REQUIRE_EQUAL(applied, 1);
+            require_rows(e, "SELECT v FROM t WHERE pk = 0", {{int32_type->decompose(round + 1)}});
+        }
+        BOOST_REQUIRE_LT(paxos_operations() - operations_before, 3 * 10);
+    });
+}
+
+SEASTAR_TEST_CASE(test_page_prefetch) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (pk int, ck int, v int, PRIMARY KEY (pk, ck))");
+        for (int pk = 0; pk < 10; ++pk) {
+            for (int ck = 0; ck < 3; ++ck) {
+                cquery_nofail(e, format("INSERT INTO t (pk, ck, v) VALUES ({}, {}, {})", pk, ck, pk * ck).c_str());
+            }
+        }
+        e.local_client_state().set_protocol_extensions(cql_transport::cql_protocol_extension_enum_set::full());
+
+        auto fetch_all = [&] (std::vector<int32_t> page_sizes, std::vector<sstring> queries = {"SELECT * FROM t"}) {
+            size_t rows_fetched = 0;
+            lw_shared_ptr<service::pager::paging_state> paging_state;
+            size_t page = 0;
+            do {
+                auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, infinite_timeout_config, std::vector<cql3::raw_value>{},
+                        cql3::query_options::specific_options{page_sizes[page % page_sizes.size()], paging_state, {}, api::new_timestamp()});
+                auto msg = e.execute_cql(queries[page++ % queries.size()], std::move(qo)).get0();
+                auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+                BOOST_REQUIRE(rows);
+                rows_fetched += rows->rs().result_set().size();
+                auto state = rows->rs().get_metadata().paging_state();
+                paging_state = state ? make_lw_shared<service::pager::paging_state>(*state) : nullptr;
+            } while (paging_state);
+            return rows_fetched;
+        };
+
+        auto& stats = e.local_qp().get_cql_stats();
+        BOOST_REQUIRE_EQUAL(fetch_all({4}), 30u);
+        BOOST_REQUIRE_GT(stats.select_prefetched_pages_used, 0);
+        BOOST_REQUIRE_GE(stats.select_prefetched_pages, stats.select_prefetched_pages_used);
+
+        // Pages prefetched for a different page size must not be used.
+        auto used = stats.select_prefetched_pages_used;
+        BOOST_REQUIRE_EQUAL(fetch_all({4, 5}), 30u);
+        BOOST_REQUIRE_EQUAL(stats.select_prefetched_pages_used, used);
+
+        // Nor may pages prefetched for other columns.
+        BOOST_REQUIRE_EQUAL(fetch_all({4}, {"SELECT * FROM t", "SELECT pk, ck FROM t"}), 30u);
+        BOOST_REQUIRE_EQUAL(stats.select_prefetched_pages_used, used);
+    });
+}
+
+SEASTAR_TEST_CASE(test_filtering_pushdown_with_paging) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (pk int, ck int, v int, PRIMARY KEY (pk, ck))");
+        for (int pk = 0; pk < 5; ++pk) {
+            for (int ck = 0; ck < 50; ++ck) {
+                // Nothing in the last partition matches the filters below.
+                cquery_nofail(e, format("INSERT INTO t (pk, ck, v) VALUES ({}, {}, {})", pk, ck, pk == 4 ? 0 : ck % 10).c_str());
+            }
+        }
+
+        // Pages are small compared to the gaps between matching rows, so
+        // replicas often drop all the rows they read for a page.
+        auto fetch_all = [&] (sstring where, int32_t page_size) {
+            std::vector<std::vector<bytes_opt>> rows_fetched;
+            lw_shared_ptr<service::pager::paging_state> paging_state;
+            do {
+                auto qo = std::make_unique<cql3::query_options>(db::consistency_level::LOCAL_ONE, infinite_timeout_config, std::vector<cql3::raw_value>{},
+                        cql3::query_options::specific_options{page_size, paging_state, {}, api::new_timestamp()});
+                auto msg = e.execute_cql(format("SELECT ck, v FROM t WHERE {} ALLOW FILTERING", where), std::move(qo)).get0();
+                auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+                BOOST_REQUIRE(rows);
+                for (auto& row : rows->rs().result_set().rows()) {
+                    rows_fetched.push_back(row);
+                }
+                auto state = rows->rs().get_metadata().paging_state();
+                paging_state = state ? make_lw_shared<service::pager::paging_state>(*state) : nullptr;
+            } while (paging_state);
+            return rows_fetched;
+        };
+
+        for (int32_t page_size : {1, 3, 7, 100}) {
+            auto rows = fetch_all("v = 7", page_size);
+            BOOST_REQUIRE_EQUAL(rows.size(), 20u);
+            for (auto& row : rows) {
+                BOOST_REQUIRE_EQUAL(value_cast<int32_t>(int32_type->deserialize(*row[0])) % 10, 7);
+                BOOST_REQUIRE_EQUAL(row[1], int32_type->decompose(7));
+            }
+            BOOST_REQUIRE_EQUAL(fetch_all("v >= 8 AND v < 9", page_size).size(), 20u);
+            BOOST_REQUIRE_EQUAL(fetch_all("v = 7 AND ck > 40", page_size).size(), 4u);
+            BOOST_REQUIRE(fetch_all("v > 9", page_size).empty());
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_in_query_with_limit) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (pk int, ck int, v int, PRIMARY KEY (pk, ck))");
+        // Partitions have a varying number of rows and some of the keys
+        // queried below don't exist at all.
+        for (int pk = 0; pk < 20; pk += 2) {
+            for (int ck = 0; ck < pk % 3 + 1; ++ck) {
+                cquery_nofail(e, format("INSERT INTO t (pk, ck, v) VALUES ({}, {}, {})", pk, ck, pk * ck).c_str());
+            }
+        }
+
+        auto select = [&] (sstring restrictions) {
+            auto msg = e.execute_cql(format("SELECT * FROM t WHERE pk IN (19, 0, 3, 4, 6, 7, 8, 10, 11, 12, 14, 16, 18) {}", restrictions)).get0();
+            auto rows = dynamic_pointer_cast<cql_transport::messages::result_message::rows>(msg);
+            BOOST_REQUIRE(rows);
+            return rows->rs().result_set().rows();
+        };
+
+        auto all = select("");
+        BOOST_REQUIRE_EQUAL(all.size(), 16u);
+        for (size_t limit : {1, 2, 5, 10, 15, 16, 30}) {
+            auto rows = select(format("LIMIT {}", limit));
+            BOOST_REQUIRE_EQUAL(rows.size(), std::min(limit, all.size()));
+            BOOST_REQUIRE(std::equal(rows.begin(), rows.end(), all.begin()));
+        }
+        assert_that(e.execute_cql("SELECT * FROM t WHERE pk IN (1, 3, 5) LIMIT 2").get0()).is_rows().is_empty();
+    });
+}
+
+SEASTAR_TEST_CASE(test_prepared_cache_entry_size) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (pk int PRIMARY KEY, v text)").get();
+        auto& cs = service::client_state::for_internal_calls();
+        auto short_query = sstring("INSERT INTO ks.t (pk, v) VALUES (?, 'a')");
+        auto long_query = format("INSERT INTO ks.t (pk, v) VALUES (?, '{}')", sstring(20000, 'a'));
+        auto short_size = cql3::prepared_cache_entry_size()(e.local_qp().get_statement(short_query, cs));
+        auto long_size = cql3::prepared_cache_entry_size()(e.local_qp().get_statement(long_query, cs));
+        BOOST_REQUIRE_GE(long_size, short_size + 20000);
+        // The size doesn't depend on what else is allocated while preparing.
+        BOOST_REQUIRE_EQUAL(cql3::prepared_cache_entry_size()(e.local_qp().get_statement(short_query, cs)), short_size);
+
+        // Each bound marker keeps a column specification, so a statement with
+        // many of them is much larger than its query string suggests.
+        std::vector<sstring> markers(1000, "?");
+        auto one_marker = sstring("SELECT v FROM ks.t WHERE pk IN (?)");
+        auto many_markers = format("SELECT v FROM ks.t WHERE pk IN ({})", boost::algorithm::join(markers, ", "));
+        auto one_size = cql3::prepared_cache_entry_size()(e.local_qp().get_statement(one_marker, cs));
+        auto many_size = cql3::prepared_cache_entry_size()(e.local_qp().get_statement(many_markers, cs));
+        BOOST_REQUIRE_GE(many_size, one_size + 999 * sizeof(cql3::column_specification));
+    });
+}
+
+SEASTAR_TEST_CASE(test_select_single_row_prepared) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (pk int, ck int, s int static, v int, PRIMARY KEY (pk, ck)) WITH CLUSTERING ORDER BY (ck DESC)");
+        cquery_nofail(e, "CREATE TABLE t2 (pk int PRIMARY KEY, v int)");
+        for (int pk = 0; pk < 3; ++pk) {
+            cquery_nofail(e, format("INSERT INTO t2 (pk, v) VALUES ({}, {})", pk, pk + 10).c_str());
+            for (int ck = 0; ck < 3; ++ck) {
+                cquery_nofail(e, format("INSERT INTO t (pk, ck, s, v) VALUES ({}, {}, {}, {})", pk, ck, pk, pk * ck).c_str());
+            }
+        }
+
+        auto int_value = [] (int32_t v) { return cql3::raw_value::make_value(int32_type->decompose(v)); };
+        auto id = e.prepare("SELECT ck, s, v FROM t WHERE pk = ? AND ck = ?").get0();
+        for (int pk = 0; pk < 3; ++pk) {
+            for (int ck = 0; ck < 3; ++ck) {
+                assert_that(e.execute_prepared(id, {int_value(pk), int_value(ck)}).get0()).is_rows().with_rows({
+                    {int32_type->decompose(ck), int32_type->decompose(pk), int32_type->decompose(pk * ck)},
+                });
+            }
+        }
+        assert_that(e.execute_prepared(id, {int_value(1), int_value(5)}).get0()).is_rows().is_empty();
+        assert_that(e.execute_prepared(id, {int_value(5), int_value(1)}).get0()).is_rows().is_empty();
+        BOOST_REQUIRE_THROW(e.execute_prepared(id, {cql3::raw_value::make_null(), int_value(1)}).get(),
+                exceptions::invalid_request_exception);
+
+        id = e.prepare("SELECT * FROM t2 WHERE pk = ?").get0();
+        assert_that(e.execute_prepared(id, {int_value(2)}).get0()).is_rows().with_rows({
+            {int32_type->decompose(2), int32_type->decompose(12)},
+        });
+        assert_that(e.execute_prepared(id, {int_value(3)}).get0()).is_rows().is_empty();
+    });
+}
+
+SEASTAR_TEST_CASE(test_select_static_columns_across_partitions) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (pk int, ck1 int, ck2 int, s1 int static, s2 int static, v int, PRIMARY KEY (pk, ck1, ck2))");
+        cquery_nofail(e, "INSERT INTO t (pk, ck1, ck2, s1, s2, v) VALUES (1, 1, 1, 10, 11, 111)");
+        cquery_nofail(e, "INSERT INTO t (pk, ck1, ck2, v) VALUES (1, 1, 2, 112)");
+        cquery_nofail(e, "INSERT INTO t (pk, ck1, ck2, s1, v) VALUES (1, 2, 1, 10, 121)");
+        cquery_nofail(e, "INSERT INTO t (pk, s2) VALUES (2, 21)");
+        cquery_nofail(e, "INSERT INTO t (pk, ck1, ck2, s2, v) VALUES (3, 1, 1, 31, 311)");
+
+        auto i = [] (int32_t v) { return bytes_opt(int32_type->decompose(v)); };
+        auto msg = e.execute_cql("SELECT s2, ck2, v, s1, ck1, pk FROM t WHERE pk IN (1, 2, 3)").get0();
+        assert_that(msg).is_rows().with_rows_ignore_order({
+            {i(11), i(1), i(111), i(10), i(1), i(1)},
+            {i(11), i(2), i(112), i(10), i(1), i(1)},
+            {i(11), i(1), i(121), i(10), i(2), i(1)},
+            {i(21), {}, {}, {}, {}, i(2)},
+            {i(31), i(1), i(311), {}, i(1), i(3)},
+        });
+    });
+}
+
+// Partition keys of the table which are owned by this shard, in increasing order.
+static std::vector<int32_t> local_partition_keys(cql_test_env& e, const sstring& table, size_t count) {
+    auto s = e.local_db().find_schema("ks", table);
+    std::vector<int32_t> keys;
+    for (int32_t pk = 0; keys.size() < count; ++pk) {
+        if (s->get_sharder().shard_of(dht::decorate_key(*s, partition_key::from_singular(*s, pk)).token()) == this_shard_id()) {
+            keys.push_back(pk);
+        }
+    }
+    return keys;
+}
+
+SEASTAR_TEST_CASE(test_result_cache_invalidation) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (pk int, ck int, v int, PRIMARY KEY (pk, ck)) "
+                "WITH caching = {'keys': 'ALL', 'rows_per_partition': 'ALL', 'results_ttl_in_ms': '60000'}");
+        cquery_nofail(e, "CREATE TABLE t2 (pk int PRIMARY KEY, v int)");
+        cquery_nofail(e, "CREATE TABLE t3 (pk int, ck timestamp, v int, PRIMARY KEY (pk, ck)) "
+                "WITH caching = {'keys': 'ALL', 'rows_per_partition': 'ALL', 'results_ttl_in_ms': '60000'}");
+        BOOST_REQUIRE(e.local_db().find_schema("ks", "t")->caching_options().results_ttl() == std::chrono::milliseconds(60000));
+
+        auto& cache = e.local_qp().get_result_cache();
+        auto cacheable = [&] (sstring query, int32_t pk) {
+            auto id = e.prepare(query).get0();
+            auto prepared = e.local_qp().get_prepared(id);
+            cql3::query_options options(db::consistency_level::ONE, infinite_timeout_config,
+                    {cql3::raw_value::make_value(int32_type->decompose(pk))});
+            return cache.cacheable(*prepared->statement, options);
+        };
+        auto pks = local_partition_keys(e, "t", 4);
+        BOOST_REQUIRE(!cacheable("SELECT * FROM t2 WHERE pk = ?", pks[0]));
+        BOOST_REQUIRE(!cacheable("SELECT * FROM t WHERE ck = ? ALLOW FILTERING", pks[0]));
+        auto src1 = cacheable("SELECT * FROM t WHERE pk = ?", pks[0]);
+        auto src2 = cacheable("SELECT * FROM t WHERE pk = ?", pks[1]);
+        BOOST_REQUIRE(src1 && src2);
+        // Values which change while the data doesn't aren't cached.
+        BOOST_REQUIRE(!cacheable("SELECT pk, now() FROM t WHERE pk = ?", pks[0]));
+        BOOST_REQUIRE(!cacheable("SELECT pk, ttl(v) FROM t WHERE pk = ?", pks[0]));
+        BOOST_REQUIRE(cacheable("SELECT pk, writetime(v) FROM t WHERE pk = ?", pks[0]));
+        // Nor are rows restricted by them.
+        auto t3_pk = local_partition_keys(e, "t3", 1).front();
+        BOOST_REQUIRE(!cacheable("SELECT * FROM t3 WHERE pk = ? AND ck > currentTimestamp()", t3_pk));
+        BOOST_REQUIRE(cacheable("SELECT * FROM t3 WHERE pk = ? AND ck > '2020-01-01'", t3_pk));
+
+        // Writes to a partition are only seen by its shard, so only it caches results read from it.
+        if (smp::count > 1) {
+            auto s = e.local_db().find_schema("ks", "t");
+            int32_t pk = 0;
+            while (s->get_sharder().shard_of(dht::decorate_key(*s, partition_key::from_singular(*s, pk)).token()) == this_shard_id()) {
+                ++pk;
+            }
+            BOOST_REQUIRE(!cacheable("SELECT * FROM t WHERE pk = ?", pk));
+        }
+
+        bytes_ostream result;
+        result.write(to_bytes("result"));
+        cache.insert(to_bytes("k1"), *src1, result);
+        cache.insert(to_bytes("k2"), *src2, result);
+        BOOST_REQUIRE(cache.find(to_bytes("k1")));
+        BOOST_REQUIRE(cache.find(to_bytes("k2")));
+
+        cquery_nofail(e, format("INSERT INTO t (pk, ck, v) VALUES ({}, 1, 1)", pks[0]));
+        BOOST_REQUIRE(!cache.find(to_bytes("k1")));
+        BOOST_REQUIRE(cache.find(to_bytes("k2")));
+
+        // A result read before its partition was written to is not cached.
+        auto src = cacheable("SELECT * FROM t WHERE pk = ?", pks[1]);
+        auto other_src = cacheable("SELECT * FROM t WHERE pk = ?", pks[2]);
+        cquery_nofail(e, format("INSERT INTO t (pk, ck, v) VALUES ({}, 1, 1)", pks[1]));
+        BOOST_REQUIRE(!cache.find(to_bytes("k2")));
+        cache.insert(to_bytes("k3"), *src, result);
+        BOOST_REQUIRE(!cache.find(to_bytes("k3")));
+        // Results read from other partitions meanwhile still are.
+        cache.insert(to_bytes("k3"), *other_src, result);
+        BOOST_REQUIRE(cache.find(to_bytes("k3")));
+
+        cache.insert(to_bytes("k4"), *cacheable("SELECT * FROM t WHERE pk = ?", pks[3]), result);
+        BOOST_REQUIRE(cache.find(to_bytes("k4")));
+        cquery_nofail(e, "ALTER TABLE t ADD w int");
+        BOOST_REQUIRE(!cache.find(to_bytes("k4")));
+
+        // Truncation doesn't go through writes.
+        src = cacheable("SELECT * FROM t WHERE pk = ?", pks[3]);
+        cache.insert(to_bytes("k5"), *src, result);
+        BOOST_REQUIRE(cache.find(to_bytes("k5")));
+        cquery_nofail(e, "TRUNCATE t");
+        BOOST_REQUIRE(!cache.find(to_bytes("k5")));
+        cache.insert(to_bytes("k5"), *src, result);
+        BOOST_REQUIRE(!cache.find(to_bytes("k5")));
+    });
+}
+
+// Reads the options of an EXECUTE request from its frame, like the server does.
+// The options refer to the frame and the linearization buffer.
+static std::unique_ptr<cql3::query_options> read_execute_options(cql_test_env& e, const cql3::prepared_cache_key_type& id,
+        const fragmented_temporary_buffer& frame, bytes_ostream& linearization_buffer) {
+    cql_transport::request_reader in(frame.get_istream(), linearization_buffer);
+    BOOST_REQUIRE(in.read_short_bytes() == cql3::prepared_cache_key_type::cql_id(id));
+    auto options = in.read_options(4, cql_serialization_format::latest(), infinite_timeout_config, e.local_qp().get_cql_config());
+    options->prepare(e.local_qp().get_prepared(id)->bound_names);
+    return options;
+}
+
+SEASTAR_TEST_CASE(test_result_cache_key) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t (pk int, ck int, v int, PRIMARY KEY (pk, ck)) "
+                "WITH caching = {'keys': 'ALL', 'rows_per_partition': 'ALL', 'results_ttl_in_ms': '60000'}");
+        auto pks = local_partition_keys(e, "t", 2);
+        auto id = e.prepare("SELECT * FROM t WHERE pk = ?").get0();
+        auto& cache = e.local_qp().get_result_cache();
+
+        enum flags : uint8_t {
+            values = 0x01,
+            page_size = 0x04,
+            serial_consistency = 0x10,
+            default_timestamp = 0x20,
+        };
+        // An EXECUTE frame as the Java driver and gocql send them, with a default timestamp.
+        auto make_frame = [&] (int32_t pk, int64_t timestamp, uint16_t serial_cl = 0x0008) {
+            bytes_ostream frame;
+            auto out = frame.write_begin();
+            auto& cql_id = cql3::prepared_cache_key_type::cql_id(id);
+            serialize_int16(out, cql_id.size());
+            frame.write(bytes_view(cql_id));
+            serialize_int16(out, 0x0001); // ONE
+            serialize_int8(out, values | page_size | serial_consistency | default_timestamp);
+            serialize_int16(out, 1);
+            serialize_int32(out, sizeof(int32_t));
+            serialize_int32(out, pk);
+            serialize_int32(out, 5000);
+            serialize_int16(out, serial_cl);
+            serialize_int64(out, timestamp);
+            auto size = frame.size();
+            std::vector<temporary_buffer<char>> fragments;
+            fragments.emplace_back(reinterpret_cast<const char*>(frame.linearize().data()), size);
+            return fragmented_temporary_buffer(std::move(fragments), size);
+        };
+        // Executes the frame through the result cache, like the server does.
+        auto execute = [&] (const fragmented_temporary_buffer& frame) {
+            bytes_ostream linearization_buffer;
+            auto options = read_execute_options(e, id, frame, linearization_buffer);
+            auto src = cache.cacheable(*e.local_qp().get_prepared(id)->statement, *options);
+            BOOST_REQUIRE(src);
+            auto key = cql3::result_cache::make_key(4, cql3::prepared_cache_key_type::cql_id(id), *options);
+            if (!cache.find(key)) {
+                e.execute_prepared_with_qo(id, std::move(options)).get();
+                bytes_ostream result;
+                result.write(to_bytes("result"));
+                cache.insert(std::move(key), *src, std::move(result));
+            }
+        };
+
+        auto hits = cache.get_stats().hits;
+        execute(make_frame(pks[0], 1000));
+        BOOST_REQUIRE_EQUAL(cache.get_stats().hits, hits);
+        // Neither the default timestamp nor the serial consistency level of a non-serial read matter.
+        execute(make_frame(pks[0], 2000));
+        BOOST_REQUIRE_EQUAL(cache.get_stats().hits, hits + 1);
+        execute(make_frame(pks[0], 3000, 0x0009)); // LOCAL_SERIAL
+        BOOST_REQUIRE_EQUAL(cache.get_stats().hits, hits + 2);
+        // The bound values do.
+        execute(make_frame(pks[1], 2000));
+        BOOST_REQUIRE_EQUAL(cache.get_stats().hits, hits + 2);
+        execute(make_frame(pks[1], 4000));
+        BOOST_REQUIRE_EQUAL(cache.get_stats().hits, hits + 3);
+    });
+}
+
+SEASTAR_TEST_CASE(test_batch_merges_mutations_per_partition) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        cquery_nofail(e, "CREATE TABLE t1 (pk int, ck int, v int, l list<int>, PRIMARY KEY (pk, ck))");
+        cquery_nofail(e, "CREATE TABLE t2 (pk int, ck int, v int, PRIMARY KEY (pk, ck))");
+        auto& stats = e.local_qp().get_cql_stats();
+
+        auto unlogged_from_logged = stats.batches_unlogged_from_logged;
+        cquery_nofail(e, "BEGIN BATCH "
+                "INSERT INTO t1 (pk, ck, v) VALUES (1, 1, 1); "
+                "UPDATE t1 SET l = l + [1] WHERE pk = 1 AND ck = 1; "
+                "INSERT INTO t1 (pk, ck, v) VALUES (1, 2, 2); "
+                "UPDATE t1 SET l = l + [2] WHERE pk = 1 AND ck = 1; "
+                "APPLY BATCH");
+        // All statements write the same partition, so there is a single mutation and no batchlog.
+        BOOST_REQUIRE_EQUAL(stats.batches_unlogged_from_logged, unlogged_from_logged + 1);
+
+        auto pure_logged = stats.batches_pure_logged;
+        cquery_nofail(e, "BEGIN BATCH "
+                "INSERT INTO t1 (pk, ck, v) VALUES (2, 1, 1); "
+                "INSERT INTO t2 (pk, ck, v) VALUES (2, 1, 10); "
+                "INSERT INTO t2 (pk, ck, v) VALUES (2, 2, 20); "
+                "APPLY BATCH");
+        // The same key in two tables makes two mutations.
+        BOOST_REQUIRE_EQUAL(stats.batches_pure_logged, pure_logged + 1);
+
+        auto i = [] (int32_t v) { return bytes_opt(int32_type->decompose(v)); };
+        auto list_type = list_type_impl::get_instance(int32_type, true);
+        assert_that(e.execute_cql("SELECT ck, v, l FROM t1 WHERE pk = 1").get0()).is_rows().with_rows({
+            {i(1), i(1), list_type->decompose(make_list_value(list_type, {1, 2}))},
+            {i(2), i(2), {}},
+        });
+        assert_that(e.execute_cql("SELECT ck, v FROM t1 WHERE pk = 2").get0()).is_rows().with_rows({
+            {i(1), i(1)},
+        });
+        assert_that(e.execute_cql("SELECT ck, v FROM t2 WHERE pk = 2").get0()).is_rows().with_rows({
+            {i(1), i(10)},
+            {i(2), i(20)},
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_recover_evicted_prepared_statement) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        if (smp::count < 2) {
+            testlog.warn("This test case requires at least 2 shards");
+            return;
+        }
+        e.execute_cql("CREATE TABLE t (pk int PRIMARY KEY, v int)").get();
+        auto& cs = e.local_client_state();
+        auto last_shard = smp::count - 1;
+        auto evict_except_last = [&e, last_shard] (cql3::prepared_cache_key_type id) {
+            e.qp().invoke_on_all([id, last_shard] (cql3::query_processor& qp) {
+                if (this_shard_id() != last_shard) {
+                    qp.evict_prepared(id);
+                }
+            }).get();
+        };
+        auto values = [] (int32_t pk, int32_t v) {
+            return std::vector<cql3::raw_value>{cql3::raw_value::make_value(int32_type->decompose(pk)),
+                    cql3::raw_value::make_value(int32_type->decompose(v))};
+        };
+
+        // Recovered from another shard, the statement is prepared here again.
+        auto insert = e.prepare("INSERT INTO t (pk, v) VALUES (?, ?)").get0();
+        evict_except_last(insert);
+        BOOST_REQUIRE(!e.local_qp().get_prepared(insert));
+        BOOST_REQUIRE(e.local_qp().recover_prepared(insert, cs).get0());
+        e.execute_prepared(insert, values(1, 1)).get();
+
+        // A conditional statement is executed on the shard owning its partition.
+        auto s = e.local_db().find_schema("ks", "t");
+        int32_t pk = 2;
+        while (s->get_sharder().shard_of(dht::decorate_key(*s, partition_key::from_singular(*s, pk)).token()) != this_shard_id()) {
+            ++pk;
+        }
+        auto insert_lwt = e.prepare("INSERT INTO t (pk, v) VALUES (?, ?) IF NOT EXISTS").get0();
+        evict_except_last(insert_lwt);
+        BOOST_REQUIRE(e.local_qp().recover_prepared(insert_lwt, cs).get0());
+        e.execute_prepared(insert_lwt, values(pk, 2)).get();
+        assert_that(e.execute_cql(format("SELECT v FROM t WHERE pk = {}", pk)).get0())
+                .is_rows().with_rows({{int32_type->decompose(2)}});
+
+        // A statement prepared in another keyspace has another id here.
+        auto qualified = sstring("INSERT INTO ks.t (pk, v) VALUES (?, ?)");
+        e.qp().invoke_on_all([qualified] (cql3::query_processor& qp) {
+            return qp.prepare(qualified, service::client_state::for_internal_calls(), false).discard_result();
+        }).get();
+        auto qualified_id = cql3::query_processor::compute_id(qualified, "");
+        evict_except_last(qualified_id);
+        BOOST_REQUIRE_THROW(e.local_qp().recover_prepared(qualified_id, cs).get(), exceptions::prepared_query_not_found_exception);
+
+        // So does a statement which no shard has.
+        e.qp().invoke_on_all([insert] (cql3::query_processor& qp) {
+            qp.evict_prepared(insert);
+        }).get();
+        BOOST_REQUIRE_THROW(e.local_qp().recover_prepared(insert, cs).get(), exceptions::prepared_query_not_found_exception);
+    });
+}
+
+SEASTAR_TEST_CASE(test_cas_background_learn) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+#ifdef SCYLLA_ENABLE_ERROR_INJECTION
+        cquery_nofail(e, "CREATE TABLE t (pk int PRIMARY KEY, v int)");
+
+        auto background_learns = [] {
+            return service::get_storage_proxy().map_reduce0([] (service::storage_proxy& sp) {
+                return sp.get_stats().cas_background_learn;
+            }, uint64_t(0), std::plus<uint64_t>()).get0();
+        };
+        auto learns_before = background_learns();
+
+        // The learn of the decision fails, but with commit consistency ANY the
+        // client does not wait for it.
+        smp::invoke_on_all([] {
+            utils::get_local_injector().enable("paxos_error_before_learn", true);
+        }).get();
+        auto res = e.execute_cql("INSERT INTO t (pk, v) VALUES (0, 1) IF NOT EXISTS",
+                q_serial_opts({}, db::consistency_level::ANY)).get0();
+        assert_that(res).is_rows().with_rows({{boolean_type->decompose(true)}});
+        BOOST_REQUIRE_EQUAL(background_learns() - learns_before, 1);
+        require_rows(e, "SELECT v FROM t WHERE pk = 0", {});
+
+        // The next Paxos round on the key completes the decision.
+        assert_that(e.execute_cql("SELECT v FROM t WHERE pk = 0", q_serial_opts({}, db::consistency_level::SERIAL)).get0())
+                .is_rows().with_rows({{int32_type->decompose(1)}});
+        require_rows(e, "SELECT v FROM t WHERE pk = 0", {{int32_type->decompose(1)}});
+
+        smp::invoke_on_all([] {
+            utils::get_local_injector().disable("paxos_error_before_learn");
+        }).get();
+#endif
+    });
+}
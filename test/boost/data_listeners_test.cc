@@ -56,25 +56,39 @@ class table_listener : public db::data_listener {
         }
     }
 
+    virtual void on_applied(const schema_ptr& s, const frozen_mutation& m) override {
+        if (s->cf_name() == _cf_name) {
+            ++applied;
+        }
+    }
+
     unsigned read = 0;
     unsigned write = 0;
+    unsigned applied = 0;
 };
 
 struct results {
     unsigned read = 0;
     unsigned write = 0;
+    unsigned applied = 0;
 };
 
 //---------------------------------------------------------------------------------------------
 
-results test_data_listeners(cql_test_env& e, sstring cf_name) {
+results test_data_listeners(cql_test_env& e, sstring cf_name, bool write_only = false) {
     testlog.info("starting test_data_listeners");
 
     std::vector<std::unique_ptr<table_listener>> listeners;
 
-    e.db().invoke_on_all([&listeners, &cf_name] (database& db) {
+    e.db().invoke_on_all([&listeners, &cf_name, write_only] (database& db) {
         auto listener = std::make_unique<table_listener>(cf_name);
-        db.data_listeners().install(&*listener);
+        if (write_only) {
+            db.data_listeners().install_write_listener(&*listener);
+            // Reads don't go through write listeners.
+            BOOST_REQUIRE(db.data_listeners().empty());
+        } else {
+            db.data_listeners().install(&*listener);
+        }
         testlog.info("installed listener {}", &*listener);
         listeners.push_back(std::move(listener));
     }).get();
@@ -86,15 +100,19 @@ results test_data_listeners(cql_test_env& e, sstring cf_name) {
     e.execute_cql("SELECT k, c FROM t1;").get();
 
     auto res = e.db().map_reduce0(
-        [&listeners] (database& db) {
+        [&listeners, write_only] (database& db) {
             for (auto& listener: listeners) {
                 auto li = &*listener;
                 if (!db.data_listeners().exists(li)) {
                     continue;
                 }
-                results res{li->read, li->write};
-                testlog.info("uninstalled listener {}: rd={} wr={}", li, li->read, li->write);
-                db.data_listeners().uninstall(li);
+                results res{li->read, li->write, li->applied};
+                testlog.info("uninstalled listener {}: rd={} wr={} ap={}", li, li->read, li->write, li->applied);
+                if (write_only) {
+                    db.data_listeners().uninstall_write_listener(li);
+                } else {
+                    db.data_listeners().uninstall(li);
+                }
                 return res;
             }
             return results{};
@@ -103,10 +121,11 @@ results test_data_listeners(cql_test_env& e, sstring cf_name) {
         [] (results res, results li_res) {
             res.read += li_res.read;
             res.write += li_res.write;
+            res.applied += li_res.applied;
             return std::move(res);
         }).get0();
 
-    testlog.info("test_data_listeners: rd={} wr={}", res.read, res.write);
+    testlog.info("test_data_listeners: rd={} wr={} ap={}", res.read, res.write, res.applied);
 
     return res;
 }
@@ -116,6 +135,7 @@ SEASTAR_TEST_CASE(test_dlistener_t1) {
         auto res = test_data_listeners(e, "t1");
         BOOST_REQUIRE_EQUAL(3, res.read);
         BOOST_REQUIRE_EQUAL(3, res.write);
+        BOOST_REQUIRE_EQUAL(3, res.applied);
     });
 }
 
@@ -124,5 +144,15 @@ SEASTAR_TEST_CASE(test_dlistener_t2) {
         auto res = test_data_listeners(e, "t2");
         BOOST_REQUIRE_EQUAL(0, res.read);
         BOOST_REQUIRE_EQUAL(0, res.write);
+        BOOST_REQUIRE_EQUAL(0, res.applied);
+    });
+}
+
+SEASTAR_TEST_CASE(test_dlistener_write_only) {
+    return do_with_cql_env_thread([] (auto& e) {
+        auto res = test_data_listeners(e, "t1", true);
+        BOOST_REQUIRE_EQUAL(0, res.read);
+        BOOST_REQUIRE_EQUAL(3, res.write);
+        BOOST_REQUIRE_EQUAL(3, res.applied);
     });
 }
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+
+#include "service/endpoint_latency_tracker.hh"
+
+using namespace std::chrono_literals;
+
+static const gms::inet_address ep1(uint32_t(1));
+static const gms::inet_address ep2(uint32_t(2));
+static const gms::inet_address ep3(uint32_t(3));
+
+BOOST_AUTO_TEST_CASE(test_unknown_endpoints_rank_first) {
+    service::endpoint_latency_tracker tracker;
+    tracker.on_request(ep1);
+    tracker.on_response(ep1, 1ms);
+
+    std::vector<gms::inet_address> eps{ep1, ep2};
+    tracker.sort(eps.begin(), eps.end());
+    BOOST_REQUIRE(eps == std::vector<gms::inet_address>({ep2, ep1}));
+    BOOST_REQUIRE(tracker.expected_latency(ep2) == 0us);
+}
+
+BOOST_AUTO_TEST_CASE(test_ranking_by_latency) {
+    service::endpoint_latency_tracker tracker;
+    for (auto [ep, latency] : {std::pair(ep1, 3ms), std::pair(ep2, 1ms), std::pair(ep3, 2ms)}) {
+        tracker.on_request(ep);
+        tracker.on_response(ep, latency);
+    }
+
+    std::vector<gms::inet_address> eps{ep1, ep2, ep3};
+    tracker.sort(eps.begin(), eps.end());
+    BOOST_REQUIRE(eps == std::vector<gms::inet_address>({ep2, ep3, ep1}));
+    BOOST_REQUIRE(tracker.expected_latency(ep2) == 1000us);
+}
+
+BOOST_AUTO_TEST_CASE(test_outstanding_requests_demote_endpoint) {
+    service::endpoint_latency_tracker tracker;
+    for (auto ep : {ep1, ep2}) {
+        tracker.on_request(ep);
+        tracker.on_response(ep, ep == ep1 ? 1ms : 2ms);
+    }
+
+    // ep1 is faster on average, but it stalls and its requests pile up.
+    tracker.on_request(ep1);
+    tracker.on_request(ep1);
+
+    std::vector<gms::inet_address> eps{ep1, ep2};
+    tracker.sort(eps.begin(), eps.end());
+    BOOST_REQUIRE(eps == std::vector<gms::inet_address>({ep2, ep1}));
+    BOOST_REQUIRE(tracker.expected_latency(ep1) == 3000us);
+
+    // Once the queue drains, ep1 recovers its rank.
+    tracker.on_response(ep1, 1ms);
+    tracker.on_response(ep1, 1ms);
+    tracker.sort(eps.begin(), eps.end());
+    BOOST_REQUIRE(eps == std::vector<gms::inet_address>({ep1, ep2}));
+}
+
+BOOST_AUTO_TEST_CASE(test_outstanding_requests_demote_unsampled_endpoint) {
+    service::endpoint_latency_tracker tracker;
+    tracker.on_request(ep2);
+    tracker.on_response(ep2, 2ms);
+
+    // None of ep1's requests completed yet, but they still count against it.
+    for (int i = 0; i < 3; ++i) {
+        tracker.on_request(ep1);
+    }
+
+    std::vector<gms::inet_address> eps{ep1, ep2, ep3};
+    tracker.sort(eps.begin(), eps.end());
+    BOOST_REQUIRE(eps == std::vector<gms::inet_address>({ep3, ep2, ep1}));
+    BOOST_REQUIRE(tracker.expected_latency(ep1) > 0us);
+}
+
+BOOST_AUTO_TEST_CASE(test_moving_average) {
+    service::endpoint_latency_tracker tracker;
+    tracker.on_request(ep1);
+    tracker.on_response(ep1, 1000us);
+    tracker.on_request(ep1);
+    tracker.on_response(ep1, 5000us);
+    // 0.25 * 5000 + 0.75 * 1000
+    BOOST_REQUIRE(tracker.expected_latency(ep1) == 2000us);
+
+    tracker.remove_endpoint(ep1);
+    BOOST_REQUIRE(tracker.expected_latency(ep1) == 0us);
+}
@@ -22,6 +22,7 @@
 #define BOOST_TEST_MODULE core
 
 #include <boost/test/unit_test.hpp>
+#include <string>
 
 #include "utils/like_matcher.hh"
 
@@ -456,3 +457,35 @@ BOOST_AUTO_TEST_CASE(test_reset) {
     BOOST_TEST(matches(m, u8"alpha"));
     BOOST_TEST(!matches(m, u8"omega"));
 }
+
+BOOST_AUTO_TEST_CASE(test_long_text) {
+    // Longer than the blocks of the substring search
+    const std::string filler(100, 'x');
+    auto substring = matcher(u8"%abc%");
+    BOOST_TEST(matches(substring, (filler + "abc" + filler).c_str()));
+    BOOST_TEST(matches(substring, (filler + "abc").c_str()));
+    BOOST_TEST(matches(substring, ("abc" + filler).c_str()));
+    BOOST_TEST(matches(substring, (filler + "ab" + "abc" + filler).c_str()));
+    BOOST_TEST(!matches(substring, (filler + "ab" + filler + "bc").c_str()));
+    BOOST_TEST(!matches(substring, (filler + "axc" + filler).c_str()));
+
+    auto general = matcher(u8"%a_c%x");
+    BOOST_TEST(matches(general, (filler + "aШc" + filler).c_str()));
+    BOOST_TEST(!matches(general, (filler + "aШШc" + filler).c_str()));
+}
+
+BOOST_AUTO_TEST_CASE(test_literal_prefix) {
+    auto prefix = [] (const char* pattern) {
+        auto p = like_matcher::literal_prefix(bytes(pattern));
+        return std::string(reinterpret_cast<const char*>(p.data()), p.size());
+    };
+    BOOST_TEST(prefix("") == "");
+    BOOST_TEST(prefix("abc") == "abc");
+    BOOST_TEST(prefix("abc%") == "abc");
+    BOOST_TEST(prefix("ab_c") == "ab");
+    BOOST_TEST(prefix("%abc") == "");
+    BOOST_TEST(prefix(R"(a\%b%)") == "a%b");
+    BOOST_TEST(prefix(R"(a\_b_)") == "a_b");
+    BOOST_TEST(prefix(R"(a\\b%)") == R"(a\b)");
+    BOOST_TEST(prefix(R"(ab\)") == R"(ab\)");
+}
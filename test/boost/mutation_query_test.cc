@@ -23,10 +23,12 @@
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/range/algorithm/copy.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
+#include <boost/range/algorithm/sort.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "query-result-set.hh"
 #include "query-result-writer.hh"
+#include "query_result_merger.hh"
 
 #include "test/lib/test_services.hh"
 #include <seastar/testing/test_case.hh>
@@ -564,3 +566,222 @@ SEASTAR_THREAD_TEST_CASE(test_result_size_calculation) {
     BOOST_REQUIRE_EQUAL(digest_only_builder.memory_accounter().used_memory(), result_and_digest_builder.memory_accounter().used_memory());
 }
 
+
+SEASTAR_TEST_CASE(test_result_merger) {
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        auto s = make_schema();
+        auto now = gc_clock::now();
+        auto slice = make_full_slice(*s);
+
+        std::vector<mutation> mutations;
+        for (auto key : {"key1", "key2", "key3"}) {
+            mutation m(s, partition_key::from_single_value(*s, bytes(key)));
+            m.set_clustered_cell(clustering_key::from_single_value(*s, bytes("A")), "v1", data_value(bytes("A:v")), 1);
+            m.set_clustered_cell(clustering_key::from_single_value(*s, bytes("B")), "v1", data_value(bytes("B:v")), 1);
+            mutations.push_back(std::move(m));
+        }
+        boost::sort(mutations, mutation_less_cmp());
+
+        auto make_result = [&] (const mutation& m) {
+            auto r = to_data_query_result(mutation_query(s, make_source({m}), query::full_partition_range, slice, query::max_rows, query::max_partitions, now,
+                    db::no_timeout, tests::make_query_class_config(), make_accounter()).get0(), s, slice, inf32, inf32);
+            return make_foreign(make_lw_shared<query::result>(std::move(r)));
+        };
+        auto merge = [&] (uint64_t max_rows, uint32_t max_partitions) {
+            query::result_merger merger(max_rows, max_partitions);
+            for (auto& m : mutations) {
+                merger(make_result(m));
+            }
+            BOOST_REQUIRE(!merger.is_short_read());
+            auto rows = merger.row_count();
+            auto partitions = merger.partition_count();
+            auto r = merger.get();
+            BOOST_REQUIRE_EQUAL(r->row_count().value(), rows);
+            BOOST_REQUIRE_EQUAL(r->partition_count().value(), partitions);
+            return query::result_set::from_raw_result(s, slice, *r);
+        };
+
+        assert_that(merge(query::max_rows, query::max_partitions)).has_size(6);
+        assert_that(merge(3, query::max_partitions)).has_size(3)
+            .has(a_row()
+                .with_column("pk", data_value(mutations[1].key().explode(*s)[0]))
+                .with_column("ck", data_value(bytes("A"))));
+        assert_that(merge(query::max_rows, 1)).has_size(2);
+
+        {
+            query::result_merger merger(query::max_rows, query::max_partitions);
+            merger(make_result(mutations[0]));
+            BOOST_REQUIRE_EQUAL(merger.row_count(), 2u);
+            BOOST_REQUIRE_EQUAL(merger.partition_count(), 1u);
+            assert_that(query::result_set::from_raw_result(s, slice, *merger.get())).has_size(2);
+        }
+    });
+}
+
+SEASTAR_TEST_CASE(test_row_summaries) {
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        auto s = make_schema();
+        auto now = gc_clock::now();
+        auto slice = make_full_slice(*s);
+        auto pk = partition_key::from_single_value(*s, bytes("key1"));
+        auto ck_a = clustering_key::from_single_value(*s, bytes("A"));
+        auto ck_b = clustering_key::from_single_value(*s, bytes("B"));
+
+        mutation m1(s, pk);
+        m1.set_clustered_cell(ck_a, "v1", data_value(bytes("A:v")), 1);
+        m1.set_clustered_cell(ck_b, "v1", data_value(bytes("B:v")), 1);
+
+        auto summarize = [&] (const mutation& m) {
+            return summarize_rows(s, mutation_query(s, make_source({m}), query::full_partition_range, slice, query::max_rows, query::max_partitions, now,
+                    db::no_timeout, tests::make_query_class_config(), make_accounter()).get0());
+        };
+
+        auto sum1 = summarize(m1);
+        BOOST_REQUIRE(!sum1.is_short_read);
+        BOOST_REQUIRE_EQUAL(sum1.rows.size(), 2u);
+        BOOST_REQUIRE(sum1.rows[0].key.equal(*s, ck_a));
+        BOOST_REQUIRE(sum1.rows[1].key.equal(*s, ck_b));
+        BOOST_REQUIRE_NE(sum1.rows[0].hash, sum1.rows[1].hash);
+
+        // Same value written at a different timestamp changes only that row's hash.
+        mutation m2(s, pk);
+        m2.set_clustered_cell(ck_a, "v1", data_value(bytes("A:v")), 1);
+        m2.set_clustered_cell(ck_b, "v1", data_value(bytes("B:v")), 2);
+        auto sum2 = summarize(m2);
+        BOOST_REQUIRE_EQUAL(sum2.partition_hash, sum1.partition_hash);
+        BOOST_REQUIRE_EQUAL(sum2.rows[0].hash, sum1.rows[0].hash);
+        BOOST_REQUIRE_NE(sum2.rows[1].hash, sum1.rows[1].hash);
+
+        // Static row differences only show up in the partition hash.
+        mutation m3(m1);
+        m3.set_static_cell("s1", data_value(bytes("S")), 1);
+        auto sum3 = summarize(m3);
+        BOOST_REQUIRE_NE(sum3.partition_hash, sum1.partition_hash);
+        BOOST_REQUIRE_EQUAL(sum3.rows[0].hash, sum1.rows[0].hash);
+        BOOST_REQUIRE_EQUAL(sum3.rows[1].hash, sum1.rows[1].hash);
+
+        BOOST_REQUIRE(summarize(mutation(s, partition_key::from_single_value(*s, bytes("key2")))).rows.empty());
+    });
+}
+
+// Follows the coordinator through a row summary read repair of two replicas
+// which diverge on a few rows of a large partition.
+SEASTAR_TEST_CASE(test_row_summary_read_repair) {
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        auto s = make_schema();
+        auto now = gc_clock::now();
+        auto pk = partition_key::from_single_value(*s, bytes("key1"));
+        auto make_ck = [&] (int i) {
+            return clustering_key::from_single_value(*s, to_bytes(format("ck{:03d}", i)));
+        };
+        auto set_row = [&] (mutation& m, int i, char v, api::timestamp_type ts) {
+            m.set_clustered_cell(make_ck(i), "v1", data_value(bytes(1024, int8_t(v))), ts);
+        };
+
+        // Replica b has newer versions of rows 10 and 20, lacks row 30, and
+        // has row 100, which replica a lacks.
+        mutation a(s, pk);
+        mutation b(s, pk);
+        for (int i = 0; i < 100; ++i) {
+            set_row(a, i, 'a', 1);
+            if (i != 30) {
+                set_row(b, i, 'a', 1);
+            }
+        }
+        set_row(b, 10, 'b', 2);
+        set_row(b, 20, 'b', 2);
+        set_row(b, 100, 'b', 2);
+        auto reconciled = a + b;
+
+        auto cmd = query::read_command(s->id(), s->version(), make_full_slice(*s),
+                query::max_result_size(query::result_memory_limiter::unlimited_result_size));
+        auto read = [&] (const mutation& m, const query::partition_slice& slice) {
+            return mutation_query(s, make_source({m}), query::full_partition_range, slice, query::max_rows, query::max_partitions, now,
+                    db::no_timeout, tests::make_query_class_config(), make_accounter()).get0();
+        };
+        auto summarize = [&] (const mutation& m) {
+            return summarize_rows(s, read(m, cmd.slice));
+        };
+
+        // Only large results of non-reversed single-partition reads are
+        // repaired with row summaries, and only if enabled.
+        auto pr = dht::partition_range::make_singular(dht::decorate_key(*s, pk));
+        auto result_size = to_data_query_result(read(a, cmd.slice), s, cmd.slice, inf32, inf32).buf().size();
+        BOOST_REQUIRE_GE(result_size, row_summary_min_result_size);
+        BOOST_REQUIRE(can_repair_with_row_summaries(cmd, pr, result_size, true));
+        BOOST_REQUIRE(!can_repair_with_row_summaries(cmd, pr, result_size, false));
+        BOOST_REQUIRE(!can_repair_with_row_summaries(cmd, pr, row_summary_min_result_size - 1, true));
+        BOOST_REQUIRE(!can_repair_with_row_summaries(cmd, query::full_partition_range, result_size, true));
+        auto reversed_cmd = cmd;
+        reversed_cmd.slice.options.set<query::partition_slice::option::reversed>();
+        BOOST_REQUIRE(!can_repair_with_row_summaries(reversed_cmd, pr, result_size, true));
+
+        auto ranges = divergent_rows(*s, {summarize(a), summarize(b)});
+        BOOST_REQUIRE(ranges);
+        BOOST_REQUIRE_EQUAL(ranges->size(), 4u);
+        std::vector<int> expected_rows{10, 20, 30, 100};
+        for (size_t i = 0; i < expected_rows.size(); ++i) {
+            BOOST_REQUIRE((*ranges)[i].is_singular());
+            BOOST_REQUIRE((*ranges)[i].start()->value().equal(*s, make_ck(expected_rows[i])));
+        }
+
+        // Only the divergent rows are read from the replicas.
+        auto repair_cmd = make_row_repair_command(*s, cmd, pk, std::move(*ranges));
+        auto repair_a = read(a, repair_cmd->slice);
+        auto repair_b = read(b, repair_cmd->slice);
+        BOOST_REQUIRE_EQUAL(repair_a.row_count(), 3u);
+        BOOST_REQUIRE_EQUAL(repair_b.row_count(), 3u);
+
+        // Which is enough for the replicas to agree with the full reconciliation.
+        auto diff = repair_a.partitions().front().mut().unfreeze(s) + repair_b.partitions().front().mut().unfreeze(s);
+        a.apply(diff);
+        b.apply(diff);
+        assert_that(a).is_equal_to(reconciled);
+        assert_that(b).is_equal_to(reconciled);
+        BOOST_REQUIRE(!divergent_rows(*s, {summarize(a), summarize(b)}));
+    });
+}
+
+SEASTAR_TEST_CASE(test_divergent_rows_fallbacks) {
+    return seastar::async([] {
+        storage_service_for_tests ssft;
+        auto s = make_schema();
+        auto now = gc_clock::now();
+        auto pk = partition_key::from_single_value(*s, bytes("key1"));
+        auto slice = make_full_slice(*s);
+        auto summarize = [&] (const mutation& m) {
+            return summarize_rows(s, mutation_query(s, make_source({m}), query::full_partition_range, slice, query::max_rows, query::max_partitions, now,
+                    db::no_timeout, tests::make_query_class_config(), make_accounter()).get0());
+        };
+        auto make_replica = [&] (int diverging_rows) {
+            mutation m(s, pk);
+            for (int i = 0; i < 10; ++i) {
+                auto ck = clustering_key::from_single_value(*s, to_bytes(format("ck{:03d}", i)));
+                m.set_clustered_cell(ck, "v1", data_value(bytes("v")), i < diverging_rows ? 2 : 1);
+            }
+            return m;
+        };
+
+        auto base = summarize(make_replica(0));
+        BOOST_REQUIRE(divergent_rows(*s, {base, summarize(make_replica(5))}));
+
+        // The rows agree, so the mismatch is elsewhere.
+        BOOST_REQUIRE(!divergent_rows(*s, {base, summarize(make_replica(0))}));
+
+        // More than half of the rows diverge.
+        BOOST_REQUIRE(!divergent_rows(*s, {base, summarize(make_replica(6))}));
+
+        // The partition tombstone, static row or range tombstones differ.
+        auto with_static = make_replica(1);
+        with_static.set_static_cell("s1", data_value(bytes("S")), 1);
+        BOOST_REQUIRE(!divergent_rows(*s, {base, summarize(with_static)}));
+
+        // A replica's summary doesn't cover the whole partition.
+        auto short_read = summarize(make_replica(1));
+        short_read.is_short_read = query::short_read::yes;
+        BOOST_REQUIRE(!divergent_rows(*s, {base, short_read}));
+    });
+}
@@ -1219,10 +1219,26 @@ SEASTAR_TEST_CASE(test_mutation_hash) {
             };
             test_with_hasher(md5_hasher());
             test_with_hasher(xx_hasher());
+            test_with_hasher(xx3_hasher());
         });
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_xx3_hasher_is_insensitive_to_update_boundaries) {
+    auto data = tests::random::get_bytes(4096);
+    auto hash_in_pieces = [&] (size_t piece) {
+        xx3_hasher h;
+        for (size_t pos = 0; pos < data.size(); pos += piece) {
+            h.update(reinterpret_cast<const char*>(data.data()) + pos, std::min(piece, data.size() - pos));
+        }
+        return h.finalize();
+    };
+    auto expected = hash_in_pieces(data.size());
+    for (size_t piece : {1, 7, 8, 255, 256, 257, 1000}) {
+        BOOST_REQUIRE_EQUAL(hash_in_pieces(piece), expected);
+    }
+}
+
 static mutation compacted(const mutation& m) {
     auto result = m;
     result.partition().compact_for_compaction(*result.schema(), always_gc, gc_clock::now());
@@ -1234,12 +1250,14 @@ SEASTAR_TEST_CASE(test_query_digest) {
         auto check_digests_equal = [] (const mutation& m1, const mutation& m2) {
             auto ps1 = partition_slice_builder(*m1.schema()).build();
             auto ps2 = partition_slice_builder(*m2.schema()).build();
-            auto digest1 = *m1.query(ps1, query::result_memory_accounter{ query::result_memory_limiter::unlimited_result_size },
-                    query::result_options::only_digest(query::digest_algorithm::xxHash)).digest();
-            auto digest2 = *m2.query(ps2, query::result_memory_accounter{ query::result_memory_limiter::unlimited_result_size },
-                    query::result_options::only_digest(query::digest_algorithm::xxHash)).digest();
-            if (digest1 != digest2) {
-                BOOST_FAIL(format("Digest should be the same for {} and {}", m1, m2));
+            for (auto algo : {query::digest_algorithm::xxHash, query::digest_algorithm::xxHash3}) {
+                auto digest1 = *m1.query(ps1, query::result_memory_accounter{ query::result_memory_limiter::unlimited_result_size },
+                        query::result_options::only_digest(algo)).digest();
+                auto digest2 = *m2.query(ps2, query::result_memory_accounter{ query::result_memory_limiter::unlimited_result_size },
+                        query::result_options::only_digest(algo)).digest();
+                if (digest1 != digest2) {
+                    BOOST_FAIL(format("Digest should be the same for {} and {}", m1, m2));
+                }
             }
         };
 
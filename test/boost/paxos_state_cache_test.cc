@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "service/paxos/paxos_state.hh"
+#include "schema_builder.hh"
+#include "mutation.hh"
+
+#include <seastar/testing/thread_test_case.hh>
+
+using namespace service::paxos;
+using state_cache = paxos_state::state_cache;
+
+static schema_ptr make_schema() {
+    return schema_builder("ks", "cf")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("v", bytes_type)
+            .build();
+}
+
+static partition_key make_key(const schema& s, int32_t k) {
+    return partition_key::from_single_value(s, int32_type->decompose(k));
+}
+
+static utils::UUID make_ballot(int64_t micros) {
+    return utils::UUID_gen::get_random_time_UUID_from_micros(micros);
+}
+
+static proposal make_proposal(schema_ptr s, const partition_key& key, utils::UUID ballot, size_t value_size = 1) {
+    mutation m(s, key);
+    m.set_clustered_cell(clustering_key::make_empty(), "v", data_value(bytes(value_size, 'x')), utils::UUID_gen::micros_timestamp(ballot));
+    return proposal(ballot, freeze(m));
+}
+
+static gc_clock::time_point far_future() {
+    return gc_clock::now() + std::chrono::hours(1);
+}
+
+static void populate(state_cache& cache, const schema& s, const partition_key& key, const paxos_state& state) {
+    cache.populate(s, key, state, cache.generation());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_populate) {
+    auto s = make_schema();
+    auto key = make_key(*s, 1);
+    state_cache cache;
+
+    BOOST_REQUIRE(!cache.get(*s, key));
+
+    auto b1 = make_ballot(1000);
+    auto b2 = make_ballot(2000);
+    auto b3 = make_ballot(3000);
+    populate(cache, *s, key, paxos_state(b3, make_proposal(s, key, b2), make_proposal(s, key, b1),
+            paxos_state::cell_expiry{far_future(), far_future(), far_future()}));
+    auto state = cache.get(*s, key);
+    BOOST_REQUIRE(state);
+    BOOST_REQUIRE_EQUAL(state->promised_ballot(), b3);
+    BOOST_REQUIRE_EQUAL(state->accepted_proposal()->ballot, b2);
+    BOOST_REQUIRE_EQUAL(state->most_recent_commit()->ballot, b1);
+
+    // A second load does not replace what the cache already follows.
+    populate(cache, *s, key, paxos_state());
+    BOOST_REQUIRE_EQUAL(cache.get(*s, key)->promised_ballot(), b3);
+
+    // The cells expire when the loaded ones do, rather than a full TTL after the load.
+    auto key2 = make_key(*s, 2);
+    auto past = gc_clock::now() - std::chrono::seconds(1);
+    populate(cache, *s, key2, paxos_state(b3, make_proposal(s, key2, b2), make_proposal(s, key2, b1),
+            paxos_state::cell_expiry{past, far_future(), past}));
+    state = cache.get(*s, key2);
+    BOOST_REQUIRE(state);
+    BOOST_REQUIRE_EQUAL(state->promised_ballot(), utils::UUID_gen::min_time_UUID(0));
+    BOOST_REQUIRE_EQUAL(state->accepted_proposal()->ballot, b2);
+    BOOST_REQUIRE(!state->most_recent_commit());
+
+    // Keys of other tables are separate.
+    auto other = schema_builder("ks", "other")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("v", int32_type)
+            .build();
+    BOOST_REQUIRE(!cache.get(*other, make_key(*other, 1)));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_evict) {
+    auto s = make_schema();
+    auto state_of = [&] (const partition_key& key) {
+        return paxos_state(make_ballot(1000), make_proposal(s, key, make_ballot(1000)), std::nullopt);
+    };
+    size_t entry_size;
+    {
+        state_cache cache;
+        auto key = make_key(*s, 0);
+        populate(cache, *s, key, state_of(key));
+        entry_size = cache.memory_usage();
+    }
+
+    state_cache cache(2 * entry_size);
+    auto k1 = make_key(*s, 1);
+    auto k2 = make_key(*s, 2);
+    auto k3 = make_key(*s, 3);
+    populate(cache, *s, k1, state_of(k1));
+    populate(cache, *s, k2, state_of(k2));
+    BOOST_REQUIRE_EQUAL(cache.size(), 2);
+    BOOST_REQUIRE_EQUAL(cache.memory_usage(), 2 * entry_size);
+
+    // k1 becomes the most recently used, so k2 is evicted.
+    BOOST_REQUIRE(cache.get(*s, k1));
+    populate(cache, *s, k3, state_of(k3));
+    BOOST_REQUIRE_EQUAL(cache.size(), 2);
+    BOOST_REQUIRE(cache.get(*s, k1));
+    BOOST_REQUIRE(!cache.get(*s, k2));
+    BOOST_REQUIRE(cache.get(*s, k3));
+
+    // Growing an entry evicts the least recently used ones.
+    cache.on_proposal_saved(*s, make_proposal(s, k1, make_ballot(2000), entry_size / 2));
+    BOOST_REQUIRE_LE(cache.memory_usage(), 2 * entry_size);
+    BOOST_REQUIRE_EQUAL(cache.size(), 1);
+    BOOST_REQUIRE(cache.get(*s, k1));
+    BOOST_REQUIRE(!cache.get(*s, k3));
+}
+
+SEASTAR_THREAD_TEST_CASE(test_saved_writes) {
+    auto s = make_schema();
+    auto key = make_key(*s, 1);
+    state_cache cache;
+    populate(cache, *s, key, paxos_state());
+
+    auto b1 = make_ballot(1000);
+    auto b2 = make_ballot(2000);
+    cache.on_promise_saved(*s, key, b2);
+    BOOST_REQUIRE_EQUAL(cache.get(*s, key)->promised_ballot(), b2);
+
+    // An older promise loses to the newer one, as in the table.
+    cache.on_promise_saved(*s, key, b1);
+    BOOST_REQUIRE_EQUAL(cache.get(*s, key)->promised_ballot(), b2);
+
+    auto b3 = make_ballot(3000);
+    cache.on_proposal_saved(*s, make_proposal(s, key, b3));
+    auto state = cache.get(*s, key);
+    BOOST_REQUIRE_EQUAL(state->promised_ballot(), b3);
+    BOOST_REQUIRE_EQUAL(state->accepted_proposal()->ballot, b3);
+
+    // A decision erases the proposal.
+    cache.on_decision_saved(*s, make_proposal(s, key, b3));
+    state = cache.get(*s, key);
+    BOOST_REQUIRE(!state->accepted_proposal());
+    BOOST_REQUIRE_EQUAL(state->most_recent_commit()->ballot, b3);
+
+    // A prune deletes the value of the decision, but keeps its ballot.
+    cache.on_decision_deleted(*s, key, b3);
+    state = cache.get(*s, key);
+    BOOST_REQUIRE_EQUAL(state->most_recent_commit()->ballot, b3);
+    BOOST_REQUIRE(state->most_recent_commit()->update.unfreeze(s).partition().empty());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_generation_races) {
+    auto s = make_schema();
+    auto key = make_key(*s, 1);
+    auto b1 = make_ballot(1000);
+    auto b2 = make_ballot(2000);
+
+    // Writes of keys the cache does not follow make loads which started before them stale.
+    auto check_race = [&] (std::function<void (state_cache&)> write) {
+        state_cache cache;
+        auto generation = cache.generation();
+        write(cache);
+        BOOST_REQUIRE_NE(cache.generation(), generation);
+        cache.populate(*s, key, paxos_state(b1, std::nullopt, std::nullopt), generation);
+        BOOST_REQUIRE(!cache.get(*s, key));
+        cache.populate(*s, key, paxos_state(b2, std::nullopt, std::nullopt), cache.generation());
+        BOOST_REQUIRE_EQUAL(cache.get(*s, key)->promised_ballot(), b2);
+    };
+    check_race([&] (state_cache& cache) { cache.on_promise_saved(*s, key, b2); });
+    check_race([&] (state_cache& cache) { cache.on_proposal_saved(*s, make_proposal(s, key, b2)); });
+    check_race([&] (state_cache& cache) { cache.on_decision_saved(*s, make_proposal(s, key, b2)); });
+    check_race([&] (state_cache& cache) { cache.on_decision_deleted(*s, key, b2); });
+
+    // Writes which tie with a cached cell of another ballot are resolved by
+    // comparing values, which the cache does not follow, so it drops the key.
+    auto same_time = [] (const utils::UUID& b) {
+        return make_ballot(utils::UUID_gen::micros_timestamp(b));
+    };
+    auto check_tie = [&] (const paxos_state& loaded, std::function<void (state_cache&)> write) {
+        state_cache cache;
+        populate(cache, *s, key, loaded);
+        auto generation = cache.generation();
+        write(cache);
+        BOOST_REQUIRE(!cache.get(*s, key));
+        BOOST_REQUIRE_NE(cache.generation(), generation);
+    };
+    check_tie(paxos_state(b1, std::nullopt, std::nullopt), [&] (state_cache& cache) {
+        cache.on_promise_saved(*s, key, same_time(b1));
+    });
+    check_tie(paxos_state(b1, std::nullopt, std::nullopt), [&] (state_cache& cache) {
+        cache.on_proposal_saved(*s, make_proposal(s, key, same_time(b1)));
+    });
+    check_tie(paxos_state(b2, make_proposal(s, key, b1), std::nullopt), [&] (state_cache& cache) {
+        cache.on_proposal_saved(*s, make_proposal(s, key, same_time(b1)));
+    });
+    check_tie(paxos_state(b2, std::nullopt, make_proposal(s, key, b1)), [&] (state_cache& cache) {
+        cache.on_decision_saved(*s, make_proposal(s, key, same_time(b1)));
+    });
+}
+
+SEASTAR_THREAD_TEST_CASE(test_write_failed) {
+    auto s = make_schema();
+    auto key = make_key(*s, 1);
+    auto b1 = make_ballot(1000);
+    state_cache cache;
+
+    // A failed write may have been applied, so the key is dropped, and loads
+    // which started before it are not cached.
+    populate(cache, *s, key, paxos_state(b1, std::nullopt, std::nullopt));
+    auto generation = cache.generation();
+    cache.on_write_failed(*s, key);
+    BOOST_REQUIRE(!cache.get(*s, key));
+    BOOST_REQUIRE_EQUAL(cache.size(), 0);
+    BOOST_REQUIRE_EQUAL(cache.memory_usage(), 0);
+    cache.populate(*s, key, paxos_state(b1, std::nullopt, std::nullopt), generation);
+    BOOST_REQUIRE(!cache.get(*s, key));
+
+    // Even if the key was not cached.
+    generation = cache.generation();
+    cache.on_write_failed(*s, key);
+    cache.populate(*s, key, paxos_state(b1, std::nullopt, std::nullopt), generation);
+    BOOST_REQUIRE(!cache.get(*s, key));
+}
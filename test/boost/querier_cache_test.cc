@@ -110,9 +110,9 @@ class test_querier_cache {
     }
 
     template <typename Querier>
-    Querier make_querier(const dht::partition_range& range) {
+    Querier make_querier(const dht::partition_range& range, schema_ptr table) {
         return Querier(_mutation_source,
-            _s.schema(),
+            std::move(table),
             _sem.make_permit(),
             range,
             _s.schema()->full_slice(),
@@ -159,9 +159,10 @@ class test_querier_cache {
         query::partition_slice expected_slice;
     };
 
-    test_querier_cache(const noncopyable_function<sstring(size_t)>& external_make_value, std::chrono::seconds entry_ttl = 24h, size_t cache_size = 100000)
+    test_querier_cache(const noncopyable_function<sstring(size_t)>& external_make_value, std::chrono::seconds entry_ttl = 24h, size_t cache_size = 100000,
+            double table_share = query::querier_cache::default_table_share)
         : _sem(reader_concurrency_semaphore::no_limits{})
-        , _cache(cache_size, entry_ttl)
+        , _cache(cache_size, entry_ttl, table_share)
         , _mutations(make_mutations(_s, external_make_value))
         , _mutation_source([this] (schema_ptr, reader_permit, const dht::partition_range& range) {
             auto rd = flat_mutation_reader_from_mutations(_mutations, range);
@@ -190,6 +191,10 @@ class test_querier_cache {
         return _sem;
     }
 
+    const query::querier_cache::stats& get_cache_stats() const {
+        return _cache.get_stats();
+    }
+
     dht::partition_range make_partition_range(bound begin, bound end) const {
         return dht::partition_range::make({_mutations.at(begin.value()).decorated_key(), begin.is_inclusive()},
                 {_mutations.at(end.value()).decorated_key(), end.is_inclusive()});
@@ -207,13 +212,16 @@ class test_querier_cache {
         return _s.schema()->full_slice();
     }
 
+    // The querier can be made to belong to another table, which has the same
+    // columns as the one the data is read from.
     template <typename Querier>
     entry_info produce_first_page_and_save_querier(unsigned key, const dht::partition_range& range,
-            const query::partition_slice& slice, uint64_t row_limit) {
+            const query::partition_slice& slice, uint64_t row_limit, uint32_t partition_limit = std::numeric_limits<uint32_t>::max(),
+            schema_ptr table = {}) {
         const auto cache_key = make_cache_key(key);
 
-        auto querier = make_querier<Querier>(range);
-        auto [dk, ck] = querier.consume_page(dummy_result_builder{}, row_limit, std::numeric_limits<uint32_t>::max(),
+        auto querier = make_querier<Querier>(range, table ? std::move(table) : _s.schema());
+        auto [dk, ck] = querier.consume_page(dummy_result_builder{}, row_limit, partition_limit,
                 gc_clock::now(), db::no_timeout, query::max_result_size(std::numeric_limits<uint64_t>::max())).get0();
         const auto memory_usage = querier.memory_usage();
         _cache.insert(cache_key, std::move(querier), nullptr);
@@ -223,7 +231,7 @@ class test_querier_cache {
 
         // Check that the read stopped at the correct position.
         // There are 5 rows in each mutation (1 static + 4 clustering).
-        const auto* expected_key = find_key(range, row_limit / 5);
+        const auto* expected_key = find_key(range, std::min(row_limit / 5, uint64_t(partition_limit - 1)));
         if (!expected_key) {
             BOOST_REQUIRE(!dk);
             BOOST_REQUIRE(!ck);
@@ -278,6 +286,17 @@ class test_querier_cache {
         return produce_first_page_and_save_data_querier(1);
     }
 
+    // Use the whole range, with a querier of another table
+    entry_info produce_first_page_and_save_data_querier(unsigned key, schema_ptr table) {
+        return produce_first_page_and_save_querier<query::data_querier>(key, make_default_partition_range(), make_default_slice(), 5,
+                std::numeric_limits<uint32_t>::max(), std::move(table));
+    }
+
+    // Use the whole range, stop the page at the end of the first partition
+    entry_info produce_first_page_at_partition_end_and_save_data_querier(unsigned key) {
+        return produce_first_page_and_save_querier<query::data_querier>(key, make_default_partition_range(), make_default_slice(), 5, 1);
+    }
+
     entry_info produce_first_page_and_save_mutation_querier(unsigned key, const dht::partition_range& range,
             const query::partition_slice& slice, uint64_t row_limit = 5) {
         return produce_first_page_and_save_querier<query::mutation_querier>(key, range, slice, row_limit);
@@ -347,6 +366,18 @@ class test_querier_cache {
         return *this;
     }
 
+    test_querier_cache& schema_version_drops() {
+        BOOST_REQUIRE_EQUAL(_cache.get_stats().schema_version_drops, ++_expected_stats.schema_version_drops);
+        BOOST_REQUIRE_EQUAL(_cache.get_stats().position_drops, _expected_stats.position_drops);
+        return *this;
+    }
+
+    test_querier_cache& position_drops() {
+        BOOST_REQUIRE_EQUAL(_cache.get_stats().schema_version_drops, _expected_stats.schema_version_drops);
+        BOOST_REQUIRE_EQUAL(_cache.get_stats().position_drops, ++_expected_stats.position_drops);
+        return *this;
+    }
+
     test_querier_cache& no_evictions() {
         BOOST_REQUIRE_EQUAL(_cache.get_stats().time_based_evictions, _expected_stats.time_based_evictions);
         BOOST_REQUIRE_EQUAL(_cache.get_stats().resource_based_evictions, _expected_stats.resource_based_evictions);
@@ -488,6 +519,7 @@ SEASTAR_THREAD_TEST_CASE(lookup_with_original_range_drops) {
     t.assert_cache_lookup_data_querier(entry.key, *t.get_schema(), entry.original_range, entry.expected_slice)
         .no_misses()
         .drops()
+        .position_drops()
         .no_evictions();
 
 }
@@ -536,6 +568,7 @@ SEASTAR_THREAD_TEST_CASE(lookup_with_different_schema_version_drops) {
     t.assert_cache_lookup_data_querier(entry.key, *new_schema, entry.expected_range, entry.expected_slice)
         .no_misses()
         .drops()
+        .schema_version_drops()
         .no_evictions();
 }
 
@@ -619,6 +652,71 @@ SEASTAR_THREAD_TEST_CASE(test_memory_based_cache_eviction) {
     BOOST_REQUIRE_EQUAL(t.get_semaphore().get_inactive_read_stats().population, pop_before);
 }
 
+SEASTAR_THREAD_TEST_CASE(test_memory_based_cache_eviction_table_budget) {
+    const auto make_value = [] (size_t i) {
+        return format("value{:010d}", i);
+    };
+    const auto querier_memory_usage = test_querier_cache(make_value).produce_first_page_and_save_data_querier(0).memory_usage;
+
+    // Room for four queriers, two of them for each table.
+    test_querier_cache t(make_value, 24h, 4 * querier_memory_usage + querier_memory_usage / 2, 0.5);
+    simple_schema other_table;
+
+    const auto other_entry = t.produce_first_page_and_save_data_querier(0, other_table.schema());
+    const auto entry = t.produce_first_page_and_save_data_querier(1);
+    t.produce_first_page_and_save_data_querier(2);
+    t.produce_first_page_and_save_data_querier(3);
+
+    // Overflows the limit. The oldest querier belongs to the table within its
+    // share, so the oldest one of the table over its share is evicted instead.
+    t.produce_first_page_and_save_data_querier(4);
+
+    t.assert_cache_lookup_data_querier(entry.key, *t.get_schema(), entry.expected_range, entry.expected_slice)
+        .misses()
+        .no_drops()
+        .memory_based_evictions();
+    BOOST_REQUIRE_EQUAL(t.get_cache_stats().table_budget_evictions, 1);
+
+    t.assert_cache_lookup_data_querier(other_entry.key, *other_table.schema(), other_entry.expected_range, other_entry.expected_slice)
+        .no_misses()
+        .no_drops()
+        .no_evictions();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_memory_based_cache_eviction_cheap_first) {
+    const auto make_value = [] (size_t i) {
+        return format("value{:010d}", i);
+    };
+    // Queriers which stopped inside a partition, and at the end of one.
+    size_t expensive_memory_usage, cheap_memory_usage;
+    {
+        test_querier_cache t(make_value);
+        expensive_memory_usage = t.produce_first_page_and_save_data_querier(0).memory_usage;
+        cheap_memory_usage = t.produce_first_page_at_partition_end_and_save_data_querier(1).memory_usage;
+    }
+
+    // Room for two expensive queriers and the cheap one, but not for three expensive ones and the cheap one.
+    const auto cache_size = std::max(3 * expensive_memory_usage, 2 * expensive_memory_usage + cheap_memory_usage) + 1;
+    test_querier_cache t(make_value, 24h, cache_size, 1.0);
+
+    const auto expensive_entry = t.produce_first_page_and_save_data_querier(0);
+    const auto cheap_entry = t.produce_first_page_at_partition_end_and_save_data_querier(1);
+    t.produce_first_page_and_save_data_querier(2);
+
+    // Overflows the limit. The cheap querier is evicted before the older expensive one.
+    t.produce_first_page_and_save_data_querier(3);
+
+    t.assert_cache_lookup_data_querier(cheap_entry.key, *t.get_schema(), cheap_entry.expected_range, cheap_entry.expected_slice)
+        .misses()
+        .no_drops()
+        .memory_based_evictions();
+
+    t.assert_cache_lookup_data_querier(expensive_entry.key, *t.get_schema(), expensive_entry.expected_range, expensive_entry.expected_slice)
+        .no_misses()
+        .no_drops()
+        .no_evictions();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_resources_based_cache_eviction) {
     auto db_cfg_ptr = make_shared<db::config>();
     auto& db_cfg = *db_cfg_ptr;
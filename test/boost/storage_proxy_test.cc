@@ -112,3 +112,38 @@ SEASTAR_TEST_CASE(test_get_restricted_ranges) {
         });
     });
 }
+
+SEASTAR_TEST_CASE(test_range_scan_concurrency_factor) {
+    using namespace service;
+    constexpr uint32_t no_partition_limit = std::numeric_limits<uint32_t>::max();
+
+    // Dense table: a single range fills the page.
+    BOOST_REQUIRE_EQUAL(range_scan_ranges_needed(100, no_partition_limit, 10000, 10000), 1);
+    BOOST_REQUIRE_EQUAL(first_range_scan_concurrency_factor(100, no_partition_limit, 10000, 10000), 1);
+
+    // Sparse table: the page needs more ranges than a round may query, and
+    // more than the first round, sized from an estimate only, may query.
+    BOOST_REQUIRE_EQUAL(range_scan_ranges_needed(100, no_partition_limit, 0.01, 0.01), max_range_scan_concurrency_factor);
+    BOOST_REQUIRE_EQUAL(first_range_scan_concurrency_factor(100, no_partition_limit, 0.01, 0.01), max_first_range_scan_concurrency_factor);
+
+    // Ten rows per range, with some margin for the variance between ranges.
+    BOOST_REQUIRE_EQUAL(range_scan_ranges_needed(100, no_partition_limit, 10, 10), 11);
+
+    // Wide partitions: few partitions per range, but they hold enough rows to
+    // fill the page from a couple of ranges.
+    BOOST_REQUIRE_EQUAL(first_range_scan_concurrency_factor(1000, no_partition_limit, 500, 0.5), 3);
+
+    // Nothing is known about an empty table.
+    BOOST_REQUIRE_EQUAL(first_range_scan_concurrency_factor(100, no_partition_limit, 0, 0), 1);
+
+    // Rounds that found nothing widen the scan quickly, up to the limit.
+    BOOST_REQUIRE_EQUAL(next_range_scan_concurrency_factor(range_scan_progress{1, 0, 0}, 1, 100, no_partition_limit), 4);
+    BOOST_REQUIRE_EQUAL(next_range_scan_concurrency_factor(range_scan_progress{200, 0, 0}, 128, 100, no_partition_limit),
+            max_range_scan_concurrency_factor);
+
+    // Later rounds follow the rows actually returned per range.
+    BOOST_REQUIRE_EQUAL(next_range_scan_concurrency_factor(range_scan_progress{4, 40, 40}, 4, 60, no_partition_limit), 7);
+    BOOST_REQUIRE_EQUAL(next_range_scan_concurrency_factor(range_scan_progress{16, 8, 1}, 16, 92, no_partition_limit), 203);
+
+    return make_ready_future<>();
+}
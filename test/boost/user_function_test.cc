@@ -384,6 +384,82 @@ SEASTAR_TEST_CASE(test_user_sum_of_udf) {
     });
 }
 
+// Lua states are reused across calls; check that every row still sees
+// its own arguments, and that a failed call doesn't affect later ones.
+SEASTAR_TEST_CASE(test_user_function_many_rows) {
+    return with_udf_enabled([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE my_table (key int PRIMARY KEY, i int, l bigint, t text, b boolean, d double);").get();
+        std::vector<std::vector<bytes_opt>> expected;
+        for (int k = 0; k < 100; ++k) {
+            int64_t l = int64_t(k) << 33;
+            sstring t(k % 5, 'x');
+            bool b = k % 2 == 0;
+            double d = k - 50.5;
+            e.execute_cql(format("INSERT INTO my_table (key, i, l, t, b, d) VALUES ({}, {}, {}, '{}', {}, {});", k, k, l, t, b, d)).get();
+            expected.push_back({serialized(int64_t(k + l + t.size() + (b ? 1 : 0) + (d > 0 ? 1 : 0)))});
+        }
+        e.execute_cql("CREATE FUNCTION my_func(i int, l bigint, t text, b boolean, d double) RETURNS NULL ON NULL INPUT RETURNS bigint LANGUAGE Lua AS "
+                      "'return i + l + #t + (b and 1 or 0) + (d > 0 and 1 or 0)';").get();
+        e.execute_cql("CREATE FUNCTION my_func2(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                      "'if val == 7 then error(\"seven\") end return val';").get();
+        auto res = e.execute_cql("SELECT my_func(i, l, t, b, d) FROM my_table;").get0();
+        assert_that(res).is_rows().with_rows_ignore_order(expected);
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT my_func2(i) FROM my_table;").get0(), ire);
+        res = e.execute_cql("SELECT my_func2(i) FROM my_table WHERE key = 3;").get0();
+        assert_that(res).is_rows().with_rows({{serialized(3)}});
+        res = e.execute_cql("SELECT my_func(i, l, t, b, d) FROM my_table;").get0();
+        assert_that(res).is_rows().with_rows_ignore_order(expected);
+    });
+}
+
+// Globals stored by a call must not be seen by later calls which reuse the
+// same Lua state, nor leak into the libraries.
+SEASTAR_TEST_CASE(test_user_function_globals) {
+    return with_udf_enabled([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE my_table (key int PRIMARY KEY, val int);").get();
+        std::vector<std::vector<bytes_opt>> expected;
+        for (int k = 0; k < 10; ++k) {
+            e.execute_cql(format("INSERT INTO my_table (key, val) VALUES ({}, {});", k, k)).get();
+            expected.push_back({serialized(1)});
+        }
+        e.execute_cql("CREATE FUNCTION my_func(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                      "'n = (n or 0) + 1 return n';").get();
+        e.execute_cql("CREATE FUNCTION my_func2(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                      "'_G.m = (_G.m or 0) + 1 return m';").get();
+        e.execute_cql("CREATE FUNCTION my_func3(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                      "'string.x = val return val';").get();
+        for (int i = 0; i < 3; ++i) {
+            auto res = e.execute_cql("SELECT my_func(val) FROM my_table;").get0();
+            assert_that(res).is_rows().with_rows_ignore_order(expected);
+            res = e.execute_cql("SELECT my_func2(val) FROM my_table;").get0();
+            assert_that(res).is_rows().with_rows_ignore_order(expected);
+        }
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT my_func3(val) FROM my_table;").get0(), ire);
+
+        // Neither can the libraries be modified bypassing metamethods, or through metatables.
+        e.execute_cql("CREATE FUNCTION my_func4(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                      "'rawset(string, \"x\", val) return val';").get();
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT my_func4(val) FROM my_table;").get0(), ire);
+        e.execute_cql("CREATE FUNCTION my_func5(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                      "'getmetatable(\"\").__index.len = function() return 0 end return val';").get();
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT my_func5(val) FROM my_table;").get0(), ire);
+        e.execute_cql("CREATE FUNCTION my_func6(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                      "'load(\"n = 100\")() return val';").get();
+        BOOST_REQUIRE_THROW(e.execute_cql("SELECT my_func6(val) FROM my_table;").get0(), ire);
+
+        // The libraries can still be used, and tables of the script's own modified.
+        e.execute_cql("CREATE FUNCTION my_func7(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                      "'local t = setmetatable({}, {}) rawset(t, 1, (\"x\"):len() + string.len(\"x\")) "
+                      "t.n = (n or 0) + t[1] - 1 return t.n';").get();
+        for (int i = 0; i < 2; ++i) {
+            auto res = e.execute_cql("SELECT my_func7(val) FROM my_table;").get0();
+            assert_that(res).is_rows().with_rows_ignore_order(expected);
+            res = e.execute_cql("SELECT my_func(val) FROM my_table;").get0();
+            assert_that(res).is_rows().with_rows_ignore_order(expected);
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(test_user_function_tinyint_return) {
     return with_udf_enabled([] (cql_test_env& e) {
         e.execute_cql("CREATE TABLE my_table (key text PRIMARY KEY, val1 int, val2 int, val3 int, val4 varint);").get();
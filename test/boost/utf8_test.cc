@@ -26,6 +26,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "utils/utf8.hh"
+#include "utils/ascii.hh"
 
 struct test_str {
    const void *data;
@@ -115,7 +116,7 @@ BOOST_AUTO_TEST_CASE(test_utf8_positive) {
         BOOST_CHECK(utils::utf8::validate((const uint8_t*)test.data, test.len));
     }
 
-    const int max_size = 1024 + 32;
+    const int max_size = 1024 + 64;
     uint64_t buf64[max_size/8 + 2];
     // Unalign buffer address: offset 8 bytes boundary by 1 byte
     uint8_t *buf = (reinterpret_cast<uint8_t*>(buf64)) + 1;
@@ -126,8 +127,8 @@ BOOST_AUTO_TEST_CASE(test_utf8_positive) {
         size_t buf_len = 1024;
         prepare_test_buf(buf, i);
 
-        // Shift 16 bytes, validate each shift
-        for (int j = 0; j < 16; ++j) {
+        // Shift 32 bytes, validate each shift
+        for (int j = 0; j < 32; ++j) {
             BOOST_CHECK(utils::utf8::validate(buf, buf_len));
             for (int k = buf_len; k >= 1; --k)
                 buf[k] = buf[k-1];
@@ -143,7 +144,7 @@ BOOST_AUTO_TEST_CASE(test_utf8_negative) {
         BOOST_CHECK(!utils::utf8::validate((const uint8_t*)test.data, test.len));
     }
 
-    // Must be larger than 1024 + 16 + max(negative string length)
+    // Must be larger than 1024 + 32 + max(negative string length)
     uint8_t buf[1024*2];
 
     for (size_t i = 0; i < negative.size(); ++i) {
@@ -153,8 +154,8 @@ BOOST_AUTO_TEST_CASE(test_utf8_negative) {
         memcpy(buf+1024, negative[i].data, negative[i].len);
         size_t buf_len = 1024 + negative[i].len;
 
-        // Shift 16 bytes, validate each shift
-        for (int j = 0; j < 16; ++j) {
+        // Shift 32 bytes, validate each shift
+        for (int j = 0; j < 32; ++j) {
             BOOST_CHECK(!utils::utf8::validate(buf, buf_len));
             for (int k = buf_len; k >= 1; --k)
                 buf[k] = buf[k-1];
@@ -163,3 +164,21 @@ BOOST_AUTO_TEST_CASE(test_utf8_negative) {
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_ascii) {
+    // Cover the vector kernels, their tails and every position of a non
+    // ascii byte in them
+    for (size_t len = 0; len < 300; ++len) {
+        std::vector<uint8_t> buf(len + 1, 'a');
+        // Unalign the string
+        uint8_t *data = buf.data() + 1;
+        BOOST_CHECK(utils::ascii::validate(data, len));
+        for (size_t i = 0; i < len; ++i) {
+            data[i] = 0x80;
+            BOOST_CHECK(!utils::ascii::validate(data, len));
+            data[i] = 0x7F;
+            BOOST_CHECK(utils::ascii::validate(data, len));
+            data[i] = 'a';
+        }
+    }
+}
@@ -38,6 +38,7 @@
 #include "test/lib/data_model.hh"
 #include "test/lib/log.hh"
 #include "utils/ranges.hh"
+#include "utils/error_injection.hh"
 
 using namespace std::literals::chrono_literals;
 
@@ -171,6 +172,44 @@ SEASTAR_TEST_CASE(test_builder_with_multiple_partitions_of_batch_size_rows) {
     });
 }
 
+// Every partition flushes its rows to the view separately, so a build step
+// over many small partitions keeps several batches of view updates in flight.
+SEASTAR_TEST_CASE(test_builder_with_pipelined_view_updates) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+
+        // Each step reads batch_size rows, that is batch_size / 2 partitions, which
+        // is more than the number of batches allowed in flight.
+        static_assert(db::view::view_builder::batch_size / 2 > db::view::view_builder::max_view_update_concurrency);
+        const int partitions = 4 * db::view::view_builder::batch_size;
+        for (auto p = 0; p < partitions; ++p) {
+            for (auto c = 0; c < 2; ++c) {
+                e.execute_cql(format("insert into cf (p, c, v) values ({:d}, {:d}, {:d})", p, c, p * 2 + c)).get();
+            }
+        }
+
+        auto f = e.local_view_builder().wait_until_built("ks", "vcf");
+        e.execute_cql("create materialized view vcf as select * from cf "
+                      "where p is not null and c is not null and v is not null "
+                      "primary key (v, c, p)").get();
+
+        f.get();
+        auto built = db::system_keyspace::load_built_views().get0();
+        BOOST_REQUIRE_EQUAL(built.size(), 1);
+        BOOST_REQUIRE_EQUAL(built[0].second, sstring("vcf"));
+        BOOST_REQUIRE(db::system_keyspace::load_view_build_progress().get0().empty());
+
+        auto msg = e.execute_cql("select count(*) from vcf").get0();
+        assert_that(msg).is_rows().with_rows({{{long_type->decompose(long(partitions * 2))}}});
+        for (auto p : {0, partitions / 2, partitions - 1}) {
+            for (auto c = 0; c < 2; ++c) {
+                msg = e.execute_cql(format("select p, c from vcf where v = {:d}", p * 2 + c)).get0();
+                assert_that(msg).is_rows().with_rows({{{int32_type->decompose(p)}, {int32_type->decompose(c)}}});
+            }
+        }
+    });
+}
+
 SEASTAR_TEST_CASE(test_builder_view_added_during_ongoing_build) {
     return do_with_cql_env_thread([] (cql_test_env& e) {
         e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
@@ -501,6 +540,58 @@ SEASTAR_TEST_CASE(test_view_update_generator) {
     });
 }
 
+// Tables are processed concurrently, and a failure to process the staging
+// sstables of one of them doesn't hold back the others. The sstables of the
+// failed table are processed again later.
+SEASTAR_TEST_CASE(test_view_update_generator_table_failure) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+#ifdef SCYLLA_ENABLE_ERROR_INJECTION
+        auto msb = e.local_db().get_config().murmur3_partitioner_ignore_msb_bits();
+        auto key = token_generation_for_shard(1, this_shard_id(), msb).front().first;
+        std::vector<lw_shared_ptr<table>> tables;
+        for (auto name : {"t1", "t2"}) {
+            e.execute_cql(fmt::format("create table {} (p text, c text, v text, primary key (p, c))", name)).get();
+            e.execute_cql(fmt::format("create materialized view {}_view as select * from {} "
+                    "where p is not null and c is not null and v is not null primary key (v, c, p)", name, name)).get();
+            tables.push_back(e.local_db().find_column_family("ks", name).shared_from_this());
+        }
+
+        auto write_staging_sstable = [&] (lw_shared_ptr<table> t) {
+            auto s = t->schema();
+            mutation m(s, partition_key::from_exploded(*s, {to_bytes(key)}));
+            auto col = s->get_column_definition("v");
+            for (int i = 0; i < 100; ++i) {
+                auto& row = m.partition().clustered_row(*s, clustering_key::from_exploded(*s, {to_bytes(fmt::format("c{}", i))}));
+                row.cells().apply(*col, atomic_cell::make_live(*col->type, 2345, col->type->decompose(sstring(fmt::format("v{}", i)))));
+            }
+            auto sst = t->make_streaming_staging_sstable();
+            sstables::sstable_writer_config sst_cfg = test_sstables_manager.configure_writer();
+            sst->write_components(flat_mutation_reader_from_mutations({m}), 1ul, s, sst_cfg, {}, service::get_local_streaming_priority()).get();
+            sst->open_data().get();
+            t->add_sstable_and_update_cache(sst).get();
+            return sst;
+        };
+
+        // Processing fails for whichever table gets to it first.
+        utils::get_local_injector().enable("view_update_generator_consume_staging_sstable", true);
+        auto& view_update_generator = e.local_view_update_generator();
+        for (auto& t : tables) {
+            view_update_generator.register_staging_sstable(write_staging_sstable(t), t).get();
+        }
+
+        eventually([&] {
+            for (auto name : {"t1_view", "t2_view"}) {
+                auto msg = e.execute_cql(fmt::format("SELECT * FROM {}", name)).get0();
+                assert_that(msg).is_rows().with_size(100);
+            }
+        });
+        auto injections = utils::get_local_injector().enabled_injections();
+        BOOST_REQUIRE(std::find(injections.begin(), injections.end(), "view_update_generator_consume_staging_sstable") == injections.end());
+        BOOST_REQUIRE_EQUAL(view_update_generator.available_register_units(), db::view::view_update_generator::registration_queue_size);
+#endif
+    });
+}
+
 SEASTAR_THREAD_TEST_CASE(test_view_update_generator_deadlock) {
     cql_test_config test_cfg;
     auto& db_cfg = *test_cfg.db_config;
@@ -27,6 +27,8 @@
 #include "types/user.hh"
 #include "db/view/node_view_update_backlog.hh"
 #include "db/view/view_builder.hh"
+#include "db/view/view_update_coalescer.hh"
+#include "schema_builder.hh"
 
 #include <seastar/testing/test_case.hh>
 #include <seastar/testing/thread_test_case.hh>
@@ -3174,3 +3176,128 @@ SEASTAR_TEST_CASE(test_mv_allow_some_column_drops) {
         BOOST_REQUIRE_THROW(e.execute_cql("alter table cf2 drop d").get(), exceptions::invalid_request_exception);
     });
 }
+
+SEASTAR_THREAD_TEST_CASE(test_view_update_coalescer) {
+    auto s = schema_builder("ks", "mv")
+            .with_column("pk", int32_type, column_kind::partition_key)
+            .with_column("ck", int32_type, column_kind::clustering_key)
+            .with_column("v", int32_type)
+            .build();
+    auto make_update = [&s] (int32_t pk, int32_t ck) {
+        mutation m(s, partition_key::from_single_value(*s, int32_type->decompose(pk)));
+        m.set_clustered_cell(clustering_key::from_single_value(*s, int32_type->decompose(ck)), "v", data_value(ck), api::new_timestamp());
+        return m;
+    };
+
+    struct sent_update {
+        gms::inet_address target;
+        mutation m;
+    };
+    std::vector<sent_update> sent;
+    auto write = make_lw_shared<shared_promise<>>();
+    db::view::view_update_coalescer coalescer([&] (gms::inet_address target, std::vector<gms::inet_address>&&, frozen_mutation_and_schema& mut,
+            const dht::token&, const dht::token&, service::allow_hints, tracing::trace_state_ptr) {
+        sent.push_back(sent_update{target, mut.fm.unfreeze(mut.s)});
+        return write->get_shared_future();
+    });
+    db::view::stats stats("test_view_update_coalescer", seastar::metrics::label("ks")("ks"), seastar::metrics::label("cf")("mv"));
+    auto send = [&] (gms::inet_address target, const mutation& m) {
+        return coalescer.send(target, {}, frozen_mutation_and_schema{freeze(m), s}, m.token(), m.token(), service::allow_hints::yes, nullptr, stats);
+    };
+    auto find_sent = [&] (gms::inet_address target, const mutation& m) {
+        auto it = std::find_if(sent.begin(), sent.end(), [&] (const sent_update& u) {
+            return u.target == target && u.m.decorated_key().equal(*s, m.decorated_key());
+        });
+        BOOST_REQUIRE(it != sent.end());
+        return it->m;
+    };
+
+    gms::inet_address node1("127.0.0.1");
+    gms::inet_address node2("127.0.0.2");
+
+    // Updates to the same view partition and endpoint, queued before the
+    // task yields, go out as a single write.
+    std::vector<mutation> updates{make_update(1, 1), make_update(1, 2), make_update(1, 3)};
+    std::vector<future<>> fs;
+    for (auto& m : updates) {
+        fs.push_back(send(node1, m));
+    }
+    // Updates to another view partition, or to another endpoint, are not merged.
+    auto other_partition = make_update(2, 1);
+    fs.push_back(send(node1, other_partition));
+    fs.push_back(send(node2, updates[0]));
+    BOOST_REQUIRE(sent.empty());
+
+    later().get();
+    BOOST_REQUIRE_EQUAL(sent.size(), 3);
+    BOOST_REQUIRE_EQUAL(stats.view_updates_coalesced, 2);
+    auto merged = updates[0] + updates[1] + updates[2];
+    BOOST_REQUIRE_EQUAL(find_sent(node1, updates[0]), merged);
+    BOOST_REQUIRE_EQUAL(find_sent(node1, other_partition), other_partition);
+    BOOST_REQUIRE_EQUAL(find_sent(node2, updates[0]), updates[0]);
+
+    // Every merged update waits for the merged write, so the backlog it
+    // accounts for is released only when that write completes.
+    later().get();
+    for (auto& f : fs) {
+        BOOST_REQUIRE(!f.available());
+    }
+    write->set_value();
+    when_all_succeed(fs.begin(), fs.end()).get();
+
+    // A write that fails fails all the updates merged into it.
+    sent.clear();
+    write = make_lw_shared<shared_promise<>>();
+    write->set_exception(std::runtime_error("injected"));
+    auto f1 = send(node1, updates[0]);
+    auto f2 = send(node1, updates[1]);
+    later().get();
+    BOOST_REQUIRE_EQUAL(sent.size(), 1);
+    BOOST_REQUIRE_EQUAL(stats.view_updates_coalesced, 3);
+    BOOST_REQUIRE_THROW(f1.get(), std::runtime_error);
+    BOOST_REQUIRE_THROW(f2.get(), std::runtime_error);
+}
+
+SEASTAR_TEST_CASE(test_view_update_skips_read_of_absent_partition) {
+    auto cfg = make_shared<db::config>();
+    cfg->view_update_skip_read_of_absent_partitions(true);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (p int, c int, v int, PRIMARY KEY (p, c))").get();
+        e.execute_cql("CREATE MATERIALIZED VIEW mv AS SELECT * FROM t "
+                      "WHERE p IS NOT NULL AND c IS NOT NULL AND v IS NOT NULL PRIMARY KEY (v, p, c)").get();
+        auto skipped = [&e] {
+            return e.db().map_reduce0([] (database& db) {
+                return db.find_column_family("ks", "t").cf_stats()->total_view_updates_read_before_write_skipped;
+            }, uint64_t(0), std::plus<uint64_t>()).get0();
+        };
+        auto flush = [&e] {
+            e.db().invoke_on_all([] (database& db) {
+                return db.flush_all_memtables();
+            }).get();
+        };
+        auto initial = skipped();
+
+        // Nothing has to be read to update the view for a fresh partition.
+        e.execute_cql("INSERT INTO t (p, c, v) VALUES (1, 1, 10)").get();
+        BOOST_REQUIRE_EQUAL(skipped(), initial + 1);
+
+        // Once the partition exists, in a memtable or in an sstable, it has
+        // to be read, so that the view row of the old value is deleted.
+        e.execute_cql("UPDATE t SET v = 20 WHERE p = 1 AND c = 1").get();
+        BOOST_REQUIRE_EQUAL(skipped(), initial + 1);
+        flush();
+        e.execute_cql("UPDATE t SET v = 30 WHERE p = 1 AND c = 1").get();
+        BOOST_REQUIRE_EQUAL(skipped(), initial + 1);
+
+        e.execute_cql("INSERT INTO t (p, c, v) VALUES (2, 1, 10)").get();
+        BOOST_REQUIRE_EQUAL(skipped(), initial + 2);
+
+        eventually([&] {
+            auto msg = e.execute_cql("SELECT v, p, c FROM mv").get0();
+            assert_that(msg).is_rows().with_rows_ignore_order({
+                {int32_type->decompose(10), int32_type->decompose(2), int32_type->decompose(1)},
+                {int32_type->decompose(30), int32_type->decompose(1), int32_type->decompose(1)},
+            });
+        });
+    }, cfg);
+}
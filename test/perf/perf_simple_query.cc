@@ -29,6 +29,7 @@
 #include <seastar/testing/test_runner.hh>
 #include "schema_builder.hh"
 #include "release.hh"
+#include "db/config.hh"
 
 static const sstring table_name = "cf";
 
@@ -69,6 +70,7 @@ struct test_config {
     unsigned duration_in_seconds;
     bool counters;
     bool flush_memtables;
+    bool udf = false;
     unsigned operations_per_shard = 0;
 };
 
@@ -87,6 +89,7 @@ std::ostream& operator<<(std::ostream& os, const test_config& cfg) {
            << ", mode=" << cfg.mode
            << ", query_single_key=" << (cfg.query_single_key ? "yes" : "no")
            << ", counters=" << (cfg.counters ? "yes" : "no")
+           << ", udf=" << (cfg.udf ? "yes" : "no")
            << "}";
 }
 
@@ -108,7 +111,9 @@ static void create_partitions(cql_test_env& env, test_config& cfg) {
 
 static std::vector<double> test_read(cql_test_env& env, test_config& cfg) {
     create_partitions(env, cfg);
-    auto id = env.prepare("select \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" from cf where \"KEY\" = ?").get0();
+    auto id = env.prepare(cfg.udf
+            ? "select blob_len(\"C0\"), blob_len(\"C1\"), blob_len(\"C2\"), blob_len(\"C3\"), blob_len(\"C4\") from cf where \"KEY\" = ?"
+            : "select \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" from cf where \"KEY\" = ?").get0();
     return time_parallel([&env, &cfg, id] {
             bytes key = make_key(cfg.query_single_key ? 0 : std::rand() % cfg.partitions);
             return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
@@ -177,6 +182,10 @@ static std::vector<double> do_test(cql_test_env& env, test_config& cfg) {
                 utf8_type);
     }).get();
 
+    if (cfg.udf) {
+        env.execute_cql("CREATE FUNCTION blob_len(val blob) RETURNS NULL ON NULL INPUT RETURNS int LANGUAGE Lua AS 'return #val'").get();
+    }
+
     switch (cfg.mode) {
     case test_config::run_mode::read:
         return test_read(env, cfg);
@@ -219,6 +228,9 @@ void write_json_result(std::string result_file, const test_config& cfg, double m
     if (cfg.counters) {
         test_type += "_counters";
     }
+    if (cfg.udf) {
+        test_type += "_udf";
+    }
     results["test_properties"]["type"] = test_type;
 
     // <version>-<release>
@@ -261,6 +273,7 @@ int main(int argc, char** argv) {
         ("operations-per-shard", bpo::value<unsigned>(), "run this many operations per shard (overrides duration)")
         ("counters", "test counters")
         ("flush", "flush memtables before test")
+        ("udf", "test reading through a Lua user-defined function applied to every column")
         ("json-result", bpo::value<std::string>(), "name of the json result file")
         ;
 
@@ -273,6 +286,11 @@ int main(int argc, char** argv) {
         return smp::invoke_on_all([seed] {
             seastar::testing::local_random_engine.seed(seed + this_shard_id());
         }).then([&app] {
+          auto db_cfg = make_shared<db::config>();
+          if (app.configuration().contains("udf")) {
+              db_cfg->enable_user_defined_functions({true}, db::config::config_source::CommandLine);
+              db_cfg->experimental_features({db::experimental_features_t::UDF}, db::config::config_source::CommandLine);
+          }
           return do_with_cql_env_thread([&app] (auto&& env) {
             auto cfg = test_config();
             cfg.partitions = app.configuration()["partitions"].as<unsigned>();
@@ -281,6 +299,7 @@ int main(int argc, char** argv) {
             cfg.query_single_key = app.configuration().contains("query-single-key");
             cfg.counters = app.configuration().contains("counters");
             cfg.flush_memtables = app.configuration().contains("flush");
+            cfg.udf = app.configuration().contains("udf");
             if (app.configuration().contains("write")) {
                 cfg.mode = test_config::run_mode::write;
             } else if (app.configuration().contains("delete")) {
@@ -307,7 +326,7 @@ int main(int argc, char** argv) {
             if (app.configuration().contains("json-result")) {
                 write_json_result(app.configuration()["json-result"].as<std::string>(), cfg, median, mad, max, min);
             }
-          });
+          }, db_cfg);
         });
     });
 }
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/utf8.hh"
+#include "utils/ascii.hh"
+#include "test/lib/make_random_string.hh"
+
+#include "seastar/include/seastar/testing/perf_tests.hh"
+
+static bytes make_utf8_string(size_t size) {
+    // One, two, three and four byte characters
+    static const std::string_view chars[] = { "a", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80" };
+    bytes ret;
+    size_t i = 0;
+    while (ret.size() + 4 <= size) {
+        auto c = chars[i++ % std::size(chars)];
+        ret += bytes_view(reinterpret_cast<const int8_t*>(c.data()), c.size());
+    }
+    return ret;
+}
+
+static bytes make_ascii_string(size_t size) {
+    auto s = make_random_string(size);
+    return bytes(reinterpret_cast<const int8_t*>(s.data()), s.size());
+}
+
+struct validate_test {
+    const bytes ascii_short = make_ascii_string(32);
+    const bytes ascii_long = make_ascii_string(64*1024);
+    const bytes utf8_short = make_utf8_string(32);
+    const bytes utf8_long = make_utf8_string(64*1024);
+};
+
+PERF_TEST_F(validate_test, perf_utf8_validate_ascii_short) {
+    perf_tests::do_not_optimize(utils::utf8::validate(ascii_short));
+}
+
+PERF_TEST_F(validate_test, perf_utf8_validate_ascii_long) {
+    perf_tests::do_not_optimize(utils::utf8::validate(ascii_long));
+}
+
+PERF_TEST_F(validate_test, perf_utf8_validate_short) {
+    perf_tests::do_not_optimize(utils::utf8::validate(utf8_short));
+}
+
+PERF_TEST_F(validate_test, perf_utf8_validate_long) {
+    perf_tests::do_not_optimize(utils::utf8::validate(utf8_long));
+}
+
+PERF_TEST_F(validate_test, perf_ascii_validate_short) {
+    perf_tests::do_not_optimize(utils::ascii::validate(ascii_short));
+}
+
+PERF_TEST_F(validate_test, perf_ascii_validate_long) {
+    perf_tests::do_not_optimize(utils::ascii::validate(ascii_long));
+}
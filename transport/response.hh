@@ -66,10 +66,25 @@ class response {
         }
     }
 
+    // A response with a body serialized for another request, see cql3::result_cache.
+    response(int16_t stream, cql_binary_opcode opcode, bytes_ostream body)
+        : _stream{stream}
+        , _opcode{opcode}
+        , _body(std::move(body))
+    { }
+
     void set_frame_flag(cql_frame_flags flag) noexcept {
         _flags |= flag;
     }
 
+    uint8_t frame_flags() const noexcept {
+        return _flags;
+    }
+
+    const bytes_ostream& body() const noexcept {
+        return _body;
+    }
+
     void serialize(const event::schema_change& event, uint8_t version);
     void write_byte(uint8_t b);
     void write_int(int32_t n);
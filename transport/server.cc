@@ -891,25 +891,12 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_pr
 }
 
 static future<std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>>
-process_execute_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
+execute_prepared_request(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
         uint16_t stream, cql_protocol_version_type version, cql_serialization_format serialization_format,
         const ::timeout_config& timeout_config, service_permit permit,
-        tracing::trace_state_ptr trace_state, bool init_trace) {
-    cql3::prepared_cache_key_type cache_key(in.read_short_bytes());
+        tracing::trace_state_ptr trace_state, bool init_trace, cql3::prepared_cache_key_type cache_key,
+        cql3::statements::prepared_statement::checked_weak_ptr prepared, bool needs_authorization) {
     auto& id = cql3::prepared_cache_key_type::cql_id(cache_key);
-    bool needs_authorization = false;
-
-    // First, try to lookup in the cache of already authorized statements. If the corresponding entry is not found there
-    // look for the prepared statement and then authorize it.
-    auto prepared = qp.local().get_prepared(client_state.user(), cache_key);
-    if (!prepared) {
-        needs_authorization = true;
-        prepared = qp.local().get_prepared(cache_key);
-    }
-
-    if (!prepared) {
-        throw exceptions::prepared_query_not_found_exception(id);
-    }
 
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
     auto& query_state = q_state->query_state;
@@ -952,28 +939,78 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
         tracing::add_prepared_query_options(trace_state, options);
     }
 
+    // Traced requests are always executed, and so are ones which still have to be authorized.
+    std::optional<cql3::result_cache::source> cache_source;
+    bytes result_key;
+    if (!trace_state && !needs_authorization) {
+        auto& result_cache = qp.local().get_result_cache();
+        cache_source = result_cache.cacheable(*stmt, options);
+        if (cache_source) {
+            result_key = cql3::result_cache::make_key(version, id, options);
+            if (auto result = result_cache.find(result_key)) {
+                return make_ready_future<std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>>(
+                        make_foreign(std::make_unique<cql_server::response>(stream, cql_binary_opcode::RESULT, *result)));
+            }
+        }
+    }
+
     tracing::trace(trace_state, "Processing a statement");
     return qp.local().execute_prepared(std::move(prepared), std::move(cache_key), query_state, options, needs_authorization)
-            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version] (auto msg) {
+            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version,
+                    &qp, cache_source = std::move(cache_source), result_key = std::move(result_key)] (auto msg) mutable {
         if (msg->move_to_shard()) {
             return std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>(*msg->move_to_shard());
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            auto response = make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata);
+            // Responses carrying warnings are not cached, they would be served without them.
+            if (cache_source && !response->frame_flags()) {
+                qp.local().get_result_cache().insert(std::move(result_key), *cache_source, response->body());
+            }
+            return std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>(make_foreign(std::move(response)));
         }
     });
 }
 
+static future<std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>>
+process_execute_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
+        uint16_t stream, cql_protocol_version_type version, cql_serialization_format serialization_format,
+        const ::timeout_config& timeout_config, service_permit permit,
+        tracing::trace_state_ptr trace_state, bool init_trace) {
+    cql3::prepared_cache_key_type cache_key(in.read_short_bytes());
+    bool needs_authorization = false;
+
+    // First, try to lookup in the cache of already authorized statements. If the corresponding entry is not found there
+    // look for the prepared statement and then authorize it.
+    auto prepared = qp.local().get_prepared(client_state.user(), cache_key);
+    if (!prepared) {
+        needs_authorization = true;
+        prepared = qp.local().get_prepared(cache_key);
+    }
+
+    if (!prepared) {
+        return qp.local().recover_prepared(cache_key, client_state).then([&client_state, &qp, in, stream, version, serialization_format,
+                &timeout_config, permit = std::move(permit), trace_state = std::move(trace_state), init_trace,
+                cache_key] (cql3::statements::prepared_statement::checked_weak_ptr prepared) mutable {
+            return execute_prepared_request(client_state, qp, in, stream, version, serialization_format, timeout_config,
+                    std::move(permit), std::move(trace_state), init_trace, std::move(cache_key), std::move(prepared), true);
+        });
+    }
+    return execute_prepared_request(client_state, qp, in, stream, version, serialization_format, timeout_config,
+            std::move(permit), std::move(trace_state), init_trace, std::move(cache_key), std::move(prepared), needs_authorization);
+}
+
 future<foreign_ptr<std::unique_ptr<cql_server::response>>> cql_server::connection::process_execute(uint16_t stream, request_reader in,
         service::client_state& client_state, service_permit permit, tracing::trace_state_ptr trace_state) {
     return process(stream, in, client_state, std::move(permit), std::move(trace_state), process_execute_internal);
 }
 
 static future<std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>>
-process_batch_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
+process_batch_request(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
         uint16_t stream, cql_protocol_version_type version, cql_serialization_format serialization_format,
         const ::timeout_config& timeout_config, service_permit permit,
-        tracing::trace_state_ptr trace_state, bool init_trace) {
+        tracing::trace_state_ptr trace_state, bool init_trace, unsigned recoveries) {
+    const request_reader request = in;
     if (version == 1) {
         throw exceptions::protocol_exception("BATCH messages are not support in version 1 of the protocol");
     }
@@ -985,28 +1022,26 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
     std::vector<std::vector<cql3::raw_value_view>> values;
     std::unordered_map<cql3::prepared_cache_key_type, cql3::authorized_prepared_statements_cache::value_type> pending_authorization_entries;
 
+    // Statements are traced once all of them are found, since a missing one
+    // restarts the request.
+    std::vector<std::unique_ptr<cql3::statements::prepared_statement>> unprepared;
+    std::vector<std::pair<sstring_view, cql3::statements::prepared_statement::checked_weak_ptr>> traced;
+
     modifications.reserve(n);
     values.reserve(n);
 
-    if (init_trace) {
-        tracing::begin(trace_state, "Execute batch of CQL3 queries", client_state.get_client_address());
-    }
-
     for ([[gnu::unused]] auto i : boost::irange(0u, n)) {
         const auto kind = in.read_byte();
 
-        std::unique_ptr<cql3::statements::prepared_statement> stmt_ptr;
         cql3::statements::prepared_statement::checked_weak_ptr ps;
+        sstring_view query;
         bool needs_authorization(kind == 0);
 
         switch (kind) {
         case 0: {
-            auto query = in.read_long_string_view();
-            stmt_ptr = qp.local().get_statement(query, client_state);
-            ps = stmt_ptr->checked_weak_from_this();
-            if (init_trace) {
-                tracing::add_query(trace_state, query);
-            }
+            query = in.read_long_string_view();
+            unprepared.push_back(qp.local().get_statement(query, client_state));
+            ps = unprepared.back()->checked_weak_from_this();
             break;
         }
         case 1: {
@@ -1019,14 +1054,22 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
             if (!ps) {
                 ps = qp.local().get_prepared(cache_key);
                 if (!ps) {
-                    throw exceptions::prepared_query_not_found_exception(id);
+                    // Each recovery prepares one missing statement, so more of them
+                    // than statements means they are evicted as soon as prepared.
+                    if (recoveries >= n) {
+                        throw exceptions::prepared_query_not_found_exception(id);
+                    }
+                    return qp.local().recover_prepared(cache_key, client_state).then([&client_state, &qp, request, stream, version,
+                            serialization_format, &timeout_config, permit = std::move(permit), trace_state = std::move(trace_state),
+                            init_trace, recoveries] (auto&&) mutable {
+                        return process_batch_request(client_state, qp, request, stream, version, serialization_format, timeout_config,
+                                std::move(permit), std::move(trace_state), init_trace, recoveries + 1);
+                    });
                 }
                 // authorize a particular prepared statement only once
                 needs_authorization = pending_authorization_entries.emplace(std::move(cache_key), ps->checked_weak_from_this()).second;
             }
-            if (init_trace) {
-                tracing::add_query(trace_state, ps->statement->raw_cql_statement);
-            }
+            query = ps->statement->raw_cql_statement;
             break;
         }
         default:
@@ -1040,11 +1083,6 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
         }
 
         ::shared_ptr<cql3::statements::modification_statement> modif_statement_ptr = static_pointer_cast<cql3::statements::modification_statement>(ps->statement);
-        if (init_trace) {
-            tracing::add_table_name(trace_state, modif_statement_ptr->keyspace(), modif_statement_ptr->column_family());
-            tracing::add_prepared_statement(trace_state, ps);
-        }
-
         modifications.emplace_back(std::move(modif_statement_ptr), needs_authorization);
 
         std::vector<cql3::raw_value_view> tmp;
@@ -1056,6 +1094,17 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
                             stmt->get_bound_terms(), tmp.size()));
         }
         values.emplace_back(std::move(tmp));
+        traced.emplace_back(query, std::move(ps));
+    }
+
+    if (init_trace) {
+        tracing::begin(trace_state, "Execute batch of CQL3 queries", client_state.get_client_address());
+        for (auto& [query, ps] : traced) {
+            auto& modif_statement = static_cast<const cql3::statements::modification_statement&>(*ps->statement);
+            tracing::add_query(trace_state, query);
+            tracing::add_table_name(trace_state, modif_statement.keyspace(), modif_statement.column_family());
+            tracing::add_prepared_statement(trace_state, ps);
+        }
     }
 
     auto q_state = std::make_unique<cql_query_state>(client_state, trace_state, std::move(permit));
@@ -1084,6 +1133,15 @@ process_batch_internal(service::client_state& client_state, distributed<cql3::qu
     });
 }
 
+static future<std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>>
+process_batch_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
+        uint16_t stream, cql_protocol_version_type version, cql_serialization_format serialization_format,
+        const ::timeout_config& timeout_config, service_permit permit,
+        tracing::trace_state_ptr trace_state, bool init_trace) {
+    return process_batch_request(client_state, qp, in, stream, version, serialization_format, timeout_config,
+            std::move(permit), std::move(trace_state), init_trace, 0);
+}
+
 future<foreign_ptr<std::unique_ptr<cql_server::response>>>
 cql_server::connection::process_batch(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit,
         tracing::trace_state_ptr trace_state) {
@@ -24,11 +24,15 @@
 #include "ascii.hh"
 #include <seastar/core/byteorder.hh>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 namespace utils {
 
 namespace ascii {
 
-bool validate(const uint8_t *data, size_t len) {
+static bool validate_scalar(const uint8_t *data, size_t len) {
     // OR all bytes
     uint8_t orall = 0;
 
@@ -59,6 +63,84 @@ bool validate(const uint8_t *data, size_t len) {
     return orall < 0x80;
 }
 
+#if defined(__x86_64__)
+
+// OR 64 bytes per iteration, the 7-th bits are collected by movemask once
+static bool validate_sse2(const uint8_t *data, size_t len) {
+    if (len >= 16) {
+        __m128i or1 = _mm_setzero_si128(), or2 = _mm_setzero_si128();
+
+        while (len >= 64) {
+            or1 = _mm_or_si128(or1, _mm_loadu_si128((const __m128i *)data));
+            or2 = _mm_or_si128(or2, _mm_loadu_si128((const __m128i *)(data+16)));
+            or1 = _mm_or_si128(or1, _mm_loadu_si128((const __m128i *)(data+32)));
+            or2 = _mm_or_si128(or2, _mm_loadu_si128((const __m128i *)(data+48)));
+
+            data += 64;
+            len -= 64;
+        }
+        while (len >= 16) {
+            or1 = _mm_or_si128(or1, _mm_loadu_si128((const __m128i *)data));
+
+            data += 16;
+            len -= 16;
+        }
+
+        if (_mm_movemask_epi8(_mm_or_si128(or1, or2))) {
+            return false;
+        }
+    }
+
+    return validate_scalar(data, len);
+}
+
+__attribute__((target("avx2")))
+static bool validate_avx2(const uint8_t *data, size_t len) {
+    if (len >= 32) {
+        __m256i or1 = _mm256_setzero_si256(), or2 = _mm256_setzero_si256();
+
+        while (len >= 128) {
+            or1 = _mm256_or_si256(or1, _mm256_loadu_si256((const __m256i *)data));
+            or2 = _mm256_or_si256(or2, _mm256_loadu_si256((const __m256i *)(data+32)));
+            or1 = _mm256_or_si256(or1, _mm256_loadu_si256((const __m256i *)(data+64)));
+            or2 = _mm256_or_si256(or2, _mm256_loadu_si256((const __m256i *)(data+96)));
+
+            data += 128;
+            len -= 128;
+        }
+        while (len >= 32) {
+            or1 = _mm256_or_si256(or1, _mm256_loadu_si256((const __m256i *)data));
+
+            data += 32;
+            len -= 32;
+        }
+
+        if (_mm256_movemask_epi8(_mm256_or_si256(or1, or2))) {
+            return false;
+        }
+    }
+
+    return validate_sse2(data, len);
+}
+
+static bool (*const validate_impl)(const uint8_t *data, size_t len) = [] {
+    // May run before the constructor initializing the cpu model.
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? validate_avx2 : validate_sse2;
+}();
+
+bool validate(const uint8_t *data, size_t len) {
+    return validate_impl(data, len);
+}
+
+#else
+
+bool validate(const uint8_t *data, size_t len) {
+    return validate_scalar(data, len);
+}
+
+#endif
+
 } // namespace ascii
 
 } // namespace utils
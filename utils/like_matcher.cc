@@ -23,98 +23,213 @@
 
 #include "like_matcher.hh"
 
-#include <boost/regex/icu.hpp>
-#include <boost/locale/encoding.hpp>
-#include <string>
+#include <cstring>
+#include <optional>
+#include <vector>
 
-namespace {
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#endif
 
-using std::wstring;
+namespace {
 
-/// Processes a new pattern character, extending re with the equivalent regex pattern.
-void process_char(wchar_t c, wstring& re, bool& escaping) {
-    if (c == L'\\' && !escaping) {
-        escaping = true;
-        return;
-    }
-    switch (c) {
-    case L'.':
-    case L'[':
-    case L'\\':
-    case L'*':
-    case L'^':
-    case L'$':
-        // These are meant to match verbatim in LIKE, but they'd be special characters in regex --
-        // must escape them.
-        re.push_back(L'\\');
-        re.push_back(c);
-        break;
-    case L'_':
-    case L'%':
-        if (escaping) {
-            re.push_back(c);
-        } else { // LIKE wildcard.
-            re.push_back(L'.');
-            if (c == L'%') {
-                re.push_back(L'*');
-            }
-        }
-        break;
-    default:
-        re.push_back(c);
-        break;
+/// Returns the length of the UTF-8 character starting with byte c.
+size_t char_length(int8_t c) {
+    const auto b = uint8_t(c);
+    if (b < 0xC0) {
+        return 1; // ASCII, or a stray continuation byte.
+    } else if (b < 0xE0) {
+        return 2;
+    } else if (b < 0xF0) {
+        return 3;
     }
-    escaping = false;
+    return 4;
 }
 
-/// Returns a regex string matching the given LIKE pattern.
-wstring regex_from_pattern(bytes_view pattern) {
-    if (pattern.empty()) {
-        return L"^$"; // Like SQL, empty pattern matches only empty text.
+/// Returns the position of the first occurrence of needle in text, or bytes_view::npos.
+///
+/// On x86-64, 16 candidate positions are tested at a time by comparing their first and last
+/// bytes with needle's; only the positions where both match are compared in full.
+size_t find(bytes_view text, bytes_view needle) {
+    const size_t k = needle.size();
+    if (k == 0) {
+        return 0;
     }
-    using namespace boost::locale::conv;
-    wstring wpattern = utf_to_utf<wchar_t>(pattern.begin(), pattern.end(), stop);
-    if (wpattern.back() == L'\\') {
-        // Add an extra backslash, in case that last character is unescaped.  (If it is escaped, the
-        // extra backslash will be ignored.)
-        wpattern += L'\\';
+    if (text.size() < k) {
+        return bytes_view::npos;
     }
-    wstring re;
-    re.reserve(wpattern.size() * 2); // Worst case: every element is a special character and must be escaped.
-    bool escaping = false;
-    for (const wchar_t c : wpattern) {
-        process_char(c, re, escaping);
+    if (k == 1) {
+        auto p = static_cast<const int8_t*>(memchr(text.data(), needle[0], text.size()));
+        return p ? p - text.data() : bytes_view::npos;
     }
-    return re;
+    const size_t candidates = text.size() - k + 1;
+    size_t i = 0;
+#if defined(__x86_64__)
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[k - 1]);
+    for (; i + 16 <= candidates; i += 16) {
+        const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+        const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i + k - 1));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+        while (mask) {
+            const auto pos = i + __builtin_ctz(mask);
+            if (!memcmp(text.data() + pos + 1, needle.data() + 1, k - 2)) {
+                return pos;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < candidates; ++i) {
+        if (text[i] == needle[0] && !memcmp(text.data() + i + 1, needle.data() + 1, k - 1)) {
+            return i;
+        }
+    }
+    return bytes_view::npos;
 }
 
 } // anonymous namespace
 
 class like_matcher::impl {
+    /// Element of a compiled pattern: a byte to match verbatim, or one of the wildcards.
+    using element = int16_t;
+    static constexpr element any_char = 256; ///< Unescaped '_'.
+    static constexpr element any_string = 257; ///< Unescaped '%'; consecutive ones are merged.
+
+    /// Patterns with no '_' and at most two '%' at their ends are matched by plain
+    /// comparison or substring search.
+    enum class kind { literal, prefix, suffix, substring, general };
+
     bytes _pattern;
-    boost::u32regex _re; // Performs pattern matching.
+    kind _kind;
+    bytes _literal; ///< The pattern without its wildcards, for the non-general kinds.
+    std::vector<element> _program; ///< The compiled pattern, for the general kind.
   public:
     explicit impl(bytes_view pattern);
     bool operator()(bytes_view text) const;
     void reset(bytes_view pattern);
   private:
-    void init_re() {
-        _re = boost::make_u32regex(regex_from_pattern(_pattern), boost::u32regex::basic | boost::u32regex::optimize);
-    }
+    void compile();
+    bool match_general(bytes_view text) const;
 };
 
 like_matcher::impl::impl(bytes_view pattern) : _pattern(pattern) {
-    init_re();
+    compile();
+}
+
+void like_matcher::impl::compile() {
+    _program.clear();
+    _program.reserve(_pattern.size());
+    size_t wildcards = 0;
+    bool has_any_char = false;
+    for (size_t i = 0; i < _pattern.size(); ++i) {
+        const auto c = _pattern[i];
+        if (c == '\\' && i + 1 < _pattern.size()) {
+            // Escapes the next character. A backslash at the end matches itself.
+            _program.push_back(uint8_t(_pattern[++i]));
+        } else if (c == '_') {
+            _program.push_back(any_char);
+            has_any_char = true;
+            ++wildcards;
+        } else if (c == '%') {
+            if (_program.empty() || _program.back() != any_string) {
+                _program.push_back(any_string);
+                ++wildcards;
+            }
+        } else {
+            _program.push_back(uint8_t(c));
+        }
+    }
+
+    const bool starts_with_any = !_program.empty() && _program.front() == any_string;
+    const bool ends_with_any = !_program.empty() && _program.back() == any_string;
+    if (has_any_char || wildcards > 2 || wildcards > size_t(starts_with_any) + size_t(ends_with_any)) {
+        _kind = kind::general;
+        _literal = bytes();
+        return;
+    }
+    if (wildcards == 2 || (starts_with_any && _program.size() == 1)) {
+        _kind = kind::substring;
+    } else if (starts_with_any) {
+        _kind = kind::suffix;
+    } else if (ends_with_any) {
+        _kind = kind::prefix;
+    } else {
+        _kind = kind::literal;
+    }
+    _literal = bytes(bytes::initialized_later(), _program.size() - wildcards);
+    auto out = _literal.begin();
+    for (auto e : _program) {
+        if (e != any_string) {
+            *out++ = int8_t(e);
+        }
+    }
+    _program.clear();
+}
+
+/// Matches text against _program, backtracking only to the last '%' seen, which is
+/// enough since a later '%' can absorb anything an earlier one could.
+bool like_matcher::impl::match_general(bytes_view text) const {
+    const size_t n = text.size();
+    size_t pi = 0;
+    size_t ti = 0;
+    std::optional<size_t> star_pi;
+    size_t star_ti = 0;
+    while (ti < n) {
+        if (pi < _program.size()) {
+            const auto e = _program[pi];
+            if (e == any_string) {
+                star_pi = pi++;
+                star_ti = ti;
+                continue;
+            } else if (e == any_char) {
+                const auto len = char_length(text[ti]);
+                if (ti + len <= n) {
+                    ti += len;
+                    ++pi;
+                    continue;
+                }
+            } else if (e == uint8_t(text[ti])) {
+                ++ti;
+                ++pi;
+                continue;
+            }
+        }
+        if (!star_pi) {
+            return false;
+        }
+        // Let the last '%' absorb one more character and retry the rest of the pattern.
+        star_ti += char_length(text[star_ti]);
+        pi = *star_pi + 1;
+        ti = star_ti;
+    }
+    while (pi < _program.size() && _program[pi] == any_string) {
+        ++pi;
+    }
+    return ti == n && pi == _program.size();
 }
 
 bool like_matcher::impl::operator()(bytes_view text) const {
-    return boost::u32regex_match(text.begin(), text.end(), _re);
+    switch (_kind) {
+    case kind::literal:
+        return text == bytes_view(_literal);
+    case kind::prefix:
+        return text.size() >= _literal.size() && !memcmp(text.data(), _literal.data(), _literal.size());
+    case kind::suffix:
+        return text.size() >= _literal.size()
+                && !memcmp(text.data() + text.size() - _literal.size(), _literal.data(), _literal.size());
+    case kind::substring:
+        return find(text, _literal) != bytes_view::npos;
+    case kind::general:
+        return match_general(text);
+    }
+    abort();
 }
 
 void like_matcher::impl::reset(bytes_view pattern) {
     if (pattern != _pattern) {
         _pattern = bytes(pattern);
-        init_re();
+        compile();
     }
 }
 
@@ -133,3 +248,20 @@ bool like_matcher::operator()(bytes_view text) const {
 void like_matcher::reset(bytes_view pattern) {
     return _impl->reset(pattern);
 }
+
+bytes like_matcher::literal_prefix(bytes_view pattern) {
+    bytes prefix(bytes::initialized_later(), pattern.size());
+    size_t len = 0;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        const auto c = pattern[i];
+        if (c == '_' || c == '%') {
+            break;
+        }
+        if (c == '\\' && i + 1 < pattern.size()) {
+            ++i;
+        }
+        prefix[len++] = pattern[i];
+    }
+    prefix.resize(len);
+    return prefix;
+}
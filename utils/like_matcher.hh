@@ -54,4 +54,9 @@ class like_matcher {
 
     /// Resets pattern if different from the current one.
     void reset(bytes_view pattern);
+
+    /// Returns the part of \c pattern before its first wildcard, unescaped.
+    ///
+    /// Every text matching \c pattern starts with it.
+    static bytes literal_prefix(bytes_view pattern);
 };
@@ -26,10 +26,13 @@
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Warray-bounds"
+// Exposes XXH3_state_t, so that xx3_hasher can keep it inline.
+#define XXH_STATIC_LINKING_ONLY
 #include <xxhash.h>
 #pragma GCC diagnostic pop
 
 #include <array>
+#include <cstring>
 
 class xx_hasher {
     static constexpr size_t digest_size = 16;
@@ -67,3 +70,63 @@ class xx_hasher {
         serialize_int64(out, finalize_uint64());
     }
 };
+
+// 128-bit XXH3 hasher.
+//
+// Digests are fed mostly with small values: timestamps, lengths and per-cell
+// hashes, each of which would otherwise be a separate XXH3 update call. They
+// are gathered in a small buffer and handed to XXH3 in bulk instead.
+class xx3_hasher {
+    static constexpr size_t digest_size = 16;
+    static constexpr size_t buffer_size = 256;
+    XXH3_state_t _state;
+    size_t _buffered = 0;
+    std::array<char, buffer_size> _buffer;
+
+    void flush() {
+        XXH3_128bits_update(&_state, _buffer.data(), _buffered);
+        _buffered = 0;
+    }
+public:
+    explicit xx3_hasher(uint64_t seed = 0) noexcept {
+        XXH3_128bits_reset_withSeed(&_state, seed);
+    }
+
+    void update(const char* ptr, size_t length) {
+        if (_buffered + length > buffer_size) {
+            flush();
+            if (length >= buffer_size) {
+                XXH3_128bits_update(&_state, ptr, length);
+                return;
+            }
+        }
+        std::memcpy(_buffer.data() + _buffered, ptr, length);
+        _buffered += length;
+    }
+
+    bytes finalize() {
+        bytes digest{bytes::initialized_later(), digest_size};
+        serialize_to(digest.begin());
+        return digest;
+    }
+
+    std::array<uint8_t, digest_size> finalize_array() {
+        std::array<uint8_t, digest_size> digest;
+        serialize_to(digest.begin());
+        return digest;
+    }
+
+    uint64_t finalize_uint64() {
+        flush();
+        return XXH3_128bits_digest(&_state).low64;
+    }
+
+private:
+    template<typename OutIterator>
+    void serialize_to(OutIterator&& out) {
+        flush();
+        auto h = XXH3_128bits_digest(&_state);
+        serialize_int64(out, h.high64);
+        serialize_int64(out, h.low64);
+    }
+};